@@ -147,6 +147,15 @@ public:
 		_flag = false;
 	};
 
+	/*
+	 * Create a copy of this node.
+	 *
+	 * @return A new COP_TPI_Node.
+	 */
+	virtual Connecting* clone() const {
+		return new COP_TPI_Node<_width>(this->function(), this->name());
+	}
+
 	void setflag(bool flag)
 	{
 		_flag = flag;
@@ -123,7 +123,7 @@ public:
 		std::vector<std::pair<Evented<_valueType>*, _valueType>> newFrontier;
 		for (std::pair<Evented<_valueType>*, _valueType> front : this->frontier_) {
 			Evented<_valueType>* location = front.first;
-			for (Connecting* output : location->outputs()) {
+			for (Connecting* output : location->outputSpan()) {
 				Evented<_valueType>* cast = dynamic_cast<Evented<_valueType>*>(output);
 				if (cast->value().valid() == 0x0 ) { //we have an X: it's possible.
 					std::vector<std::pair<Evented<_valueType>*, _valueType>> toAdd = this->propagatingChoices(cast);
@@ -163,7 +163,7 @@ private:
 	 */
 	std::vector<std::pair<Evented<_valueType>*, _valueType>> propagatingChoices(Connecting* _gate) {
 		std::vector<std::pair<Evented<_valueType>*, _valueType>> toReturn;
-		for (Connecting* input : _gate->inputs()) {
+		for (Connecting* input : _gate->inputSpan()) {
 			Evented<_valueType>* cast = dynamic_cast<Evented<_valueType>*>(input);
 			_valueType value = this->propagatingValue(_gate->name());
 			if (cast->value().valid() == 0x0)
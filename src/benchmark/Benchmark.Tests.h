@@ -0,0 +1,4 @@
+#pragma once
+
+#include "benchmark/Benchmark_Test.hpp"
+#include "benchmark/Regression_Test.hpp"
@@ -0,0 +1,375 @@
+/**
+ * @file Benchmark.hpp
+ * @author Spencer Millican (millican@auburn.edu)
+ * @version 0.1
+ * @date 2020-06-01
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#ifndef Benchmark_h
+#define Benchmark_h
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <cmath>
+#include <cstdio>
+#include <map>
+#include <memory>
+
+#include "timing/Timing.hpp"
+#include "timing/Counters.hpp"
+#include "timing/Trace.hpp"
+#include "timing/HardwareCounters.hpp"
+
+/*
+ * The measurements of a single operation on a single circuit.
+ */
+struct BenchmarkResult {
+	/*
+	 * The circuit measured, e.g., "c432".
+	 */
+	std::string circuit;
+
+	/*
+	 * The operation measured, e.g., "parse".
+	 */
+	std::string operation;
+
+	/*
+	 * What one "item" processed by the operation is, e.g., "vectors".
+	 */
+	std::string unit;
+
+	/*
+	 * The number of items processed per repetition.
+	 */
+	double items = 0;
+
+	/*
+	 * The number of (untimed) warm-up runs.
+	 */
+	size_t warmup = 0;
+
+	/*
+	 * The time of each (timed) repetition, in seconds.
+	 */
+	std::vector<double> seconds;
+
+	/*
+	 * The hot-path counts (see Counters) of a single (timed) repetition, on
+	 * average. Empty unless counters are compiled in.
+	 */
+	std::map<std::string, double> counters;
+
+	/*
+	 * The hardware counts (see HardwareCounters) of a single (timed)
+	 * repetition, on average, and metrics derived from them: "ipc"
+	 * (instructions per cycle) and, if gate evaluations are counted, misses
+	 * per gate evaluation (e.g., "l1d_misses_per_gate_evaluation"). Empty
+	 * unless hardware counters are measured and available.
+	 */
+	std::map<std::string, double> hardware;
+
+	/*
+	 * The median time of all repetitions, in seconds.
+	 */
+	double median() const;
+
+	/*
+	 * The 95th percentile time of all repetitions, in seconds.
+	 */
+	double p95() const;
+
+	/*
+	 * The number of items processed per second (at the median time).
+	 */
+	double rate() const;
+};
+
+/*
+ * Measures operations: each is run (untimed) a number of warm-up times and then
+ * timed a number of repetitions.
+ *
+ * All results are kept and can be written as JSON (see "json").
+ */
+class Benchmark {
+public:
+	/*
+	 * Create a benchmark.
+	 *
+	 * @param (optional) _warmup The number of untimed runs of each operation.
+	 * @param (optional) _repetitions The number of timed runs of each operation.
+	 */
+	Benchmark(size_t _warmup = 1, size_t _repetitions = 5) {
+		this->warmup_ = _warmup;
+		this->repetitions_ = _repetitions == 0 ? 1 : _repetitions;
+	}
+
+	/*
+	 * Measure hardware counters (see HardwareCounters) around every timed run
+	 * (of operations measured from now on, on the calling thread).
+	 *
+	 * @param _measure True to measure hardware counters.
+	 * @return True if at least one hardware counter is available (if not, see
+	 *         "hardwareError").
+	 */
+	bool hardware(bool _measure) {
+		this->hardware_.reset();
+		this->hardwareError_.clear();
+		if (_measure == true) {
+			this->hardware_.reset(new HardwareCounters());
+			if (this->hardware_->available() == false) {
+				this->hardwareError_ = this->hardware_->error();
+				this->hardware_.reset();
+			}
+		}
+		return this->hardware_ != nullptr;
+	}
+
+	/*
+	 * Why hardware counters are unavailable ("" if they are, or were not asked
+	 * for).
+	 *
+	 * @return The reason hardware counters are unavailable.
+	 */
+	std::string hardwareError() const {
+		return this->hardwareError_;
+	}
+
+	/*
+	 * Measure an operation.
+	 *
+	 * The setup function is called (untimed) before every run, e.g., to
+	 * create the objects the operation consumes. The operation returns the
+	 * number of items it processed (which should be the same every run).
+	 *
+	 * @param _circuit The name of the circuit.
+	 * @param _operation The name of the operation.
+	 * @param _unit What one item processed by the operation is.
+	 * @param _setup The (untimed) setup before every run.
+	 * @param _run The (timed) operation.
+	 * @return The measurements (also kept, see "results").
+	 */
+	BenchmarkResult run(
+		std::string _circuit,
+		std::string _operation,
+		std::string _unit,
+		std::function<void()> _setup,
+		std::function<double()> _run
+	) {
+		BenchmarkResult result;
+		result.circuit = _circuit;
+		result.operation = _operation;
+		result.unit = _unit;
+		result.warmup = this->warmup_;
+		for (size_t i = 0; i < this->warmup_; i++) {
+			_setup();
+			_run();
+		}
+		Counters counted;
+		std::map<std::string, double> hardware;
+		for (size_t i = 0; i < this->repetitions_; i++) {
+			_setup();
+			Counters before = Counters::total();
+			if (this->hardware_ != nullptr) {
+				this->hardware_->start();
+			}
+			ScopedTimer timer(_operation);
+			result.items = _run();
+			result.seconds.push_back(timer.stop());
+			if (this->hardware_ != nullptr) {
+				for (const std::pair<const std::string, double> & count : this->hardware_->stop()) {
+					hardware[count.first] += count.second;
+				}
+			}
+			Counters after = Counters::total();
+			for (size_t j = 0; j < Counters::NUM_COUNTERS; j++) {
+				counted.add((Counters::Counter)j, after.count((Counters::Counter)j) - before.count((Counters::Counter)j));
+			}
+		}
+		if (Counters::enabled()) {
+			for (const std::pair<const std::string, unsigned long long int> & count : counted.counts()) {
+				result.counters[count.first] = (double)count.second / (double)this->repetitions_;
+			}
+		}
+		for (const std::pair<const std::string, double> & count : hardware) {
+			result.hardware[count.first] = count.second / (double)this->repetitions_;
+		}
+		Benchmark::derive(result);
+		this->results_.push_back(result);
+		return result;
+	}
+
+	/*
+	 * Measure an operation which needs no setup.
+	 *
+	 * @param _circuit The name of the circuit.
+	 * @param _operation The name of the operation.
+	 * @param _unit What one item processed by the operation is.
+	 * @param _run The (timed) operation.
+	 * @return The measurements (also kept, see "results").
+	 */
+	BenchmarkResult run(
+		std::string _circuit,
+		std::string _operation,
+		std::string _unit,
+		std::function<double()> _run
+	) {
+		return this->run(_circuit, _operation, _unit, []() {}, _run);
+	}
+
+	/*
+	 * All measurements (in the order they were taken).
+	 *
+	 * @return All measurements.
+	 */
+	const std::vector<BenchmarkResult> & results() const {
+		return this->results_;
+	}
+
+	/*
+	 * Write all measurements as JSON.
+	 *
+	 * Format: {"warmup": W, "repetitions": R, "benchmarks": [{"circuit": ...,
+	 * "operation": ..., "unit": ..., "items": ..., "seconds": [...],
+	 * "median": ..., "p95": ..., "rate": ...[, "counters": {...}][, "hardware":
+	 * {...}]}, ...]}
+	 *
+	 * @param _output The file to write to.
+	 */
+	void json(FILE* _output) const {
+		fprintf(_output, "{\n  \"warmup\": %zu,\n  \"repetitions\": %zu,\n  \"benchmarks\": [", this->warmup_, this->repetitions_);
+		for (size_t i = 0; i < this->results_.size(); i++) {
+			const BenchmarkResult & result = this->results_.at(i);
+			fprintf(_output, "%s\n    {\"circuit\": %s, \"operation\": %s, \"unit\": %s, \"items\": %.17g, \"seconds\": [",
+				i == 0 ? "" : ",",
+				Benchmark::quote(result.circuit).c_str(),
+				Benchmark::quote(result.operation).c_str(),
+				Benchmark::quote(result.unit).c_str(),
+				result.items
+			);
+			for (size_t j = 0; j < result.seconds.size(); j++) {
+				fprintf(_output, "%s%.9g", j == 0 ? "" : ", ", result.seconds.at(j));
+			}
+			fprintf(_output, "], \"median\": %.9g, \"p95\": %.9g, \"rate\": %.9g", result.median(), result.p95(), result.rate());
+			if (result.counters.empty() == false) {
+				fprintf(_output, ", \"counters\": {");
+				bool first = true;
+				for (const std::pair<const std::string, double> & counter : result.counters) {
+					fprintf(_output, "%s%s: %.17g", first ? "" : ", ", Benchmark::quote(counter.first).c_str(), counter.second);
+					first = false;
+				}
+				fprintf(_output, "}");
+			}
+			if (result.hardware.empty() == false) {
+				fprintf(_output, ", \"hardware\": {");
+				bool first = true;
+				for (const std::pair<const std::string, double> & count : result.hardware) {
+					fprintf(_output, "%s%s: %.17g", first ? "" : ", ", Benchmark::quote(count.first).c_str(), count.second);
+					first = false;
+				}
+				fprintf(_output, "}");
+			}
+			fprintf(_output, "}");
+		}
+		fprintf(_output, "\n  ]\n}\n");
+	}
+
+	/*
+	 * Return a percentile of given samples (linearly interpolated between the
+	 * two closest samples).
+	 *
+	 * @param _samples The samples (in any order).
+	 * @param _fraction The percentile as a fraction, e.g., 0.95 for the 95th.
+	 * @return The percentile (0 if there are no samples).
+	 */
+	static double percentile(std::vector<double> _samples, double _fraction) {
+		if (_samples.empty()) {
+			return 0.0;
+		}
+		std::sort(_samples.begin(), _samples.end());
+		double position = _fraction * (double)(_samples.size() - 1);
+		size_t below = (size_t)std::floor(position);
+		size_t above = (size_t)std::ceil(position);
+		double weight = position - (double)below;
+		return _samples.at(below) * (1.0 - weight) + _samples.at(above) * weight;
+	}
+
+	/*
+	 * Return a string as a (quoted and escaped) JSON string.
+	 *
+	 * @param _string The string to quote.
+	 * @return The JSON string.
+	 */
+	static std::string quote(std::string _string) {
+		return TraceLog::quote(_string);
+	}
+
+	/*
+	 * Add metrics derived from the hardware counts of a result: IPC and misses
+	 * per gate evaluation (only for counts which are available).
+	 *
+	 * @param _result The result to add metrics to.
+	 */
+	static void derive(BenchmarkResult & _result) {
+		std::map<std::string, double> & hardware = _result.hardware;
+		if (hardware.count("cycles") != 0 && hardware.count("instructions") != 0 && hardware.at("cycles") > 0.0) {
+			hardware["ipc"] = hardware.at("instructions") / hardware.at("cycles");
+		}
+		auto evaluations = _result.counters.find(Counters::name(Counters::GATE_EVALUATIONS));
+		if (evaluations == _result.counters.end() || evaluations->second <= 0.0) {
+			return;
+		}
+		for (HardwareCounters::Event miss : { HardwareCounters::L1D_MISSES, HardwareCounters::LLC_MISSES, HardwareCounters::BRANCH_MISSES }) {
+			std::string name = HardwareCounters::name(miss);
+			if (hardware.count(name) != 0) {
+				hardware[name + "_per_gate_evaluation"] = hardware.at(name) / evaluations->second;
+			}
+		}
+	}
+
+private:
+	/*
+	 * The number of untimed runs of each operation.
+	 */
+	size_t warmup_;
+
+	/*
+	 * The number of timed runs of each operation.
+	 */
+	size_t repetitions_;
+
+	/*
+	 * All measurements.
+	 */
+	std::vector<BenchmarkResult> results_;
+
+	/*
+	 * The hardware counters (if measured and available).
+	 */
+	std::unique_ptr<HardwareCounters> hardware_;
+
+	/*
+	 * Why hardware counters are unavailable.
+	 */
+	std::string hardwareError_;
+};
+
+inline double BenchmarkResult::median() const {
+	return Benchmark::percentile(this->seconds, 0.5);
+}
+
+inline double BenchmarkResult::p95() const {
+	return Benchmark::percentile(this->seconds, 0.95);
+}
+
+inline double BenchmarkResult::rate() const {
+	double median = this->median();
+	return median > 0.0 ? this->items / median : 0.0;
+}
+
+#endif
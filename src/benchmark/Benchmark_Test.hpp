@@ -0,0 +1,66 @@
+#include "gtest/gtest.h"
+#include "benchmark/Benchmark.hpp"
+
+class BenchmarkTest : public ::testing::Test {
+public:
+	void SetUp() override {
+
+	}
+
+	Benchmark benchmark = Benchmark(2, 3);
+};
+
+TEST_F(BenchmarkTest, PercentileTest) {
+	std::vector<double> samples = { 5.0, 1.0, 4.0, 2.0, 3.0 };
+	EXPECT_DOUBLE_EQ(3.0, Benchmark::percentile(samples, 0.5));
+	EXPECT_DOUBLE_EQ(1.0, Benchmark::percentile(samples, 0.0));
+	EXPECT_DOUBLE_EQ(5.0, Benchmark::percentile(samples, 1.0));
+	EXPECT_DOUBLE_EQ(4.8, Benchmark::percentile(samples, 0.95));
+	EXPECT_DOUBLE_EQ(2.5, Benchmark::percentile({ 2.0, 3.0 }, 0.5));
+	EXPECT_DOUBLE_EQ(0.0, Benchmark::percentile({}, 0.5));
+}
+
+TEST_F(BenchmarkTest, RunTest) {
+	size_t setups = 0;
+	size_t runs = 0;
+	BenchmarkResult result = benchmark.run("c17", "count", "items",
+		[&]() { setups++; },
+		[&]() { runs++; return 10.0; }
+	);
+	EXPECT_EQ(5, setups); //2 warm-up, 3 timed.
+	EXPECT_EQ(5, runs);
+	EXPECT_EQ(3, result.seconds.size());
+	EXPECT_EQ(10.0, result.items);
+	EXPECT_LE(result.median(), result.p95());
+	EXPECT_EQ(1, benchmark.results().size());
+}
+
+TEST_F(BenchmarkTest, QuoteTest) {
+	EXPECT_EQ("\"c17\"", Benchmark::quote("c17"));
+	EXPECT_EQ("\"ISCAS'85 \\\"a\\\\b\\\"\"", Benchmark::quote("ISCAS'85 \"a\\b\""));
+	EXPECT_EQ("\"\\n\\u0001\"", Benchmark::quote("\n\x01"));
+}
+
+TEST_F(BenchmarkTest, HardwareTest) {
+	bool available = benchmark.hardware(true);
+	EXPECT_EQ(available, benchmark.hardwareError().empty());
+	BenchmarkResult result = benchmark.run("c17", "count", "items", []() { return 1.0; });
+	EXPECT_EQ(available, result.hardware.empty() == false);
+	benchmark.hardware(false);
+	EXPECT_TRUE(benchmark.hardwareError().empty());
+	EXPECT_TRUE(benchmark.run("c17", "count", "items", []() { return 1.0; }).hardware.empty());
+}
+
+TEST_F(BenchmarkTest, DeriveTest) {
+	BenchmarkResult result;
+	result.hardware["cycles"] = 200.0;
+	result.hardware["instructions"] = 300.0;
+	result.hardware["l1d_misses"] = 50.0;
+	Benchmark::derive(result);
+	EXPECT_DOUBLE_EQ(1.5, result.hardware.at("ipc"));
+	EXPECT_EQ(0, result.hardware.count("l1d_misses_per_gate_evaluation")); //Gate evaluations are not counted.
+	result.counters["gate_evaluations"] = 25.0;
+	Benchmark::derive(result);
+	EXPECT_DOUBLE_EQ(2.0, result.hardware.at("l1d_misses_per_gate_evaluation"));
+	EXPECT_EQ(0, result.hardware.count("llc_misses_per_gate_evaluation"));
+}
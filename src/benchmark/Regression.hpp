@@ -0,0 +1,423 @@
+/**
+ * @file Regression.hpp
+ * @author Spencer Millican (millican@auburn.edu)
+ * @version 0.1
+ * @date 2020-06-01
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#ifndef Regression_h
+#define Regression_h
+
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cctype>
+#include <fstream>
+#include <sstream>
+
+#include "benchmark/Benchmark.hpp"
+
+/*
+ * A significant slowdown of an operation (on a circuit) relative to a baseline.
+ */
+struct Slowdown {
+	/*
+	 * The circuit, e.g., "c432".
+	 */
+	std::string circuit;
+
+	/*
+	 * The operation (phase), e.g., "fault simulate".
+	 */
+	std::string operation;
+
+	/*
+	 * The median time of the baseline, in seconds.
+	 */
+	double baseline = 0.0;
+
+	/*
+	 * The median time now, in seconds.
+	 */
+	double current = 0.0;
+
+	/*
+	 * The probability of a slowdown at least this large if nothing changed
+	 * (one-sided Mann-Whitney U test on all repetitions).
+	 */
+	double p = 1.0;
+
+	/*
+	 * The relative slowdown of the medians, e.g., 0.25 for 25% slower.
+	 */
+	double slowdown() const {
+		return this->baseline > 0.0 ? this->current / this->baseline - 1.0 : 0.0;
+	}
+};
+
+/*
+ * Compares benchmark results (see Benchmark) against a stored baseline.
+ *
+ * An operation has regressed if its repetitions are significantly slower than
+ * the baseline's (one-sided Mann-Whitney U test) AND its median is slower by
+ * more than a threshold. The second condition ignores changes which are
+ * "significant" but too small to matter (e.g., with many repetitions).
+ */
+class Regression {
+public:
+	/*
+	 * Read benchmark results (as written by Benchmark::json).
+	 *
+	 * Only the circuit, operation, unit, items and seconds of each result are
+	 * read.
+	 *
+	 * @param _filePath The JSON file.
+	 * @return All results in the file.
+	 */
+	static std::vector<BenchmarkResult> read(std::string _filePath) {
+		std::ifstream file(_filePath);
+		if (file.is_open() == false) {
+			throw "Failed to open benchmark baseline.";
+		}
+		std::stringstream contents;
+		contents << file.rdbuf();
+		std::string text = contents.str();
+		size_t position = 0;
+		Json document = Regression::parse(text, position);
+		Regression::skipSpace(text, position);
+		if (position != text.size()) {
+			throw "Invalid benchmark baseline: trailing characters.";
+		}
+		const Json* benchmarks = document.member("benchmarks");
+		if (benchmarks == nullptr || benchmarks->type != Json::ARRAY) {
+			throw "Invalid benchmark baseline: no benchmarks.";
+		}
+		std::vector<BenchmarkResult> toReturn;
+		for (const Json & entry : benchmarks->array) {
+			const Json* circuit = entry.member("circuit");
+			const Json* operation = entry.member("operation");
+			const Json* seconds = entry.member("seconds");
+			if (circuit == nullptr || operation == nullptr || seconds == nullptr || seconds->type != Json::ARRAY) {
+				throw "Invalid benchmark baseline: a benchmark has no circuit, operation or seconds.";
+			}
+			BenchmarkResult result;
+			result.circuit = circuit->text;
+			result.operation = operation->text;
+			const Json* unit = entry.member("unit");
+			result.unit = unit == nullptr ? "" : unit->text;
+			const Json* items = entry.member("items");
+			result.items = items == nullptr ? 0.0 : items->number;
+			for (const Json & second : seconds->array) {
+				result.seconds.push_back(second.number);
+			}
+			toReturn.push_back(result);
+		}
+		return toReturn;
+	}
+
+	/*
+	 * The one-sided Mann-Whitney U test: how likely is it that the current
+	 * samples are at least this much larger than the baseline samples if both
+	 * come from the same distribution?
+	 *
+	 * Small samples without ties use the exact distribution of U. Otherwise,
+	 * the normal approximation (with tie and continuity corrections) is used.
+	 *
+	 * @param _baseline The baseline samples.
+	 * @param _current The current samples.
+	 * @return The p-value (1 if either has no samples).
+	 */
+	static double mannWhitney(const std::vector<double> & _baseline, const std::vector<double> & _current) {
+		size_t n1 = _baseline.size();
+		size_t n2 = _current.size();
+		if (n1 == 0 || n2 == 0) {
+			return 1.0;
+		}
+
+		//U: pairs where the current sample is larger (ties count half).
+		double u = 0.0;
+		bool ties = false;
+		for (double base : _baseline) {
+			for (double cur : _current) {
+				if (cur > base) {
+					u += 1.0;
+				} else if (cur == base) {
+					u += 0.5;
+					ties = true;
+				}
+			}
+		}
+
+		if (ties == false && n1 + n2 <= 50) {
+			//counts[k]: the number of orderings of (i, j) samples with U = k.
+			std::vector<std::vector<std::vector<double>>> counts(n1 + 1, std::vector<std::vector<double>>(n2 + 1));
+			for (size_t i = 0; i <= n1; i++) {
+				for (size_t j = 0; j <= n2; j++) {
+					counts[i][j] = std::vector<double>(i * j + 1, 0.0);
+					if (i == 0 || j == 0) {
+						counts[i][j][0] = 1.0;
+						continue;
+					}
+					for (size_t k = 0; k <= i * j; k++) {
+						//The largest sample is either a current one (larger than all i baseline samples) or a baseline one.
+						double current = (k >= i) ? counts[i][j - 1][k - i] : 0.0;
+						double baseline = (k <= i * j - j) ? counts[i - 1][j][k] : 0.0;
+						counts[i][j][k] = current + baseline;
+					}
+				}
+			}
+			double total = 0.0;
+			double atLeast = 0.0;
+			for (size_t k = 0; k <= n1 * n2; k++) {
+				total += counts[n1][n2][k];
+				if ((double)k >= u) {
+					atLeast += counts[n1][n2][k];
+				}
+			}
+			return atLeast / total;
+		}
+
+		//Normal approximation with tie correction.
+		std::vector<double> all = _baseline;
+		all.insert(all.end(), _current.begin(), _current.end());
+		std::sort(all.begin(), all.end());
+		double tieSum = 0.0;
+		for (size_t i = 0; i < all.size();) {
+			size_t j = i;
+			while (j < all.size() && all.at(j) == all.at(i)) {
+				j++;
+			}
+			double tied = (double)(j - i);
+			tieSum += tied * tied * tied - tied;
+			i = j;
+		}
+		double n = (double)(n1 + n2);
+		double mean = (double)n1 * (double)n2 / 2.0;
+		double variance = (double)n1 * (double)n2 / 12.0 * ((n + 1.0) - tieSum / (n * (n - 1.0)));
+		if (variance <= 0.0) {
+			return 1.0;
+		}
+		double z = (u - mean - 0.5) / std::sqrt(variance);
+		return 0.5 * std::erfc(z / std::sqrt(2.0));
+	}
+
+	/*
+	 * Find all operations which are significantly slower than their baseline.
+	 *
+	 * Results are matched by circuit and operation. Results without a baseline
+	 * (and baselines without results) are ignored.
+	 *
+	 * @param _baseline The baseline results.
+	 * @param _current The current results.
+	 * @param (optional) _alpha The significance level.
+	 * @param (optional) _threshold The smallest relative slowdown (of the
+	 *        medians) which counts, e.g., 0.05 for 5%.
+	 * @return All significant slowdowns (in the order of the current results).
+	 */
+	static std::vector<Slowdown> compare(
+		const std::vector<BenchmarkResult> & _baseline,
+		const std::vector<BenchmarkResult> & _current,
+		double _alpha = 0.05,
+		double _threshold = 0.05
+	) {
+		std::map<std::pair<std::string, std::string>, const BenchmarkResult*> baselines;
+		for (const BenchmarkResult & result : _baseline) {
+			baselines[std::make_pair(result.circuit, result.operation)] = &result;
+		}
+		std::vector<Slowdown> toReturn;
+		for (const BenchmarkResult & result : _current) {
+			auto found = baselines.find(std::make_pair(result.circuit, result.operation));
+			if (found == baselines.end()) {
+				continue;
+			}
+			Slowdown slowdown;
+			slowdown.circuit = result.circuit;
+			slowdown.operation = result.operation;
+			slowdown.baseline = found->second->median();
+			slowdown.current = result.median();
+			slowdown.p = Regression::mannWhitney(found->second->seconds, result.seconds);
+			if (slowdown.p <= _alpha && slowdown.slowdown() > _threshold) {
+				toReturn.push_back(slowdown);
+			}
+		}
+		return toReturn;
+	}
+
+	/*
+	 * The number of results with a matching baseline (by circuit and
+	 * operation).
+	 *
+	 * @param _baseline The baseline results.
+	 * @param _current The current results.
+	 * @return The number of current results which can be compared.
+	 */
+	static size_t matched(const std::vector<BenchmarkResult> & _baseline, const std::vector<BenchmarkResult> & _current) {
+		std::set<std::pair<std::string, std::string>> baselines;
+		for (const BenchmarkResult & result : _baseline) {
+			baselines.emplace(result.circuit, result.operation);
+		}
+		size_t toReturn = 0;
+		for (const BenchmarkResult & result : _current) {
+			toReturn += baselines.count(std::make_pair(result.circuit, result.operation));
+		}
+		return toReturn;
+	}
+
+private:
+	/*
+	 * A (parsed) JSON value.
+	 */
+	struct Json {
+		enum Type { NUL, BOOLEAN, NUMBER, STRING, ARRAY, OBJECT };
+
+		Type type = NUL;
+		double number = 0.0;
+		std::string text;
+		std::vector<Json> array;
+		std::vector<std::pair<std::string, Json>> members;
+
+		//The member of an object with a given name (nullptr if none).
+		const Json* member(std::string _name) const {
+			for (const std::pair<std::string, Json> & member : this->members) {
+				if (member.first == _name) {
+					return &member.second;
+				}
+			}
+			return nullptr;
+		}
+	};
+
+	static void skipSpace(const std::string & _text, size_t & _position) {
+		while (_position < _text.size() && std::isspace((unsigned char)_text.at(_position))) {
+			_position++;
+		}
+	}
+
+	static void expect(const std::string & _text, size_t & _position, char _character) {
+		Regression::skipSpace(_text, _position);
+		if (_position >= _text.size() || _text.at(_position) != _character) {
+			throw "Invalid benchmark baseline: unexpected character.";
+		}
+		_position++;
+	}
+
+	static std::string parseString(const std::string & _text, size_t & _position) {
+		Regression::expect(_text, _position, '"');
+		std::string toReturn;
+		while (_position < _text.size() && _text.at(_position) != '"') {
+			char character = _text.at(_position++);
+			if (character != '\\') {
+				toReturn += character;
+				continue;
+			}
+			if (_position >= _text.size()) {
+				break;
+			}
+			char escaped = _text.at(_position++);
+			switch (escaped) {
+			case 'n': toReturn += '\n'; break;
+			case 't': toReturn += '\t'; break;
+			case 'r': toReturn += '\r'; break;
+			case 'b': toReturn += '\b'; break;
+			case 'f': toReturn += '\f'; break;
+			case 'u': {
+				if (_position + 4 > _text.size()) {
+					throw "Invalid benchmark baseline: bad escape.";
+				}
+				unsigned long code = std::strtoul(_text.substr(_position, 4).c_str(), nullptr, 16);
+				_position += 4;
+				if (code < 0x80) { //Names are ASCII: other characters are kept as "?".
+					toReturn += (char)code;
+				} else {
+					toReturn += '?';
+				}
+				break;
+			}
+			default: toReturn += escaped; //'"', '\\' and '/'.
+			}
+		}
+		Regression::expect(_text, _position, '"');
+		return toReturn;
+	}
+
+	static Json parse(const std::string & _text, size_t & _position) {
+		Regression::skipSpace(_text, _position);
+		if (_position >= _text.size()) {
+			throw "Invalid benchmark baseline: unexpected end.";
+		}
+		Json toReturn;
+		char first = _text.at(_position);
+		if (first == '{') {
+			toReturn.type = Json::OBJECT;
+			_position++;
+			Regression::skipSpace(_text, _position);
+			if (_position < _text.size() && _text.at(_position) == '}') {
+				_position++;
+				return toReturn;
+			}
+			while (true) {
+				std::string name = Regression::parseString(_text, _position);
+				Regression::expect(_text, _position, ':');
+				toReturn.members.push_back(std::make_pair(name, Regression::parse(_text, _position)));
+				Regression::skipSpace(_text, _position);
+				if (_position < _text.size() && _text.at(_position) == ',') {
+					_position++;
+					continue;
+				}
+				Regression::expect(_text, _position, '}');
+				return toReturn;
+			}
+		}
+		if (first == '[') {
+			toReturn.type = Json::ARRAY;
+			_position++;
+			Regression::skipSpace(_text, _position);
+			if (_position < _text.size() && _text.at(_position) == ']') {
+				_position++;
+				return toReturn;
+			}
+			while (true) {
+				toReturn.array.push_back(Regression::parse(_text, _position));
+				Regression::skipSpace(_text, _position);
+				if (_position < _text.size() && _text.at(_position) == ',') {
+					_position++;
+					continue;
+				}
+				Regression::expect(_text, _position, ']');
+				return toReturn;
+			}
+		}
+		if (first == '"') {
+			toReturn.type = Json::STRING;
+			toReturn.text = Regression::parseString(_text, _position);
+			return toReturn;
+		}
+		for (std::string literal : { "true", "false", "null" }) {
+			if (_text.compare(_position, literal.size(), literal) == 0) {
+				_position += literal.size();
+				toReturn.type = literal == "null" ? Json::NUL : Json::BOOLEAN;
+				toReturn.number = literal == "true" ? 1.0 : 0.0;
+				return toReturn;
+			}
+		}
+		const char* start = _text.c_str() + _position;
+		char* end = nullptr;
+		toReturn.type = Json::NUMBER;
+		toReturn.number = std::strtod(start, &end);
+		if (end == start) {
+			throw "Invalid benchmark baseline: unexpected character.";
+		}
+		_position += (size_t)(end - start);
+		return toReturn;
+	}
+};
+
+#endif
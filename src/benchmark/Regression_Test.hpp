@@ -0,0 +1,74 @@
+#include "gtest/gtest.h"
+#include "benchmark/Regression.hpp"
+
+#include <cstdio>
+
+//A result with given times.
+BenchmarkResult regressionResult(std::string _circuit, std::string _operation, std::vector<double> _seconds) {
+	BenchmarkResult result;
+	result.circuit = _circuit;
+	result.operation = _operation;
+	result.unit = "items";
+	result.items = 1.0;
+	result.seconds = _seconds;
+	return result;
+}
+
+TEST(RegressionTest, MannWhitneyTest) {
+	//All current samples are larger: 1 of 20 orderings.
+	EXPECT_DOUBLE_EQ(0.05, Regression::mannWhitney({ 1.0, 2.0, 3.0 }, { 4.0, 5.0, 6.0 }));
+	//All current samples are smaller: every ordering has U >= 0.
+	EXPECT_DOUBLE_EQ(1.0, Regression::mannWhitney({ 4.0, 5.0, 6.0 }, { 1.0, 2.0, 3.0 }));
+	//U = 1 of 4: orderings with U >= 1 are all but one of 6.
+	EXPECT_DOUBLE_EQ(5.0 / 6.0, Regression::mannWhitney({ 1.0, 3.0 }, { 2.0, 0.5 }));
+	EXPECT_DOUBLE_EQ(1.0, Regression::mannWhitney({}, { 1.0 }));
+	//Ties use the normal approximation.
+	double tied = Regression::mannWhitney({ 1.0, 1.0, 2.0, 2.0, 3.0 }, { 3.0, 4.0, 4.0, 5.0, 6.0 });
+	EXPECT_LT(0.0, tied);
+	EXPECT_GT(0.05, tied);
+	EXPECT_DOUBLE_EQ(1.0, Regression::mannWhitney({ 1.0, 1.0 }, { 1.0, 1.0 }));
+}
+
+TEST(RegressionTest, CompareTest) {
+	std::vector<BenchmarkResult> baseline = {
+		regressionResult("c17", "parse", { 1.0, 1.1, 1.2, 1.3, 1.4 }),
+		regressionResult("c17", "simulate", { 1.0, 1.1, 1.2, 1.3, 1.4 }),
+		regressionResult("c17", "cop", { 1.0, 1.1, 1.2, 1.3, 1.4 }),
+		regressionResult("c432", "parse", { 1.0, 1.1, 1.2, 1.3, 1.4 })
+	};
+	std::vector<BenchmarkResult> current = {
+		regressionResult("c17", "parse", { 2.0, 2.1, 2.2, 2.3, 2.4 }), //Slower.
+		regressionResult("c17", "simulate", { 1.45, 1.5, 1.55, 1.6, 1.65 }), //Slower, but below the threshold.
+		regressionResult("c17", "cop", { 1.05, 1.15, 1.25, 1.35, 1.45 }), //Not significant.
+		regressionResult("c880", "parse", { 9.0, 9.0, 9.0, 9.0, 9.0 }) //No baseline.
+	};
+	std::vector<Slowdown> slowdowns = Regression::compare(baseline, current, 0.01, 0.5);
+	ASSERT_EQ(1, slowdowns.size());
+	EXPECT_EQ("c17", slowdowns.at(0).circuit);
+	EXPECT_EQ("parse", slowdowns.at(0).operation);
+	EXPECT_DOUBLE_EQ(1.2, slowdowns.at(0).baseline);
+	EXPECT_DOUBLE_EQ(2.2, slowdowns.at(0).current);
+	EXPECT_NEAR(2.2 / 1.2 - 1.0, slowdowns.at(0).slowdown(), 1e-12);
+	EXPECT_DOUBLE_EQ(1.0 / 252.0, slowdowns.at(0).p);
+	EXPECT_EQ(2, Regression::compare(baseline, current, 0.01, 0.2).size());
+	EXPECT_EQ(3, Regression::matched(baseline, current));
+}
+
+TEST(RegressionTest, ReadTest) {
+	Benchmark benchmark(0, 3);
+	benchmark.run("ISCAS'85 \"c17\"", "fault simulate", "fault-vectors", []() { return 2.0; });
+	const char* path = "regression_test.json";
+	FILE* file = fopen(path, "w");
+	ASSERT_NE(nullptr, file);
+	benchmark.json(file);
+	fclose(file);
+	std::vector<BenchmarkResult> read = Regression::read(path);
+	remove(path);
+	ASSERT_EQ(1, read.size());
+	EXPECT_EQ("ISCAS'85 \"c17\"", read.at(0).circuit);
+	EXPECT_EQ("fault simulate", read.at(0).operation);
+	EXPECT_EQ("fault-vectors", read.at(0).unit);
+	EXPECT_EQ(2.0, read.at(0).items);
+	EXPECT_EQ(3, read.at(0).seconds.size());
+	EXPECT_ANY_THROW(Regression::read("does not exist.json"));
+}
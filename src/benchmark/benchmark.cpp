@@ -0,0 +1,551 @@
+/**
+ * @file benchmark.cpp
+ * @author Spencer Millican (millican@auburn.edu)
+ * @version 0.1
+ * @date 2020-06-01
+ *
+ * @copyright Copyright (c) 2020
+ *
+ * Measures the performance of the main operations (parse, levelize, simulation,
+ * fault simulation, COP, TPI, SAT and windows) on benchmark circuits and writes
+ * the measurements as JSON (see Benchmark::json).
+ */
+
+#include "parser/Parser.hpp"
+#include "parser/Glob.hpp"
+#include "faults/FaultGenerator.hpp"
+#include "faults/FaultSimulator.hpp"
+#include "tpi/TPGenerator.hpp"
+#include "tpi/Testpoint_control.hpp"
+#include "tpi/Testpoint_observe.hpp"
+#include "tpi/TPI_COP.hpp"
+#include "tpi/COP_fault_calculator.hpp"
+#include "cop/IncrementalCOP.hpp"
+#include "simulation/Simulator.hpp"
+#include "COP_TPI_Structures.hpp"
+#include "prpg/PRPG.hpp"
+#include "sat/SATStructures.hpp"
+#include "sat/SAT.hpp"
+#include "window/Window.hpp"
+#include "benchmark/Benchmark.hpp"
+#include "benchmark/Regression.hpp"
+
+#include <vector>
+#include <set>
+#include <string>
+#include <cstring>
+#include <utility>
+
+#define VALUETYPE FaultyValue<unsigned long long int>
+#define LINETYPE COP_TPI_Line<VALUETYPE>
+#define NODETYPE COP_TPI_Node<VALUETYPE>
+#define CONTROLTP Testpoint_control<NODETYPE, LINETYPE, VALUETYPE>
+#define OBSERVETP Testpoint_observe<NODETYPE, LINETYPE, VALUETYPE>
+#define GENERIC_TESTPOINT Testpoint<NODETYPE, LINETYPE, VALUETYPE>
+#define SATVALUE Value<bool>
+#define COMBINATION Combination<SATLine<SATVALUE>, SATNode<SATVALUE>, SATVALUE>
+
+/*
+ * Benchmark settings.
+ */
+struct Settings {
+	size_t warmup = 1; //Untimed runs of each operation.
+	size_t repetitions = 5; //Timed runs of each operation.
+	size_t vectors = 16; //Vectors (of 64 patterns) to (fault) simulate.
+	size_t samples = 32; //TP candidates, SAT nodes and window lines to measure.
+	int windowLimit = 5; //The window size (see Window::getdata).
+	double satLimit = 0.1; //The SAT time limit (per combination, in seconds).
+	std::set<std::string> operations; //Operations to measure (empty: all).
+	bool hardware = true; //Measure hardware counters (if available).
+	std::string baseline; //Results to compare against (none: do not compare).
+	double alpha = 0.01; //The significance level of a slowdown.
+	double threshold = 0.10; //The smallest relative slowdown (of medians) which is a regression.
+};
+
+Settings settings;
+
+//Should an operation be measured?
+bool measured(std::string _operation) {
+	return settings.operations.empty() || settings.operations.count(_operation) != 0;
+}
+
+//The name of a circuit (the file name without directories or extensions).
+std::string circuitName(std::string _file) {
+	size_t slash = _file.find_last_of("/\\");
+	std::string name = (slash == std::string::npos) ? _file : _file.substr(slash + 1);
+	return name.substr(0, name.find('.'));
+}
+
+//All COP objects (nodes and lines) of a circuit.
+std::vector<COP*> copObjects(Circuit* _circuit) {
+	std::set<Connecting*> seen;
+	std::vector<Connecting*> toVisit(_circuit->nodes().begin(), _circuit->nodes().end());
+	std::vector<COP*> toReturn;
+	while (toVisit.empty() == false) {
+		Connecting* object = toVisit.back();
+		toVisit.pop_back();
+		if (seen.emplace(object).second == false) {
+			continue;
+		}
+		COP* cast = dynamic_cast<COP*>(object);
+		if (cast != nullptr) {
+			toReturn.push_back(cast);
+		}
+		for (Connecting* output : object->outputs()) {
+			toVisit.push_back(output);
+		}
+	}
+	return toReturn;
+}
+
+//Up to "samples" items, evenly spaced (the order must be deterministic).
+template <class _type>
+std::vector<_type> sample(std::vector<_type> _items) {
+	if (_items.size() <= settings.samples) {
+		return _items;
+	}
+	std::vector<_type> toReturn;
+	for (size_t i = 0; i < settings.samples; i++) {
+		toReturn.push_back(_items.at(i * _items.size() / settings.samples));
+	}
+	return toReturn;
+}
+
+/*
+ * Measure simulation and fault simulation of a circuit.
+ *
+ * @param _benchmark The benchmark to add measurements to.
+ * @param _name The name of the circuit.
+ * @param _suffix Added to the name of each operation, e.g., " (cone order)".
+ * @param _circuit The circuit.
+ * @param _vectors The vectors to (fault) simulate.
+ * @param _faults The faults of the circuit.
+ */
+void measureSimulation(Benchmark & _benchmark, std::string _name, std::string _suffix, Circuit* _circuit,
+	std::vector<std::vector<VALUETYPE>> & _vectors, std::unordered_set<Fault<VALUETYPE>*> & _faults) {
+	double patterns = (double)(_vectors.size() * 64);
+	if (measured("simulate" + _suffix)) {
+		Simulator<VALUETYPE> simulator;
+		_benchmark.run(_name, "simulate" + _suffix, "vectors", [&]() {
+			for (std::vector<VALUETYPE> & vector : _vectors) {
+				simulator.applyStimulus(_circuit, vector);
+			}
+			return patterns;
+		});
+	}
+	if (measured("fault simulate" + _suffix)) {
+		FaultSimulator<VALUETYPE> faultSimulator(false);
+		faultSimulator.setFaults(_faults);
+		_benchmark.run(_name, "fault simulate" + _suffix, "fault-vectors",
+			[&]() { faultSimulator.resetFaults(); },
+			[&]() {
+				for (std::vector<VALUETYPE> & vector : _vectors) {
+					faultSimulator.applyStimulus(_circuit, vector);
+				}
+				return patterns * (double)_faults.size();
+			}
+		);
+		faultSimulator.resetFaults();
+	}
+}
+
+/*
+ * Measure all operations on a single circuit.
+ *
+ * @param _benchmark The benchmark to add measurements to.
+ * @param _file The circuit file.
+ */
+void measure(Benchmark & _benchmark, std::string _file) {
+	std::string name = circuitName(_file);
+	Parser<LINETYPE, NODETYPE, VALUETYPE> parser;
+
+	//PARSE
+	Circuit* circuit = parser.Parse(_file.c_str());
+	size_t numNodes = circuit->nodes().size();
+	if (measured("parse")) {
+		Circuit* parsed = nullptr;
+		_benchmark.run(name, "parse", "nodes",
+			[&]() { delete parsed; parsed = nullptr; },
+			[&]() { parsed = parser.Parse(_file.c_str()); return (double)parsed->nodes().size(); }
+		);
+		delete parsed;
+	}
+	//PARSE CACHED (the cache is written by the first, untimed, parse)
+	if (measured("parse cached")) {
+		Parser<LINETYPE, NODETYPE, VALUETYPE> cachingParser;
+		cachingParser.cache(true);
+		Circuit* parsed = cachingParser.Parse(_file.c_str());
+		_benchmark.run(name, "parse cached", "nodes",
+			[&]() { delete parsed; parsed = nullptr; },
+			[&]() { parsed = cachingParser.Parse(_file.c_str()); return (double)parsed->nodes().size(); }
+		);
+		delete parsed;
+	}
+
+	//LEVELIZE (all levels are cleared first)
+	if (measured("levelize")) {
+		_benchmark.run(name, "levelize", "nodes",
+			[&]() {
+				for (Levelized* pi : circuit->pis()) { pi->inputLevelClear(); pi->inputLevelZero(); }
+				for (Levelized* po : circuit->pos()) { po->outputLevelClear(); po->outputLevelZero(); }
+			},
+			[&]() {
+				for (Levelized* node : circuit->nodes()) {
+					node->inputLevel();
+					node->outputLevel();
+				}
+				return (double)numNodes;
+			}
+		);
+	}
+
+	//Vectors are generated before simulation (and are not timed).
+	PRPG<VALUETYPE> prpg(circuit->pis().size());
+	std::vector<std::vector<VALUETYPE>> vectors;
+	for (size_t i = 0; i < settings.vectors; i++) {
+		vectors.push_back(prpg.load());
+	}
+	double patterns = (double)(settings.vectors * 64);
+
+	//SIMULATION and FAULT SIMULATION (stuck-at, detected faults are dropped as usual)
+	std::unordered_set<Fault<VALUETYPE>*> faults = FaultGenerator<VALUETYPE>::allFaults(circuit, true);
+	measureSimulation(_benchmark, name, "", circuit, vectors, faults);
+
+	//(FAULT) SIMULATION OF OTHER ORDERS (the circuit above is created in level
+	//order, see Parser::order), e.g., to compare cache misses.
+	std::vector<std::pair<Netlist::Order, std::string>> orders = {
+		std::make_pair(Netlist::PARSE, " (parse order)"),
+		std::make_pair(Netlist::CONE, " (cone order)")
+	};
+	for (std::pair<Netlist::Order, std::string> order : orders) {
+		if (measured("simulate" + order.second) == false && measured("fault simulate" + order.second) == false) {
+			continue;
+		}
+		Parser<LINETYPE, NODETYPE, VALUETYPE> orderedParser;
+		orderedParser.order(order.first);
+		Circuit* ordered = orderedParser.Parse(_file.c_str());
+		std::unordered_set<Fault<VALUETYPE>*> orderedFaults = FaultGenerator<VALUETYPE>::allFaults(ordered, true);
+		measureSimulation(_benchmark, name, order.second, ordered, vectors, orderedFaults);
+		for (Fault<VALUETYPE>* fault : orderedFaults) {
+			delete fault;
+		}
+		delete ordered;
+	}
+
+	//COP (all values are cleared first)
+	std::vector<COP*> cops = copObjects(circuit);
+	if (measured("cop")) {
+		_benchmark.run(name, "cop", "objects",
+			[&]() {
+				for (COP* cop : cops) {
+					cop->controllability(-1.0f);
+					cop->observability(-1.0f);
+				}
+			},
+			[&]() {
+				for (COP* cop : cops) {
+					cop->controllability();
+					cop->observability();
+				}
+				return (double)cops.size();
+			}
+		);
+	}
+
+	//BATCH COP (the circuit is flattened once, then all values are calculated at once)
+	if (measured("cop batch build")) {
+		_benchmark.run(name, "cop batch build", "objects", [&]() {
+			BatchCOP<VALUETYPE> batch;
+			batch.build(circuit);
+			return (double)batch.size();
+		});
+	}
+	if (measured("cop batch")) {
+		BatchCOP<VALUETYPE> batch;
+		batch.build(circuit);
+		_benchmark.run(name, "cop batch", "objects", [&]() {
+			batch.calculate();
+			return (double)batch.size();
+		});
+	}
+
+	//COP FAULT COVERAGE (COP values are cleared first, so they are recalculated)
+	if (measured("cop fault coverage")) {
+		COP_fault_calculator<VALUETYPE> calculator(circuit, true, (int)patterns, faults);
+		_benchmark.run(name, "cop fault coverage", "faults",
+			[&]() {
+				for (COP* cop : cops) {
+					cop->controllability(-1.0f);
+					cop->observability(-1.0f);
+				}
+			},
+			[&]() {
+				calculator.faultCoverage();
+				return (double)faults.size();
+			}
+		);
+		calculator.clearFaults(); //The faults are deleted below.
+	}
+
+	//TPI (evaluation of a sample of TP candidates, by activating them or by incremental COP)
+	if (measured("tpi") || measured("tpi incremental")) {
+		std::set<GENERIC_TESTPOINT*> controls = TPGenerator<CONTROLTP, NODETYPE, LINETYPE, VALUETYPE>::allTPs(circuit);
+		std::set<GENERIC_TESTPOINT*> observes = TPGenerator<OBSERVETP, NODETYPE, LINETYPE, VALUETYPE>::allTPs(circuit);
+		std::vector<GENERIC_TESTPOINT*> candidates(controls.begin(), controls.end());
+		candidates.insert(candidates.end(), observes.begin(), observes.end());
+		std::stable_sort(candidates.begin(), candidates.end(), [](GENERIC_TESTPOINT* _a, GENERIC_TESTPOINT* _b) {
+			return _a->location()->name() < _b->location()->name();
+		});
+		std::vector<GENERIC_TESTPOINT*> sampled = sample(candidates);
+		if (measured("tpi")) {
+			TPI_COP<NODETYPE, LINETYPE, VALUETYPE> tpi(circuit, (int)patterns, {}, {}, {}, true, faults);
+			_benchmark.run(name, "tpi", "candidates", [&]() {
+				for (GENERIC_TESTPOINT* candidate : sampled) {
+					tpi.quality(candidate, circuit);
+				}
+				return (double)sampled.size();
+			});
+		}
+		if (measured("tpi incremental")) {
+			IncrementalCOP<VALUETYPE> cop(circuit);
+			COP_fault_calculator<VALUETYPE> calculator(circuit, true, (int)patterns, faults);
+			calculator.index(cop);
+			_benchmark.run(name, "tpi incremental", "candidates", [&]() {
+				for (GENERIC_TESTPOINT* candidate : sampled) {
+					size_t checkpoint = cop.checkpoint();
+					size_t id = cop.id(candidate->location());
+					CONTROLTP* control = dynamic_cast<CONTROLTP*>(candidate);
+					if (control != nullptr) {
+						cop.control(id, control->value().magnitude());
+					} else {
+						cop.observe(id);
+					}
+					cop.update();
+					calculator.faultCoverage(cop, checkpoint);
+					cop.rollback(checkpoint);
+				}
+				return (double)sampled.size();
+			});
+			calculator.clearFaults(); //The faults are deleted below.
+		}
+		for (GENERIC_TESTPOINT* candidate : candidates) {
+			delete candidate;
+		}
+	}
+
+	//WINDOW (features of a sample of lines)
+	if (measured("window")) {
+		std::vector<Levelized*> lines;
+		for (COP* cop : cops) {
+			LINETYPE* line = dynamic_cast<LINETYPE*>(cop);
+			if (line != nullptr && line->inputs().size() == 1 && line->outputs().size() > 0) {
+				lines.push_back(line);
+			}
+		}
+		std::sort(lines.begin(), lines.end(), [](Levelized* _a, Levelized* _b) { return _a->name() < _b->name(); });
+		std::vector<Levelized*> sampled = sample(lines);
+		_benchmark.run(name, "window", "lines", [&]() {
+			for (Levelized* line : sampled) {
+				Window<VALUETYPE, NODETYPE, LINETYPE>::getdata(circuit, line, settings.windowLimit);
+			}
+			return (double)sampled.size();
+		});
+	}
+
+	for (Fault<VALUETYPE>* fault : faults) {
+		delete fault;
+	}
+	delete circuit; //Circuits must be deleted after faults.
+
+	//SAT (all input combinations of a sample of nodes with at most 4 inputs)
+	if (measured("sat")) {
+		Parser<SATLine<SATVALUE>, SATNode<SATVALUE>, SATVALUE> satParser;
+		Circuit* satCircuit = satParser.Parse(_file.c_str());
+		std::vector<SATNode<SATVALUE>*> nodes;
+		for (Levelized* node : satCircuit->nodes()) {
+			SATNode<SATVALUE>* cast = dynamic_cast<SATNode<SATVALUE>*>(node);
+			//Wide gates are skipped: they have too many combinations to try.
+			if (cast != nullptr && cast->inputs().size() > 0 && cast->inputs().size() <= 4 && cast->outputs().size() > 0) {
+				nodes.push_back(cast);
+			}
+		}
+		std::sort(nodes.begin(), nodes.end(), [](SATNode<SATVALUE>* _a, SATNode<SATVALUE>* _b) {
+			return (*_a->outputs().begin())->name() < (*_b->outputs().begin())->name();
+		});
+		std::vector<SATNode<SATVALUE>*> sampled = sample(nodes);
+		SAT<SATVALUE> sat;
+		sat.limit_ = settings.satLimit;
+		std::unordered_set<COMBINATION*> combinations;
+		auto clear = [&]() {
+			for (COMBINATION* combination : combinations) {
+				delete combination;
+			}
+			combinations.clear();
+		};
+		_benchmark.run(name, "sat", "combinations",
+			[&]() {
+				clear();
+				for (SATNode<SATVALUE>* node : sampled) {
+					std::unordered_set<COMBINATION*> nodeCombinations = COMBINATION::allNodeCombinations(node);
+					combinations.insert(nodeCombinations.begin(), nodeCombinations.end());
+				}
+			},
+			[&]() {
+				sat.satisfy(std::unordered_set<Goal<SATVALUE>*>(combinations.begin(), combinations.end()));
+				return (double)combinations.size();
+			}
+		);
+		clear();
+		delete satCircuit;
+	}
+}
+
+//Print how to use this program.
+void printUsage(const char* _program) {
+	printf("Usage: %s [options] [bench file or glob]...\n", _program);
+	printf("Measures parse, parse cached, levelize, simulate, fault simulate, cop, cop batch\n");
+	printf("build, cop batch, cop fault coverage, tpi, tpi incremental, sat and window on each\n");
+	printf("circuit and writes the measurements as JSON.\n");
+	printf("Circuits are created in level order; simulate and fault simulate are also measured\n");
+	printf("in parse order and cone order, e.g., \"simulate (cone order)\", to compare cache misses.\n\n");
+	printf("Options:\n");
+	printf("  -b, --bench <dir>        The Bench directory used if no circuits are given (default: Bench).\n");
+	printf("  -o, --output <file>      Write JSON to a file instead of stdout.\n");
+	printf("  -w, --warmup <n>         Untimed runs of each operation (default: %zu).\n", settings.warmup);
+	printf("  -r, --repetitions <n>    Timed runs of each operation (default: %zu).\n", settings.repetitions);
+	printf("  --vectors <n>            Vectors (of 64 patterns) to simulate (default: %zu).\n", settings.vectors);
+	printf("  --samples <n>            TP candidates, SAT nodes and window lines (default: %zu).\n", settings.samples);
+	printf("  --only <operation>       Only measure this operation (may be repeated).\n");
+	printf("  --no-hardware            Do not measure hardware counters (cycles, instructions, misses).\n");
+	printf("  --baseline <file>        Compare against results (JSON) of an earlier run: exit with 2 if any\n");
+	printf("                           operation is significantly slower (Mann-Whitney U test).\n");
+	printf("  --alpha <p>              The significance level of a slowdown (default: %g).\n", settings.alpha);
+	printf("  --threshold <fraction>   The smallest slowdown of the median which fails (default: %g).\n", settings.threshold);
+	printf("  -h, --help               Print this message.\n");
+}
+
+int main(int argc, const char* argv[]) {
+	std::vector<std::string> args(argv + 1, argv + argc);
+	std::vector<std::string> circuits;
+	std::string bench = "Bench";
+	std::string outputFile;
+	try {
+		for (size_t i = 0; i < args.size(); i++) {
+			std::string arg = args.at(i);
+			if (arg == "-h" || arg == "--help") {
+				printUsage(argv[0]);
+				return 0;
+			}
+			if (arg == "--no-hardware") {
+				settings.hardware = false;
+				continue;
+			}
+			if (arg.size() < 2 || arg.at(0) != '-') {
+				std::vector<std::string> matches = expandGlob(arg);
+				circuits.insert(circuits.end(), matches.begin(), matches.end());
+				continue;
+			}
+			if (i + 1 >= args.size()) {
+				fprintf(stderr, "Missing value for '%s'.\n", arg.c_str());
+				return 1;
+			}
+			std::string value = args.at(++i);
+			if (arg == "-b" || arg == "--bench") { bench = value; }
+			else if (arg == "-o" || arg == "--output") { outputFile = value; }
+			else if (arg == "-w" || arg == "--warmup") { settings.warmup = std::stoul(value); }
+			else if (arg == "-r" || arg == "--repetitions") { settings.repetitions = std::stoul(value); }
+			else if (arg == "--vectors") { settings.vectors = std::stoul(value); }
+			else if (arg == "--samples") { settings.samples = std::stoul(value); }
+			else if (arg == "--only") { settings.operations.emplace(value); }
+			else if (arg == "--baseline") { settings.baseline = value; }
+			else if (arg == "--alpha") { settings.alpha = std::stod(value); }
+			else if (arg == "--threshold") { settings.threshold = std::stod(value); }
+			else {
+				fprintf(stderr, "Unknown option '%s'.\n", arg.c_str());
+				printUsage(argv[0]);
+				return 1;
+			}
+		}
+	} catch (std::exception&) { //Thrown by std::stoul
+		fprintf(stderr, "Invalid number.\n");
+		return 1;
+	}
+	if (circuits.empty()) {
+		for (std::string pattern : {
+			bench + "/ISCAS'85 Bench/*.bench",
+			bench + "/ISCAS89/*.pseudo.bench",
+			bench + "/ITC'99 Bench/*.bench" }) {
+			std::vector<std::string> matches = expandGlob(pattern);
+			if (matches.size() == 1 && matches.front() == pattern) { //Nothing matched.
+				continue;
+			}
+			circuits.insert(circuits.end(), matches.begin(), matches.end());
+		}
+	}
+	if (circuits.empty()) {
+		fprintf(stderr, "No circuits found.\n");
+		return 1;
+	}
+
+	//The baseline is read first, so a bad baseline fails before anything is measured.
+	std::vector<BenchmarkResult> baseline;
+	if (settings.baseline.empty() == false) {
+		try {
+			baseline = Regression::read(settings.baseline);
+		} catch (const char* error) {
+			fprintf(stderr, "%s: %s\n", settings.baseline.c_str(), error);
+			return 1;
+		}
+	}
+
+	Benchmark benchmark(settings.warmup, settings.repetitions);
+	if (settings.hardware == true && benchmark.hardware(true) == false) {
+		fprintf(stderr, "Hardware counters are unavailable (%s): only times are measured.\n", benchmark.hardwareError().c_str());
+	}
+	bool failed = false;
+	for (std::string circuit : circuits) {
+		fprintf(stderr, "%s\n", circuit.c_str());
+		try {
+			measure(benchmark, circuit);
+		} catch (const char* error) {
+			fprintf(stderr, "%s: %s\n", circuit.c_str(), error);
+			failed = true;
+		}
+	}
+
+	FILE* output = stdout;
+	if (outputFile.empty() == false) {
+		output = fopen(outputFile.c_str(), "w");
+		if (output == nullptr) {
+			fprintf(stderr, "Failed to open '%s' for writing.\n", outputFile.c_str());
+			return 1;
+		}
+	}
+	benchmark.json(output);
+	if (output != stdout) {
+		fclose(output);
+	}
+	if (failed) {
+		return 1;
+	}
+
+	if (settings.baseline.empty() == false) {
+		std::vector<Slowdown> slowdowns = Regression::compare(baseline, benchmark.results(), settings.alpha, settings.threshold);
+		fprintf(stderr, "Compared %zu operations against %s: %zu regressed.\n",
+			Regression::matched(baseline, benchmark.results()), settings.baseline.c_str(), slowdowns.size());
+		for (const Slowdown & slowdown : slowdowns) {
+			fprintf(stderr, "REGRESSION %s %s: %.6g s -> %.6g s (+%.1f%%, p = %.3g)\n",
+				slowdown.circuit.c_str(),
+				slowdown.operation.c_str(),
+				slowdown.baseline,
+				slowdown.current,
+				slowdown.slowdown() * 100.0,
+				slowdown.p
+			);
+		}
+		if (slowdowns.empty() == false) {
+			return 2;
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,641 @@
+/**
+ * @file BatchCOP.hpp
+ * @author Spencer Millican (millican@auburn.edu)
+ * @version 0.1
+ * @date 2020-06-08
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#ifndef BatchCOP_h
+#define BatchCOP_h
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <unordered_map>
+
+#include "cop/COPStructures.hpp"
+#include "structures/Circuit.h"
+
+/*
+ * COP for an entire circuit at once.
+ *
+ * Every object (Node and Line) of the circuit is given an id in topological
+ * order and the circuit is flattened into arrays: the inputs of every object
+ * and the outputs (connections) of every object. Controllability is then
+ * calculated by one forward sweep and observability by one reverse sweep,
+ * without any recursion, memoization or casting.
+ *
+ * Observability is kept for every input "pin" (connection): the observability
+ * of an object as seen by one of its inputs (the "fan out problem", see
+ * COP::observability).
+ *
+ * The values calculated are exactly those calculated by COP objects (the same
+ * calculations are done in the same order).
+ *
+ * The arrays describe the circuit when it was built: if the circuit changes,
+ * it must be built again.
+ *
+ * @param _valueType The type of value being simulated, e.g., Value/FaultyValue
+ */
+template <class _valueType>
+class BatchCOP {
+public:
+	/*
+	 * Create an empty calculator (see "build").
+	 */
+	BatchCOP() {}
+
+	/*
+	 * Create the calculator for a given circuit and calculate COP.
+	 *
+	 * @param _circuit The circuit (all objects must be COP objects).
+	 */
+	BatchCOP(Circuit* _circuit) {
+		this->build(_circuit);
+		this->calculate();
+	}
+
+	/*
+	 * Flatten a circuit (without calculating COP).
+	 *
+	 * All objects reachable from the circuit's nodes are included. An exception
+	 * will be thrown if an object is not a COP object or the circuit has a
+	 * cycle.
+	 *
+	 * @param _circuit The circuit to flatten.
+	 */
+	void build(Circuit* _circuit);
+
+	/*
+	 * Calculate controllability and then observability of all objects.
+	 */
+	void calculate() {
+		this->controllabilities();
+		this->observabilities();
+	}
+
+	/*
+	 * Calculate the controllability of all objects (forward sweep).
+	 */
+	void controllabilities();
+
+	/*
+	 * Calculate the observability of all objects and pins (reverse sweep).
+	 *
+	 * Controllabilities must be calculated first.
+	 */
+	void observabilities();
+
+	/*
+	 * Save all values in the COP objects, so COP objects return these values
+	 * without calculating them.
+	 *
+	 * As with COP objects, the observability of a Node with more than one
+	 * input is not saved (it depends on the calling input).
+	 */
+	void store() const;
+
+	/*
+	 * The number of objects.
+	 *
+	 * @return The number of objects.
+	 */
+	size_t size() const {
+		return this->objects_.size();
+	}
+
+	/*
+	 * The id of an object.
+	 *
+	 * An exception will be thrown if the object is not in the circuit.
+	 *
+	 * @param _object The object.
+	 * @return The id of the object.
+	 */
+	size_t id(const Connecting* _object) const {
+		auto it = this->ids_.find(_object);
+		if (it == this->ids_.end()) {
+			throw "Cannot find the batch COP id: the object is not in the circuit.";
+		}
+		return it->second;
+	}
+
+	/*
+	 * The object of an id.
+	 *
+	 * @param _id The id.
+	 * @return The object.
+	 */
+	COP* object(size_t _id) const {
+		return this->objects_[_id];
+	}
+
+	/*
+	 * Is an object a Line?
+	 *
+	 * @param _id The id of the object.
+	 * @return True if the object is a Line.
+	 */
+	bool line(size_t _id) const {
+		return this->kinds_[_id] == LINE;
+	}
+
+	/*
+	 * The controllability of an object.
+	 *
+	 * @param _id The id of the object.
+	 * @return The controllability.
+	 */
+	float controllability(size_t _id) const {
+		return this->controllability_[_id];
+	}
+
+	/*
+	 * The observability of an object (with no calling object).
+	 *
+	 * @param _id The id of the object.
+	 * @return The observability.
+	 */
+	float observability(size_t _id) const {
+		return this->observability_[_id];
+	}
+
+	/*
+	 * The observability of an object as seen by one of its inputs.
+	 *
+	 * @param _id The id of the object.
+	 * @param _input The index of the input (in input order).
+	 * @return The observability.
+	 */
+	float observability(size_t _id, size_t _input) const {
+		return this->pinObservability_[this->firstInput_[_id] + _input];
+	}
+
+	/*
+	 * The ids of the inputs of an object (in input order).
+	 *
+	 * @param _id The id of the object.
+	 * @return The first and last (exclusive) input ids.
+	 */
+	std::pair<const uint32_t*, const uint32_t*> inputs(size_t _id) const {
+		return std::make_pair(
+			this->inputs_.data() + this->firstInput_[_id],
+			this->inputs_.data() + this->firstInput_[_id + 1]
+		);
+	}
+
+protected:
+	/*
+	 * How an object is calculated (from its name, see COPNode).
+	 */
+	enum Kind : uint8_t {
+		LINE,     //The controllability of the input, observability of all outputs.
+		PI,       //Controllability 0.5.
+		CONSTANT, //Controllability of its value, observability 0.
+		AND,
+		NAND,
+		OR,
+		NOR,
+		BUF,      //Also "copy" nodes (no function).
+		NOT,
+		OBSERVE,  //"po" and observe points (always observable).
+		OTHER     //Controllability by manually evaluating the function.
+	};
+
+	/*
+	 * How an object is calculated.
+	 */
+	std::vector<uint8_t> kinds_;
+
+	/*
+	 * The objects (by id).
+	 */
+	std::vector<COP*> objects_;
+
+	/*
+	 * The id of every object.
+	 */
+	std::unordered_map<const Connecting*, uint32_t> ids_;
+
+	/*
+	 * The inputs of object "i" are inputs_[firstInput_[i]] to
+	 * inputs_[firstInput_[i + 1] - 1]. Each is a "pin".
+	 */
+	std::vector<uint32_t> firstInput_;
+	std::vector<uint32_t> inputs_;
+
+	/*
+	 * The pins fed by object "i" (in output order) are outputPins_[firstOutput_[i]]
+	 * to outputPins_[firstOutput_[i + 1] - 1].
+	 */
+	std::vector<uint32_t> firstOutput_;
+	std::vector<uint32_t> outputPins_;
+
+	/*
+	 * Constant values (for CONSTANT objects).
+	 */
+	std::vector<float> constant_;
+
+	/*
+	 * The calculated values.
+	 */
+	std::vector<float> controllability_;
+	std::vector<float> observability_;
+	std::vector<float> pinObservability_;
+
+	/*
+	 * Testpoints (see IncrementalCOP) which change the values of Lines.
+	 */
+	enum Testpoint : uint8_t {
+		CONTROL_0 = 1, //Controllability 0, not observed through the Line's input.
+		CONTROL_1 = 2, //Controllability 1, not observed through the Line's input.
+		INVERT = 4,    //Inverted controllability.
+		OBSERVED = 8   //Observability 1.
+	};
+
+	/*
+	 * The testpoints on every object (none by default).
+	 */
+	std::vector<uint8_t> testpoints_;
+
+	/*
+	 * Calculate the controllability of an object (inputs must be calculated).
+	 *
+	 * @param _id The id of the object.
+	 * @return The controllability.
+	 */
+	float calculateControllability(size_t _id) const;
+
+	/*
+	 * The observability of what an object feeds (the objects fed by it must be
+	 * calculated): for a Line, all of its outputs, for a Node, its (first)
+	 * output.
+	 *
+	 * @param _id The id of the object.
+	 * @return The observability of the object's outputs.
+	 */
+	float outputObservability(size_t _id) const;
+
+	/*
+	 * Calculate the observability of an object (with no calling object).
+	 *
+	 * @param _id The id of the object.
+	 * @param _output The observability of the object's outputs.
+	 * @return The observability.
+	 */
+	float calculateObservability(size_t _id, float _output) const;
+
+	/*
+	 * Calculate the observability of an object as seen by one of its inputs.
+	 *
+	 * @param _id The id of the object.
+	 * @param _pin The pin of the input.
+	 * @param _output The observability of the object's outputs.
+	 * @return The observability.
+	 */
+	float calculatePinObservability(size_t _id, uint32_t _pin, float _output) const;
+
+	/*
+	 * The probability a signal passes through a Node from a given input.
+	 *
+	 * @param _id The id of the Node.
+	 * @param _calling The id of the input (all inputs where it is connected are
+	 *        skipped). If not an input, no input is skipped.
+	 * @return The probability.
+	 */
+	float pass(size_t _id, uint32_t _calling) const;
+
+private:
+	/*
+	 * The kind of a Node (from its name).
+	 *
+	 * @param _node The Node.
+	 * @return The kind of the Node.
+	 */
+	static Kind kind(COPNode<_valueType>* _node);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Inline function declarations.
+////////////////////////////////////////////////////////////////////////////////
+
+template <class _valueType>
+inline typename BatchCOP<_valueType>::Kind BatchCOP<_valueType>::kind(COPNode<_valueType>* _node) {
+	std::string name = _node->name();
+	if (name == "pi") {
+		return PI;
+	}
+	if (name.find("const") != std::string::npos) {
+		return CONSTANT;
+	}
+	if (name == "po" || name.find("observe") != std::string::npos) {
+		return OBSERVE;
+	}
+	if (name == "and") {
+		return AND;
+	}
+	if (name == "nand") {
+		return NAND;
+	}
+	if (name == "or") {
+		return OR;
+	}
+	if (name == "nor") {
+		return NOR;
+	}
+	if (name == "buf" || _node->function() == nullptr) {
+		return BUF;
+	}
+	if (name == "not") {
+		return NOT;
+	}
+	return OTHER;
+}
+
+template <class _valueType>
+void BatchCOP<_valueType>::build(Circuit* _circuit) {
+	this->kinds_.clear();
+	this->objects_.clear();
+	this->ids_.clear();
+	this->constant_.clear();
+
+	//Find all objects (numbered in the order found).
+	std::vector<Connecting*> found;
+	std::unordered_map<const Connecting*, uint32_t> & ids = this->ids_;
+	for (Levelized* node : _circuit->nodes()) {
+		if (ids.emplace(node, (uint32_t)found.size()).second) {
+			found.push_back(node);
+		}
+	}
+	for (size_t i = 0; i < found.size(); i++) {
+		for (Connecting* output : found[i]->outputSpan()) {
+			if (ids.emplace(output, (uint32_t)found.size()).second) {
+				found.push_back(output);
+			}
+		}
+		for (Connecting* input : found[i]->inputSpan()) {
+			if (ids.emplace(input, (uint32_t)found.size()).second) {
+				found.push_back(input);
+			}
+		}
+	}
+
+	//Order them topologically (Kahn's algorithm) and renumber them.
+	size_t size = found.size();
+	std::vector<uint32_t> remaining(size);
+	std::vector<uint32_t> order;
+	order.reserve(size);
+	for (size_t i = 0; i < size; i++) {
+		remaining[i] = (uint32_t)found[i]->inputSpan().size();
+		if (remaining[i] == 0) {
+			order.push_back((uint32_t)i);
+		}
+	}
+	for (size_t i = 0; i < order.size(); i++) {
+		for (Connecting* output : found[order[i]]->outputSpan()) {
+			uint32_t outputIndex = ids.at(output);
+			if (--remaining[outputIndex] == 0) {
+				order.push_back(outputIndex);
+			}
+		}
+	}
+	if (order.size() != size) {
+		throw "Cannot build batch COP: the circuit has a cycle.";
+	}
+	for (size_t i = 0; i < size; i++) {
+		remaining[order[i]] = (uint32_t)i;
+	}
+	for (auto & id : ids) {
+		id.second = remaining[id.second];
+	}
+
+	//Flatten.
+	this->kinds_.resize(size);
+	this->objects_.resize(size);
+	this->constant_.assign(size, 0.0f);
+	this->firstInput_.assign(size + 1, 0);
+	this->inputs_.clear();
+	std::vector<uint32_t> numOutputs(size, 0);
+	for (size_t i = 0; i < size; i++) {
+		Connecting* object = found[order[i]];
+		COP* cop = dynamic_cast<COP*>(object);
+		if (cop == nullptr) {
+			throw "Cannot build batch COP: an object is not a COP object.";
+		}
+		this->objects_[i] = cop;
+		COPNode<_valueType>* node = dynamic_cast<COPNode<_valueType>*>(object);
+		this->kinds_[i] = (node == nullptr) ? LINE : kind(node);
+		if (this->kinds_[i] == CONSTANT) {
+			_valueType value = node->value();
+			if (value.valid() == false) {
+				throw "Cannot calculate COP CC: constant value is not valid.";
+			}
+			this->constant_[i] = value.magnitude() ? 1.0f : 0.0f;
+		}
+		for (Connecting* input : object->inputSpan()) {
+			uint32_t inputId = this->ids_.at(input);
+			this->inputs_.push_back(inputId);
+			numOutputs[inputId]++;
+		}
+		this->firstInput_[i + 1] = (uint32_t)this->inputs_.size();
+	}
+
+	//The pins fed by every object, in output order.
+	this->firstOutput_.assign(size + 1, 0);
+	for (size_t i = 0; i < size; i++) {
+		this->firstOutput_[i + 1] = this->firstOutput_[i] + numOutputs[i];
+	}
+	this->outputPins_.assign(this->inputs_.size(), 0);
+	for (size_t i = 0; i < size; i++) {
+		uint32_t* next = this->outputPins_.data() + this->firstOutput_[i];
+		for (Connecting* output : found[order[i]]->outputSpan()) {
+			uint32_t outputId = this->ids_.at(output);
+			for (uint32_t pin = this->firstInput_[outputId]; pin < this->firstInput_[outputId + 1]; pin++) {
+				if (this->inputs_[pin] == i) {
+					*next++ = pin;
+					break;
+				}
+			}
+		}
+	}
+
+	this->testpoints_.assign(size, 0);
+	this->controllability_.assign(size, -1.0f);
+	this->observability_.assign(size, -1.0f);
+	this->pinObservability_.assign(this->inputs_.size(), -1.0f);
+}
+
+template <class _valueType>
+inline float BatchCOP<_valueType>::calculateControllability(size_t _id) const {
+	const uint32_t* input = this->inputs_.data() + this->firstInput_[_id];
+	const uint32_t* last = this->inputs_.data() + this->firstInput_[_id + 1];
+	const float* controllability = this->controllability_.data();
+	float toReturn = 1.0;
+	switch (this->kinds_[_id]) {
+	case LINE:
+		if (last - input != 1) {
+			throw "Cannot calculate COPLine controllability: need exactly 1 input.";
+		}
+		if (this->testpoints_[_id] != 0) {
+			uint8_t testpoints = this->testpoints_[_id];
+			if (testpoints & CONTROL_0) {
+				return 0.0;
+			}
+			if (testpoints & CONTROL_1) {
+				return 1.0;
+			}
+			if (testpoints & INVERT) {
+				return 1 - controllability[*input];
+			}
+		}
+		return controllability[*input];
+	case PI:
+		return 0.5;
+	case CONSTANT:
+		return this->constant_[_id];
+	case AND:
+	case NAND:
+	case BUF:
+	case NOT:
+	case OBSERVE:
+		for (; input != last; input++) {
+			toReturn *= controllability[*input];
+		}
+		break;
+	case OR:
+	case NOR:
+		for (; input != last; input++) {
+			toReturn *= (1 - controllability[*input]);
+		}
+		break;
+	default: {
+		std::vector<float> inputControllabilities;
+		for (; input != last; input++) {
+			inputControllabilities.push_back(controllability[*input]);
+		}
+		toReturn = manualCOP(dynamic_cast<COPNode<_valueType>*>(this->objects_[_id]), inputControllabilities);
+	}
+	}
+	if (this->kinds_[_id] == NAND || this->kinds_[_id] == OR || this->kinds_[_id] == NOT) {
+		toReturn = 1 - toReturn;
+	}
+	return toReturn;
+}
+
+template <class _valueType>
+inline float BatchCOP<_valueType>::pass(size_t _id, uint32_t _calling) const {
+	const uint32_t* input = this->inputs_.data() + this->firstInput_[_id];
+	const uint32_t* last = this->inputs_.data() + this->firstInput_[_id + 1];
+	const float* controllability = this->controllability_.data();
+	float pPass = 1.0;
+	switch (this->kinds_[_id]) {
+	case AND:
+	case NAND:
+		for (; input != last; input++) {
+			if (*input != _calling) {
+				pPass *= controllability[*input];
+			}
+		}
+		break;
+	case OR:
+	case NOR:
+		for (; input != last; input++) {
+			if (*input != _calling) {
+				pPass *= 1 - controllability[*input];
+			}
+		}
+		break;
+	default:
+		break;
+	}
+	return pPass;
+}
+
+template <class _valueType>
+void BatchCOP<_valueType>::controllabilities() {
+	for (size_t i = 0; i < this->objects_.size(); i++) {
+		this->controllability_[i] = this->calculateControllability(i);
+	}
+}
+
+template <class _valueType>
+inline float BatchCOP<_valueType>::outputObservability(size_t _id) const {
+	uint32_t firstOutput = this->firstOutput_[_id];
+	uint32_t lastOutput = this->firstOutput_[_id + 1];
+	const float* pinObservability = this->pinObservability_.data();
+	if (this->kinds_[_id] == LINE) {
+		if (this->testpoints_[_id] & OBSERVED) {
+			return 1.0;
+		}
+		if (firstOutput == lastOutput) {
+			return 0.0;
+		}
+		float toReturn = 1;
+		for (uint32_t k = firstOutput; k < lastOutput; k++) {
+			toReturn *= (1 - pinObservability[this->outputPins_[k]]);
+		}
+		return 1 - toReturn;
+	}
+	if (firstOutput == lastOutput) {
+		return 0.0;
+	}
+	return pinObservability[this->outputPins_[firstOutput]];
+}
+
+template <class _valueType>
+inline float BatchCOP<_valueType>::calculateObservability(size_t _id, float _output) const {
+	switch (this->kinds_[_id]) {
+	case LINE:
+		return _output;
+	case OBSERVE:
+		return 1.0;
+	case CONSTANT:
+		return 0.0;
+	default:
+		return this->pass(_id, (uint32_t)-1) * _output;
+	}
+}
+
+template <class _valueType>
+inline float BatchCOP<_valueType>::calculatePinObservability(size_t _id, uint32_t _pin, float _output) const {
+	switch (this->kinds_[_id]) {
+	case LINE:
+		if (this->testpoints_[_id] & (CONTROL_0 | CONTROL_1)) { //The input now feeds a constant.
+			return 0.0;
+		}
+		return _output; //An inversion testpoint feeds an inverter, which passes observability unchanged.
+	case OBSERVE:
+		return 1.0;
+	case CONSTANT:
+		return 0.0;
+	default:
+		return this->pass(_id, this->inputs_[_pin]) * _output;
+	}
+}
+
+template <class _valueType>
+void BatchCOP<_valueType>::observabilities() {
+	for (size_t i = this->objects_.size(); i-- > 0;) {
+		float output = this->outputObservability(i);
+		this->observability_[i] = this->calculateObservability(i, output);
+		for (uint32_t pin = this->firstInput_[i]; pin < this->firstInput_[i + 1]; pin++) {
+			this->pinObservability_[pin] = this->calculatePinObservability(i, pin, output);
+		}
+	}
+}
+
+template <class _valueType>
+void BatchCOP<_valueType>::store() const {
+	for (size_t i = 0; i < this->objects_.size(); i++) {
+		COP* cop = this->objects_[i];
+		cop->controllability(this->controllability_[i]);
+		if (this->firstInput_[i + 1] - this->firstInput_[i] <= 1) {
+			cop->observability(this->observability_[i]);
+		}
+	}
+}
+
+#endif
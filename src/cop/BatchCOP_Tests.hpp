@@ -0,0 +1,93 @@
+/**
+ * @file BatchCOP_Tests.hpp
+ * @author Spencer Millican (millican@auburn.edu)
+ * @version 0.1
+ * @date 2020-06-08
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#include <map>
+
+#include "gtest/gtest.h"
+#include "cop/BatchCOP.hpp"
+#include "parser/Parser.hpp"
+
+class BatchCOPTest : public ::testing::Test {
+public:
+	void SetUp() override {
+		this->c17 = this->parser.Parse("c17.bench");
+		this->cop.build(this->c17);
+		this->cop.calculate();
+	}
+
+	void TearDown() override {
+		delete this->c17;
+	}
+
+	Parser<COPLine<Value<bool>>, COPNode<Value<bool>>, Value<bool>> parser;
+	Circuit* c17;
+	BatchCOP<Value<bool>> cop;
+};
+
+//Every object and every pin has the value calculated by the COP object.
+TEST_F(BatchCOPTest, SameAsCOPTest) {
+	EXPECT_EQ(11 + 13 + 6, this->cop.size()); //Lines, nodes (with PIs and POs) and fan-outs.
+	for (size_t i = 0; i < this->cop.size(); i++) {
+		COP* object = this->cop.object(i);
+		EXPECT_EQ(object->controllability(), this->cop.controllability(i));
+		EXPECT_EQ(object->observability(), this->cop.observability(i));
+		std::pair<const uint32_t*, const uint32_t*> inputs = this->cop.inputs(i);
+		for (size_t pin = 0; inputs.first + pin != inputs.second; pin++) {
+			EXPECT_EQ(object->observability(this->cop.object(inputs.first[pin])), this->cop.observability(i, pin));
+		}
+	}
+}
+
+//Objects are in topological order.
+TEST_F(BatchCOPTest, OrderTest) {
+	for (size_t i = 0; i < this->cop.size(); i++) {
+		std::pair<const uint32_t*, const uint32_t*> inputs = this->cop.inputs(i);
+		for (const uint32_t* input = inputs.first; input != inputs.second; input++) {
+			EXPECT_LT(*input, i);
+		}
+	}
+}
+
+//Known values (see C17Test).
+TEST_F(BatchCOPTest, ValueTest) {
+	std::map<std::string, float> CC = { {"10", 0.75}, {"16", 0.625}, {"22", 0.53125}, {"23", 0.609375} };
+	std::map<std::string, float> CO = { {"1", 0.3125}, {"10", 0.625}, {"22", 1.0}, {"23", 1.0} };
+	size_t found = 0;
+	for (size_t i = 0; i < this->cop.size(); i++) {
+		if (this->cop.line(i) == false) {
+			continue;
+		}
+		std::string name = dynamic_cast<Connecting*>(this->cop.object(i))->name();
+		if (CC.count(name) != 0 && dynamic_cast<COPNode<Value<bool>>*>(*this->cop.object(i)->inputSpan().begin()) != nullptr) {
+			EXPECT_EQ(CC.at(name), this->cop.controllability(i));
+			found++;
+		}
+		if (CO.count(name) != 0 && dynamic_cast<COPNode<Value<bool>>*>(*this->cop.object(i)->inputSpan().begin()) != nullptr) {
+			EXPECT_EQ(CO.at(name), this->cop.observability(i));
+			found++;
+		}
+	}
+	EXPECT_EQ(CC.size() + CO.size(), found);
+}
+
+//Stored values are returned by COP objects (without calculating).
+TEST_F(BatchCOPTest, StoreTest) {
+	for (size_t i = 0; i < this->cop.size(); i++) {
+		this->cop.object(i)->controllability(-1.0f);
+		this->cop.object(i)->observability(-1.0f);
+	}
+	this->cop.store();
+	for (size_t i = 0; i < this->cop.size(); i++) {
+		if (this->cop.line(i)) {
+			EXPECT_EQ(this->cop.controllability(i), this->cop.object(i)->controllability());
+			EXPECT_EQ(this->cop.observability(i), this->cop.object(i)->observability());
+		}
+	}
+}
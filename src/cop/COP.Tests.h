@@ -1,3 +1,5 @@
 #pragma once
 
-#include"cop\COPStructures_Tests.hpp"
\ No newline at end of file
+#include"cop\COPStructures_Tests.hpp"
+#include "cop/BatchCOP_Tests.hpp"
+#include "cop/IncrementalCOP_Tests.hpp"
@@ -14,6 +14,7 @@
 
 #include "simulation/SimulationStructures.hpp"
 #include "simulation/ValueVectorFunctions.hpp"
+#include "timing/Counters.hpp"
 #include <cmath>
 
  /*
@@ -330,6 +331,7 @@ inline float COP::controllability() {
 		return this->controllability_;
 	}
 
+	COUNT(COP_CONTROLLABILITY_RECOMPUTES);
 	this->controllability_ = this->calculateControllability();
 	if (this->controllability_ < 0) {
 		throw "Cannot calculate COP CC: failure to calculate.";
@@ -349,12 +351,13 @@ inline float COP::observability(COP* _calling) {
 		return this->observability_;
 	}
 
+	COUNT(COP_OBSERVABILITY_RECOMPUTES);
 	float toReturn = this->calculateObservability(_calling);
 	if (toReturn < 0) {
 		throw "Cannot calculate COP CO: failure to calculate.";
 	}
 
-	if (this->inputs().size() <= 1) {//If an object has more than one input, it's returned observability may change depending on who's calling.
+	if (this->inputSpan().size() <= 1) {//If an object has more than one input, it's returned observability may change depending on who's calling.
 		//Otherwise, save the observability for later.
 		this->observability_ = toReturn;
 	}
@@ -371,12 +374,13 @@ inline void COP::clearObservability() {
 		return;
 	}
 	//DEBUG printf("DBG CO CLEAR %s (%d outputs) ... ", this->name().c_str(), this->outputs().size());//DEBUG
-	if (this->observability_ < 0 && this->inputs().size() <= 1) { //Already cleared (and should calculate).
+	if (this->observability_ < 0 && this->inputSpan().size() <= 1) { //Already cleared (and should calculate).
 		//DEBUG printf("STOP: %f %d\n", this->observability_, this->calculateAlways_);//DEBUG
 		return;
 	}
+	COUNT(COP_OBSERVABILITY_CLEARS);
 	this->observability_ = -1;
-	std::unordered_set<Connecting*> inputs = this->inputs();
+	ConnectingSpan inputs = this->inputSpan();
 	//DEBUG printf("DONE, forward to %d\n", inputs.size());
 	for (Connecting * input : inputs) {
 		COP* cast = dynamic_cast<COP*>(input);
@@ -400,15 +404,16 @@ inline void COP::clearControllability() {
 		return;
 	}
 	//DEBUG printf("DBG CC CLEAR %s (%d outputs)\n", this->name().c_str(), this->outputs().size());		//DEBUG
+	COUNT(COP_CONTROLLABILITY_CLEARS);
 	this->controllability_ = -1;
-	std::unordered_set<Connecting*> outputs = this->outputs();
+	ConnectingSpan outputs = this->outputSpan();
 	for (Connecting * output : outputs) {
 		COP* cast = dynamic_cast<COP*>(output);
 		cast->clearControllability();
 
 		//Change CC can change CO on "parallel" lines (e.g., the lines feeding the
 		//same gate).	 NOTE: see deleted segment below.
-		for (Connecting * possiblyParralInput : output->inputs()) {
+		for (Connecting * possiblyParralInput : output->inputSpan()) {
 			if (possiblyParralInput != this) {
 				COP* parallelInput = dynamic_cast<COP*>(possiblyParralInput);
 				parallelInput->clearObservability();
@@ -456,10 +461,10 @@ inline COPLine<_valueType>::COPLine(std::string _name) :
 }
 template<class _valueType>
 inline float COPLine<_valueType>::calculateControllability() {
-	if (this->inputs().size() != 1) {
+	if (this->inputSpan().size() != 1) {
 		throw "Cannot calculate COPLine controllability: need exactly 1 input.";
 	}
-	COP* cast = dynamic_cast<COP*>(*(this->inputs().begin()));
+	COP* cast = dynamic_cast<COP*>(this->inputSpan()[0]);
 	float toReturn = cast->controllability();
 	if (toReturn > 1 || toReturn < 0) {
 		throw "CO fail.";
@@ -469,12 +474,12 @@ inline float COPLine<_valueType>::calculateControllability() {
 
 template<class _valueType>
 inline float COPLine<_valueType>::calculateObservability(COP * _calling) {
-	if (this->outputs().size() == 0) {
+	if (this->outputSpan().size() == 0) {
 		return 0.0;
 		//DELETE: incorrect. throw "A line with no outputs cannot calculate its observability.";
 	}
 	float toReturn = 1;
-	for (Connecting* output : this->outputs()) {
+	for (Connecting* output : this->outputSpan()) {
 		COP* cast = dynamic_cast<COP*>(output);
 		float other = cast->observability(this);
 		toReturn *= (1 - other);
@@ -514,7 +519,7 @@ template<class _valueType>
 inline float manualCOP(COPNode<_valueType>* node, std::vector<float> inputControllabilities) {
 	Function<_valueType>* func = dynamic_cast<Function<_valueType>*>(node->function());
 	//TODO: what's the "initial" value?
-	std::vector<_valueType> nodeInputVals = std::vector<_valueType>(node->inputs().size(), _valueType(0xFFFFFFFFFFFFFFFF));
+	std::vector<_valueType> nodeInputVals = std::vector<_valueType>(node->inputSpan().size(), _valueType(0xFFFFFFFFFFFFFFFF));
 	ValueVectorFunction<_valueType>::increment(nodeInputVals);
 	float ret = 0.0;
 	do {
@@ -549,7 +554,7 @@ template<class _valueType>
 inline float COPNode<_valueType>::calculateControllability() {
 	//First, get the input controllabilities.
 	std::vector<float> inputControllabilities;
-	for (Connecting* input : this->inputs()) {
+	for (Connecting* input : this->inputSpan()) {
 		COP* cast = dynamic_cast<COP*>(input);
 		inputControllabilities.push_back(cast->controllability());
 	}
@@ -621,7 +626,7 @@ inline float COPNode<_valueType>::calculateObservability(COP * _calling) {
 	}
 	float pPass = 1.0;  //The probability that a signal will pass through the given gate.
 	if (this->name() == "and" || this->name() == "nand") {
-		for (Connecting* input : this->inputs()) {
+		for (Connecting* input : this->inputSpan()) {
 			if (input == _calling) {
 				continue;
 			}
@@ -630,7 +635,7 @@ inline float COPNode<_valueType>::calculateObservability(COP * _calling) {
 		}
 	}
 	else if (this->name() == "or" || this->name() == "nor") {
-		for (Connecting* input : this->inputs()) {
+		for (Connecting* input : this->inputSpan()) {
 			if (input == _calling) {
 				continue;
 			}
@@ -641,7 +646,7 @@ inline float COPNode<_valueType>::calculateObservability(COP * _calling) {
 
 
 
-	COP* outputLine = dynamic_cast<COP*>(*(this->outputs().begin()));
+	COP* outputLine = dynamic_cast<COP*>(this->outputSpan()[0]);
 	float outputObservability = outputLine->observability(this);
 	float toReturn = pPass * outputObservability;
 	if (toReturn < 0 || toReturn > 1) {
@@ -0,0 +1,413 @@
+/**
+ * @file IncrementalCOP.hpp
+ * @author Spencer Millican (millican@auburn.edu)
+ * @version 0.1
+ * @date 2020-06-10
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#ifndef IncrementalCOP_h
+#define IncrementalCOP_h
+
+#include <queue>
+#include <vector>
+#include <functional>
+#include <cmath>
+#include <algorithm>
+
+#include "cop/BatchCOP.hpp"
+
+/*
+ * Batch COP which is updated incrementally when testpoints are added to Lines.
+ *
+ * A testpoint changes the values of a Line as if it was inserted into the
+ * circuit (see Testpoint_control, Testpoint_observe and Testpoint_invert):
+ *   - control: the Line's controllability is the forced value and the Line's
+ *     input is no longer observed through it (it feeds a constant).
+ *   - invert: the Line's controllability is inverted.
+ *   - observe: the Line's observability is 1.
+ * The circuit itself is not changed.
+ *
+ * Changed objects are put on worklists. Controllability is recalculated
+ * forward (in id order) only through objects whose inputs changed, and then
+ * observability is recalculated backward (in reverse id order) only through
+ * objects whose outputs, or whose sibling inputs, changed. A value which does
+ * not change by more than "epsilon" (by default, 0) is not changed or
+ * propagated.
+ *
+ * Every change is journaled, so changes (e.g., evaluating a testpoint) can be
+ * rolled back to a checkpoint.
+ *
+ * @param _valueType The type of value being simulated, e.g., Value/FaultyValue
+ */
+template <class _valueType>
+class IncrementalCOP : public BatchCOP<_valueType> {
+public:
+	/*
+	 * A value changed since a checkpoint (see "changes").
+	 */
+	struct Change {
+		/*
+		 * The id of the object.
+		 */
+		uint32_t id;
+
+		/*
+		 * The values of the object at the checkpoint.
+		 */
+		float controllability;
+		float observability;
+	};
+
+	/*
+	 * Create an empty calculator (see "build").
+	 */
+	IncrementalCOP() : epsilon_(0.0) {}
+
+	/*
+	 * Create the calculator for a given circuit and calculate COP.
+	 *
+	 * @param _circuit The circuit (all objects must be COP objects).
+	 */
+	IncrementalCOP(Circuit* _circuit) : epsilon_(0.0) {
+		this->build(_circuit);
+		this->calculate();
+	}
+
+	/*
+	 * Flatten a circuit (without calculating COP). All testpoints and the
+	 * journal are cleared.
+	 *
+	 * @param _circuit The circuit to flatten.
+	 */
+	void build(Circuit* _circuit);
+
+	/*
+	 * Calculate all values (with all testpoints) at once, instead of updating
+	 * them. The journal is not changed.
+	 */
+	void calculate() {
+		this->BatchCOP<_valueType>::calculate();
+		this->forward_ = decltype(this->forward_)();
+		this->backward_ = decltype(this->backward_)();
+		std::fill(this->queued_.begin(), this->queued_.end(), 0);
+	}
+
+	/*
+	 * Set how much a value must change to be changed (and propagated).
+	 *
+	 * @param _epsilon The smallest change.
+	 */
+	void epsilon(float _epsilon) {
+		this->epsilon_ = _epsilon;
+	}
+
+	/*
+	 * Add a control testpoint to a Line (replacing any control or inversion).
+	 *
+	 * Call "update" to update values.
+	 *
+	 * @param _id The id of the Line.
+	 * @param _value The value forced by the testpoint.
+	 */
+	void control(size_t _id, bool _value) {
+		uint8_t testpoints = this->testpoints_[this->location(_id)];
+		testpoints &= ~(BatchCOP<_valueType>::CONTROL_0 | BatchCOP<_valueType>::CONTROL_1 | BatchCOP<_valueType>::INVERT);
+		testpoints |= _value ? BatchCOP<_valueType>::CONTROL_1 : BatchCOP<_valueType>::CONTROL_0;
+		this->testpoint(_id, testpoints);
+	}
+
+	/*
+	 * Add an inversion testpoint to a Line (a control testpoint's value is
+	 * inverted, and an inversion is removed).
+	 *
+	 * Call "update" to update values.
+	 *
+	 * @param _id The id of the Line.
+	 */
+	void invert(size_t _id) {
+		uint8_t testpoints = this->testpoints_[this->location(_id)];
+		if (testpoints & (BatchCOP<_valueType>::CONTROL_0 | BatchCOP<_valueType>::CONTROL_1)) {
+			testpoints ^= BatchCOP<_valueType>::CONTROL_0 | BatchCOP<_valueType>::CONTROL_1;
+		} else {
+			testpoints ^= BatchCOP<_valueType>::INVERT;
+		}
+		this->testpoint(_id, testpoints);
+	}
+
+	/*
+	 * Add an observe testpoint to a Line.
+	 *
+	 * Call "update" to update values.
+	 *
+	 * @param _id The id of the Line.
+	 */
+	void observe(size_t _id) {
+		this->testpoint(_id, this->testpoints_[this->location(_id)] | BatchCOP<_valueType>::OBSERVED);
+	}
+
+	/*
+	 * Update all values affected by testpoints added since the last update.
+	 */
+	void update();
+
+	/*
+	 * The current checkpoint (to roll back to).
+	 *
+	 * @return The checkpoint.
+	 */
+	size_t checkpoint() const {
+		return this->journal_.size();
+	}
+
+	/*
+	 * Undo all changes (testpoints and values) made since a checkpoint.
+	 *
+	 * @param _checkpoint The checkpoint.
+	 */
+	void rollback(size_t _checkpoint);
+
+	/*
+	 * Forget all changes (they can no longer be rolled back).
+	 */
+	void commit() {
+		this->journal_.clear();
+	}
+
+	/*
+	 * The objects whose controllability or observability changed since a
+	 * checkpoint (each once), with their values at the checkpoint.
+	 *
+	 * @param _checkpoint The checkpoint.
+	 * @return The changed objects.
+	 */
+	const std::vector<Change> & changes(size_t _checkpoint);
+
+private:
+	/*
+	 * A journaled (previous) value.
+	 */
+	struct Entry {
+		enum What : uint8_t { CONTROLLABILITY, OBSERVABILITY, PIN, TESTPOINTS };
+		uint8_t what;
+		uint32_t index;
+		float value;
+	};
+
+	/*
+	 * The smallest change.
+	 */
+	float epsilon_;
+
+	/*
+	 * The object of every pin.
+	 */
+	std::vector<uint32_t> pinObjects_;
+
+	/*
+	 * Objects whose controllability (forward, smallest id first) and
+	 * observability (backward, largest id first) must be recalculated.
+	 */
+	std::priority_queue<uint32_t, std::vector<uint32_t>, std::greater<uint32_t>> forward_;
+	std::priority_queue<uint32_t> backward_;
+
+	/*
+	 * Is an object on the forward/backward worklist?
+	 */
+	std::vector<uint8_t> queued_;
+
+	/*
+	 * Previous values (in the order they were changed).
+	 */
+	std::vector<Entry> journal_;
+
+	/*
+	 * The last changes found, when each object was last found (the search
+	 * number) and where.
+	 */
+	std::vector<Change> changes_;
+	std::vector<size_t> found_;
+	std::vector<uint32_t> positions_;
+	size_t search_;
+
+	/*
+	 * Check an object is a Line (testpoints can only be added to Lines).
+	 *
+	 * @param _id The id of the object.
+	 * @return The id.
+	 */
+	size_t location(size_t _id) const {
+		if (this->kinds_[_id] != BatchCOP<_valueType>::LINE) {
+			throw "Cannot add an incremental COP testpoint: the location is not a Line.";
+		}
+		return _id;
+	}
+
+	/*
+	 * Change the testpoints of a Line and queue it.
+	 *
+	 * @param _id The id of the Line.
+	 * @param _testpoints The new testpoints.
+	 */
+	void testpoint(size_t _id, uint8_t _testpoints);
+
+	/*
+	 * Queue an object (if not already queued).
+	 *
+	 * @param _id The id of the object.
+	 * @param _forward Queue for controllability (else observability).
+	 */
+	void queue(uint32_t _id, bool _forward) {
+		uint8_t flag = _forward ? 1 : 2;
+		if ((this->queued_[_id] & flag) == 0) {
+			this->queued_[_id] |= flag;
+			if (_forward) {
+				this->forward_.push(_id);
+			} else {
+				this->backward_.push(_id);
+			}
+		}
+	}
+
+	/*
+	 * Has a value changed (by more than epsilon)?
+	 *
+	 * @param _old The old value.
+	 * @param _new The new value.
+	 * @return True if changed.
+	 */
+	bool changed(float _old, float _new) const {
+		return std::fabs(_new - _old) > this->epsilon_;
+	}
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Inline function declarations.
+////////////////////////////////////////////////////////////////////////////////
+
+template <class _valueType>
+void IncrementalCOP<_valueType>::build(Circuit* _circuit) {
+	this->BatchCOP<_valueType>::build(_circuit);
+	this->pinObjects_.assign(this->inputs_.size(), 0);
+	for (size_t i = 0; i < this->size(); i++) {
+		for (uint32_t pin = this->firstInput_[i]; pin < this->firstInput_[i + 1]; pin++) {
+			this->pinObjects_[pin] = (uint32_t)i;
+		}
+	}
+	this->forward_ = decltype(this->forward_)();
+	this->backward_ = decltype(this->backward_)();
+	this->queued_.assign(this->size(), 0);
+	this->journal_.clear();
+	this->changes_.clear();
+	this->found_.assign(this->size(), 0);
+	this->positions_.assign(this->size(), 0);
+	this->search_ = 0;
+}
+
+template <class _valueType>
+void IncrementalCOP<_valueType>::testpoint(size_t _id, uint8_t _testpoints) {
+	uint8_t old = this->testpoints_[_id];
+	if (old == _testpoints) {
+		return;
+	}
+	this->journal_.push_back({ Entry::TESTPOINTS, (uint32_t)_id, (float)old });
+	this->testpoints_[_id] = _testpoints;
+	this->queue((uint32_t)_id, true);
+	this->queue((uint32_t)_id, false);
+}
+
+template <class _valueType>
+void IncrementalCOP<_valueType>::update() {
+	//Controllability: through the fan-out of changed objects.
+	while (this->forward_.empty() == false) {
+		uint32_t id = this->forward_.top();
+		this->forward_.pop();
+		this->queued_[id] &= ~1;
+		float controllability = this->calculateControllability(id);
+		if (this->changed(this->controllability_[id], controllability) == false) {
+			continue;
+		}
+		this->journal_.push_back({ Entry::CONTROLLABILITY, id, this->controllability_[id] });
+		this->controllability_[id] = controllability;
+		for (uint32_t k = this->firstOutput_[id]; k < this->firstOutput_[id + 1]; k++) {
+			uint32_t output = this->pinObjects_[this->outputPins_[k]];
+			this->queue(output, true);
+			this->queue(output, false); //Its other inputs are observed differently.
+		}
+	}
+
+	//Observability: through the fan-in of changed objects.
+	while (this->backward_.empty() == false) {
+		uint32_t id = this->backward_.top();
+		this->backward_.pop();
+		this->queued_[id] &= ~2;
+		float output = this->outputObservability(id);
+		float observability = this->calculateObservability(id, output);
+		if (this->changed(this->observability_[id], observability)) {
+			this->journal_.push_back({ Entry::OBSERVABILITY, id, this->observability_[id] });
+			this->observability_[id] = observability;
+		}
+		for (uint32_t pin = this->firstInput_[id]; pin < this->firstInput_[id + 1]; pin++) {
+			float pinObservability = this->calculatePinObservability(id, pin, output);
+			if (this->changed(this->pinObservability_[pin], pinObservability)) {
+				this->journal_.push_back({ Entry::PIN, pin, this->pinObservability_[pin] });
+				this->pinObservability_[pin] = pinObservability;
+				this->queue(this->inputs_[pin], false);
+			}
+		}
+	}
+}
+
+template <class _valueType>
+void IncrementalCOP<_valueType>::rollback(size_t _checkpoint) {
+	if (this->forward_.empty() == false || this->backward_.empty() == false) {
+		throw "Cannot roll back incremental COP: it has not been updated.";
+	}
+	while (this->journal_.size() > _checkpoint) {
+		const Entry & entry = this->journal_.back();
+		switch (entry.what) {
+		case Entry::CONTROLLABILITY:
+			this->controllability_[entry.index] = entry.value;
+			break;
+		case Entry::OBSERVABILITY:
+			this->observability_[entry.index] = entry.value;
+			break;
+		case Entry::PIN:
+			this->pinObservability_[entry.index] = entry.value;
+			break;
+		default:
+			this->testpoints_[entry.index] = (uint8_t)entry.value;
+		}
+		this->journal_.pop_back();
+	}
+}
+
+template <class _valueType>
+const std::vector<typename IncrementalCOP<_valueType>::Change> & IncrementalCOP<_valueType>::changes(size_t _checkpoint) {
+	this->changes_.clear();
+	this->search_++;
+	//Backward, so the last value written is the first value journaled (the value at the checkpoint).
+	for (size_t i = this->journal_.size(); i-- > _checkpoint;) {
+		const Entry & entry = this->journal_[i];
+		if (entry.what != Entry::CONTROLLABILITY && entry.what != Entry::OBSERVABILITY) {
+			continue;
+		}
+		uint32_t id = entry.index;
+		if (this->found_[id] != this->search_) {
+			this->found_[id] = this->search_;
+			this->positions_[id] = (uint32_t)this->changes_.size();
+			this->changes_.push_back({ id, this->controllability_[id], this->observability_[id] });
+		}
+		Change & change = this->changes_[this->positions_[id]];
+		if (entry.what == Entry::CONTROLLABILITY) {
+			change.controllability = entry.value;
+		} else {
+			change.observability = entry.value;
+		}
+	}
+	return this->changes_;
+}
+
+#endif
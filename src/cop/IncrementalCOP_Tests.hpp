@@ -0,0 +1,143 @@
+/**
+ * @file IncrementalCOP_Tests.hpp
+ * @author Spencer Millican (millican@auburn.edu)
+ * @version 0.1
+ * @date 2020-06-10
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "cop/IncrementalCOP.hpp"
+#include "parser/Parser.hpp"
+
+class IncrementalCOPTest : public ::testing::Test {
+public:
+	void SetUp() override {
+		this->c17 = this->parser.Parse("c17.bench");
+		this->cop.build(this->c17);
+		this->cop.calculate();
+		for (size_t i = 0; i < this->cop.size(); i++) {
+			if (this->cop.line(i)) {
+				this->lines.push_back(i);
+			}
+		}
+	}
+
+	void TearDown() override {
+		delete this->c17;
+	}
+
+	//Are all values the same as those of another calculation?
+	void expectSame(const BatchCOP<Value<bool>> & _other) {
+		for (size_t i = 0; i < this->cop.size(); i++) {
+			EXPECT_EQ(_other.controllability(i), this->cop.controllability(i));
+			EXPECT_EQ(_other.observability(i), this->cop.observability(i));
+			std::pair<const uint32_t*, const uint32_t*> inputs = this->cop.inputs(i);
+			for (size_t pin = 0; inputs.first + pin != inputs.second; pin++) {
+				EXPECT_EQ(_other.observability(i, pin), this->cop.observability(i, pin));
+			}
+		}
+	}
+
+	Parser<COPLine<Value<bool>>, COPNode<Value<bool>>, Value<bool>> parser;
+	Circuit* c17;
+	IncrementalCOP<Value<bool>> cop;
+	std::vector<size_t> lines;
+};
+
+//Testpoints change the values of their Line.
+TEST_F(IncrementalCOPTest, TestpointTest) {
+	for (size_t line : this->lines) {
+		size_t checkpoint = this->cop.checkpoint();
+		float controllability = this->cop.controllability(line);
+
+		this->cop.control(line, true);
+		this->cop.update();
+		EXPECT_EQ(1.0, this->cop.controllability(line));
+		EXPECT_EQ(0.0, this->cop.observability(line, 0)); //The input feeds a constant.
+
+		this->cop.control(line, false);
+		this->cop.update();
+		EXPECT_EQ(0.0, this->cop.controllability(line));
+
+		this->cop.invert(line); //Control-0 becomes control-1.
+		this->cop.update();
+		EXPECT_EQ(1.0, this->cop.controllability(line));
+		this->cop.rollback(checkpoint);
+
+		this->cop.invert(line);
+		this->cop.update();
+		EXPECT_EQ(1 - controllability, this->cop.controllability(line));
+		EXPECT_FLOAT_EQ(this->cop.observability(line), this->cop.observability(line, 0)); //Through the inverter.
+
+		this->cop.observe(line);
+		this->cop.update();
+		EXPECT_EQ(1.0, this->cop.observability(line));
+		this->cop.rollback(checkpoint);
+	}
+}
+
+//Incremental updates calculate the same values as calculating everything.
+TEST_F(IncrementalCOPTest, SameAsBatchTest) {
+	IncrementalCOP<Value<bool>> other(this->c17);
+	for (size_t i = 0; i < this->lines.size(); i++) {
+		size_t line = this->lines.at(i);
+		switch (i % 3) {
+		case 0: this->cop.control(line, i % 2 == 0); other.control(line, i % 2 == 0); break;
+		case 1: this->cop.observe(line); other.observe(line); break;
+		default: this->cop.invert(line); other.invert(line);
+		}
+		this->cop.update();
+		other.calculate();
+		expectSame(other);
+	}
+}
+
+//Rolling back restores all values and testpoints.
+TEST_F(IncrementalCOPTest, RollbackTest) {
+	BatchCOP<Value<bool>> original(this->c17);
+	size_t checkpoint = this->cop.checkpoint();
+	for (size_t line : this->lines) {
+		this->cop.control(line, false);
+		this->cop.observe(line);
+		this->cop.update();
+	}
+	EXPECT_NE(0, this->cop.changes(checkpoint).size());
+	this->cop.rollback(checkpoint);
+	expectSame(original);
+	EXPECT_EQ(0, this->cop.changes(checkpoint).size());
+	this->cop.calculate(); //No testpoints remain.
+	expectSame(original);
+}
+
+//Changes hold the values at the checkpoint (once per object).
+TEST_F(IncrementalCOPTest, ChangesTest) {
+	std::vector<float> controllability;
+	std::vector<float> observability;
+	for (size_t i = 0; i < this->cop.size(); i++) {
+		controllability.push_back(this->cop.controllability(i));
+		observability.push_back(this->cop.observability(i));
+	}
+	size_t checkpoint = this->cop.checkpoint();
+	this->cop.control(this->lines.front(), true);
+	this->cop.update();
+	this->cop.observe(this->lines.back());
+	this->cop.update();
+	std::vector<bool> found(this->cop.size(), false);
+	for (const IncrementalCOP<Value<bool>>::Change & change : this->cop.changes(checkpoint)) {
+		EXPECT_FALSE(found.at(change.id));
+		found.at(change.id) = true;
+		EXPECT_EQ(controllability.at(change.id), change.controllability);
+		EXPECT_EQ(observability.at(change.id), change.observability);
+	}
+	for (size_t i = 0; i < this->cop.size(); i++) {
+		if (found.at(i) == false) {
+			EXPECT_EQ(controllability.at(i), this->cop.controllability(i));
+			EXPECT_EQ(observability.at(i), this->cop.observability(i));
+		}
+	}
+}
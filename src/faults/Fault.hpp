@@ -391,7 +391,7 @@ inline std::vector<Event<_valueType>> Fault<_valueType>::go() {
 
 	if (forwardUpdateCall == true) { //The value changed, and therefore we need to return outputs which (may) need to be re-evaluated.
 		std::vector<Event<_valueType>> toReturn;
-		for (Connecting* output : this->location_->outputs()) {
+		for (Connecting* output : this->location_->outputSpan()) {
 			Evented<_valueType>* cast = dynamic_cast<Evented<_valueType>*>(output);
 			size_t eventLevel = cast->inputLevel();
 			toReturn.push_back(
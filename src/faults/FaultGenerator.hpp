@@ -18,6 +18,7 @@
 #include "Circuit.h"
 #include "simulation/SimulationStructures.hpp"
 #include "faults/FaultStructures.hpp"
+#include "timing/Trace.hpp"
 
 /*
  * An object capible of populating a list of faults for a Circuit.
@@ -70,6 +71,8 @@ private:
 
 template <class _valueType>
 inline std::unordered_set<Fault<_valueType>*> FaultGenerator<_valueType>::allFaults(Circuit * _circuit, bool _checkpointReduce) {
+	TraceSpan span("generate faults", "faults");
+	span.arg("checkpoints", _checkpointReduce);
 	std::unordered_set<Fault<_valueType>*> toReturn;
 	std::unordered_set<FaultyLine<_valueType>*> circuitCheckpoints; //Lines where faults are generated
 	if (_checkpointReduce == true) {
@@ -77,11 +80,11 @@ inline std::unordered_set<Fault<_valueType>*> FaultGenerator<_valueType>::allFau
 	}
 	else {
 		for (Levelized* node : _circuit->nodes()) {
-			for (Connecting* line : node->inputs()) {
+			for (Connecting* line : node->inputSpan()) {
 				FaultyLine<_valueType>* cast = dynamic_cast<FaultyLine<_valueType>*>(line);
 				circuitCheckpoints.emplace(cast);
 			}
-			for (Connecting* line : node->outputs()) {
+			for (Connecting* line : node->outputSpan()) {
 				FaultyLine<_valueType>* cast = dynamic_cast<FaultyLine<_valueType>*>(line);
 				circuitCheckpoints.emplace(cast);
 			}
@@ -93,6 +96,7 @@ inline std::unordered_set<Fault<_valueType>*> FaultGenerator<_valueType>::allFau
 		toReturn.emplace(sa0);
 		toReturn.emplace(sa1);
 	}
+	span.arg("faults", toReturn.size());
 	return toReturn;
 
 }
@@ -104,10 +108,10 @@ inline std::unordered_set<FaultyLine<_valueType>*> FaultGenerator<_valueType>::c
 	//Step 1: get all the PI lines and fanout lines.
 	std::unordered_map<Connecting*, bool> visited; //Mapps lines to visited. This allows lines to not have the "Tracable" attribute.
 	for (Levelized* pi : _circuit->pis()) {
-		if (pi->outputs().size() != 1) {
+		if (pi->outputSpan().size() != 1) {
 			throw "Problem: a PI in the circuit does not have an output line.";
 		}
-		Connecting* piLine = *(pi->outputs().begin());
+		Connecting* piLine = pi->outputSpan()[0];
 		preCastToReturn.emplace(piLine);
 		std::unordered_set<Connecting*> toAdd = fanouts(piLine, visited);
 		preCastToReturn.insert(toAdd.begin(), toAdd.end());
@@ -136,18 +140,18 @@ inline std::unordered_set<Connecting*> FaultGenerator<_valueType>::fanouts(Conne
 	_visited[_base] = true;
 
 	//Case 1: we reached the end.
-	if (_base->outputs().size() == 0) {
+	if (_base->outputSpan().size() == 0) {
 		return std::unordered_set<Connecting*>();
 	}
 
 	//Case 2: we have a single output
-	if (_base->outputs().size() == 1) {
-		return fanouts(*(_base->outputs().begin()), _visited);
+	if (_base->outputSpan().size() == 1) {
+		return fanouts(_base->outputSpan()[0], _visited);
 	}
 
 	//Case 3: we have multiple outputs (and hence outputs)
 	std::unordered_set<Connecting*> toReturn = _base->outputs();
-	for (Connecting* output : _base->outputs()) {
+	for (Connecting* output : _base->outputSpan()) {
 		std::unordered_set<Connecting*> toAdd = fanouts(output, _visited);
 		toReturn.insert(toAdd.begin(), toAdd.end());
 	}
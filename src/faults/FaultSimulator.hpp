@@ -16,6 +16,7 @@
 #include "faults/Fault.hpp"
 #include "simulation/Simulator.hpp"
 #include "faults/FaultyValue.hpp"
+#include "timing/Counters.hpp"
 
  /*
   * A Simulator capible of performing fault simulation.
@@ -271,9 +272,11 @@ inline std::vector<_valueType> FaultSimulator<_valueType>::applyStimulus(
 	for (Fault<_valueType>* fault : faultsToSimulate) {
 		std::vector<Event<_valueType>> faultActivationEvents = fault->go(); //Activate the fault
 		if (fault->location()->value().faulty()) { //There is at least one faulty bit at the location.
+			COUNT(FAULT_ACTIVATIONS);
 			_simulationQueue.add(faultActivationEvents); 
 			_simulationQueue.process();
 		} else {
+			COUNT(FAULT_EARLY_DROPS);
 			fault->go(); //Imediately deactivate and continue to the next fault: there's no point in simulating.
 			continue;
 		}
@@ -282,6 +285,7 @@ inline std::vector<_valueType> FaultSimulator<_valueType>::applyStimulus(
 
 		for (_valueType &val : faultyOutputs) {
 			if (val.faulty() && val.faulty()) { //Detected
+				COUNT(FAULT_DETECTIONS);
 				this->undetectedFaults_.erase(fault);
 				this->detectedFaults_.emplace(fault);
 				break;
@@ -1,6 +1,6 @@
 #include "parser/Parser.hpp"
 #include "faults/FaultGenerator.hpp"
-#include "tpi/TPGenerator.hpp"
+#include "tpi/TPCandidates.hpp"
 #include "faults/FaultSimulator.hpp"
 #include "tpi/TestPoint.hpp"
 #include "tpi/Testpoint_control.hpp"
@@ -17,43 +17,159 @@
 #include "tpi/tpi_power.hpp"
 
 #include "window/Window.hpp"
+#include "parser/Glob.hpp"
+#include "timing/Timing.hpp"
+#include "timing/Counters.hpp"
+#include "timing/Trace.hpp"
 #include <vector>
 #include <set>
 #include <iostream>
 #include <ctime>
+#include <chrono>
+#include <atomic>
+#include <map>
+#include <fstream>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 
 //General settings.
 #define PRIMITIVE unsigned long long int   //The underlying data primitive used for simulation.
 #define SIZEOFPRIMITIVE 64   //I.e., 64 for unsigned long long int, 1 for bool
 
-//TPI Settings
-#define TPITIMELIMIT 108000   //The time limit for TPI, in seconds, i.e., 3600 -> 1 hour
-#define TPLIMIT 0.01   //The TP limit in terms of a percentage of nodes,s, i.e., 0.01 -> 1%
-#define PRETPIVEC 10   //Number of vectors to apply before TPI (to eleminate easy-to-detect faults from the TPI algorithm).
-
-//For fault simulation
-
-#define MAXVEC 16384   //The maximum total number of vectors to simulate across ALL iterations. I.e., 64*128=16384
-//-> NOTE: the total number of vectors to simulate per benchmark will always be less than this number.
-//-> NOTE: the simulation primitive size ("SIZEOFPRIMITIVE") is accounted for, so do not adjust this number based on the primitive size.
-//--> E.g., if "unsigned long long int" is used (and thus "SIZEOFPRIMITIVE" is 64), and "MAXVEC" is 128, two 64-bit vectors will be applied automatically.
-
-#define MAXITER 128 //The maximum number of fault simulations to perform (the average fault coverage is taken).
-//-> E.g., if "1" is given, a single fault simulation will be performed.
-//-> E.g., if "2" is given, two fault simulations will be performed and the average of the two fault coverages will be printed.
-
 #define MAXFAULTCOVERAGE 99.0 //If no fault coverage limit is given, fault simulation will be performed until this fault coverage is obtained by at least one circuit.
 //-> I.e., 99.0 = 99% 
 //-> NOTE: in practice, this will be overwritten to 100% (no limit) or a specific limit.
 
-#define SIMTIMELIMIT 1000 //The time, in seconds, to limit fault simulation to.
-//-> I.e., 1000 -> one thousand seconds
-//NOTE: this is more powerful than setting other limits (i.e., "MAXVEC" and "MAXITER"). This allows you to gather as much data as you can, time allowed.
+/*
+ * Run settings (TPI and fault simulation limits).
+ *
+ * The defaults given here may be overwritten by a config file and then by
+ * command-line flags (see "printUsage"). The key of each setting is given in
+ * brackets: "[max-vec]" is set by the config file line "max-vec = 100" or by the
+ * flag "--max-vec 100".
+ *
+ * NOTE: Settings are only changed by "main" before any benchmark is evaluated,
+ *       so concurrent evaluations may read them freely.
+ */
+struct Settings {
+	//TPI Settings
+	size_t tpiTimeLimit = 108000;   //[tpi-time-limit] The time limit for TPI, in seconds, i.e., 3600 -> 1 hour
+	double tpLimit = 0.01;   //[tp-limit] The TP limit in terms of a percentage of nodes,s, i.e., 0.01 -> 1%
+	size_t preTpiVec = 10;   //[pre-tpi-vec] Number of vectors to apply before TPI (to eleminate easy-to-detect faults from the TPI algorithm).
+	size_t lazyTpi = 0;   //[lazy-tpi] If 1, TPs are selected lazily (see TPI::lazy), else all TPs are re-evaluated every round.
+	size_t tpiBatch = 1;   //[tpi-batch] The most TPs inserted every round (see TPI::batch), i.e., 1 -> one TP at a time.
+	double tpiOverlap = 0.0;   //[tpi-overlap] The largest fraction of a TP's impact which may overlap other TPs inserted in the same round, i.e., 0 -> disjoint.
+	double tpiPower = 0.0;   //[tpi-power] The weight of the power metric in TP quality (see TPI_COP::power), i.e., 0 -> fault coverage only.
+	size_t tpiCompare = 0;   //[tpi-compare] If 1, TPs are also selected one at a time (not lazily, one TP per round) and both selections are reported (see "CompareColumns").
+
+	//For fault simulation
+
+	size_t maxVec = 16384;   //[max-vec] The maximum total number of vectors to simulate across ALL iterations. I.e., 64*128=16384
+	//-> NOTE: the total number of vectors to simulate per benchmark will always be less than this number.
+	//-> NOTE: the simulation primitive size ("SIZEOFPRIMITIVE") is accounted for, so do not adjust this number based on the primitive size.
+	//--> E.g., if "unsigned long long int" is used (and thus "SIZEOFPRIMITIVE" is 64), and "maxVec" is 128, two 64-bit vectors will be applied automatically.
+
+	size_t maxIter = 128; //[max-iter] The maximum number of fault simulations to perform (the average fault coverage is taken).
+	//-> E.g., if "1" is given, a single fault simulation will be performed.
+	//-> E.g., if "2" is given, two fault simulations will be performed and the average of the two fault coverages will be printed.
+
+	size_t simTimeLimit = 1000; //[sim-time-limit] The time, in seconds, to limit fault simulation to.
+	//-> I.e., 1000 -> one thousand seconds
+	//NOTE: this is more powerful than setting other limits (i.e., "maxVec" and "maxIter"). This allows you to gather as much data as you can, time allowed.
+
+	size_t tpRatio = 2; //[tp-ratio] If testpoints are given for fault simulation, what fraction of vectors will TPs be enabled for.
+	//-> I.e., 2 -> 1/2 of all vectors.
+};
 
-#define TPRATIO 2 //If testpoints are given for fault simulation, what fraction of vectors will TPs be enabled for.
-//-> I.e., 2 -> 1/2 of all vectors.
+Settings settings;
+
+bool cacheNetlists = true; //Cache parsed benchmarks (see Parser::cache), unless "--no-cache" is given.
+
+/*
+ * Set a single setting from its key (see "Settings") and its value as text.
+ *
+ * An exception will be thrown if the value is not a valid number.
+ *
+ * @param _key The key of the setting, e.g., "max-vec".
+ * @param _value The new value of the setting.
+ * @return False if the key is not a known setting.
+ */
+bool setSetting(std::string _key, std::string _value) {
+	try {
+		size_t end = 0;
+		if (_key == "tp-limit") {
+			settings.tpLimit = std::stod(_value, &end);
+		} else if (_key == "tpi-overlap") {
+			settings.tpiOverlap = std::stod(_value, &end);
+		} else if (_key == "tpi-power") {
+			settings.tpiPower = std::stod(_value, &end);
+		} else {
+			unsigned long long int number = std::stoull(_value, &end);
+			if (_key == "tpi-time-limit") { settings.tpiTimeLimit = number; }
+			else if (_key == "pre-tpi-vec") { settings.preTpiVec = number; }
+			else if (_key == "lazy-tpi") { settings.lazyTpi = number; }
+			else if (_key == "tpi-batch") { settings.tpiBatch = number; }
+			else if (_key == "tpi-compare") { settings.tpiCompare = number; }
+			else if (_key == "max-vec") { settings.maxVec = number; }
+			else if (_key == "max-iter") { settings.maxIter = number; }
+			else if (_key == "sim-time-limit") { settings.simTimeLimit = number; }
+			else if (_key == "tp-ratio") { settings.tpRatio = number; }
+			else { return false; }
+		}
+		if (end != _value.size()) {
+			throw "Invalid setting value.";
+		}
+	} catch (std::exception&) { //Thrown by std::stod/stoull
+		throw "Invalid setting value.";
+	}
+	if (settings.tpRatio == 0) {
+		throw "The TP ratio must be greater than 0.";
+	}
+	return true;
+}
+
+//Remove leading and trailing whitespace.
+std::string trim(std::string _string) {
+	size_t first = _string.find_first_not_of(" \t\r\n");
+	if (first == std::string::npos) {
+		return "";
+	}
+	size_t last = _string.find_last_not_of(" \t\r\n");
+	return _string.substr(first, last - first + 1);
+}
 
+/*
+ * Read settings from a config file.
+ *
+ * Each line of the file is either empty, a comment (starting with "#"), or
+ * "key = value" (see "Settings" for keys).
+ *
+ * An exception will be thrown if the file cannot be read or a line is invalid.
+ *
+ * @param _filePath The config file to read.
+ */
+void readSettings(std::string _filePath) {
+	std::ifstream file(_filePath);
+	if (file.is_open() == false) {
+		throw "Failed to open config file.";
+	}
+	std::string line;
+	while (std::getline(file, line)) {
+		line = trim(line.substr(0, line.find('#')));
+		if (line.empty()) {
+			continue;
+		}
+		size_t equals = line.find('=');
+		if (equals == std::string::npos) {
+			throw "Config file lines must be 'key = value'.";
+		}
+		if (setSetting(trim(line.substr(0, equals)), trim(line.substr(equals + 1))) == false) {
+			throw "Unknown setting in config file.";
+		}
+	}
+}
 
 //Convenience: this are for easier code later on.
 #define VALUETYPE FaultyValue<PRIMITIVE>
@@ -65,35 +181,35 @@
 #define GENERIC_TESTPOINT Testpoint<NODETYPE, LINETYPE, VALUETYPE>
 #define FAULTTYPE Fault<VALUETYPE>
 
-//Input benchmarks
-std::vector<std::string> Circuitfiles = {
-		"c17.bench",
-		"c432.bench",
-		"c499.bench",
-		"c880.bench",
-		"c1355.bench",
-		"c1908.bench",
-		"c2670.bench",
-		"c3540.bench",
-		"c5315.p.bench",
-		"c6288.p.bench",
-		"c7552.p.bench",
-		"b01.p.bench",
-		"b02.p.bench",
-		"b03.p.bench",
-		"b04.p.bench",
-		"b05.p.bench",
-		"b06.p.bench",
-		"b07.p.bench",
-		"b08.p.bench",
-		"b09.p.bench",
-		"b10.p.bench",
-		"b11.p.bench",
-		"b12.p.bench",
-		"b13.p.bench",
-		"b14.p.bench",
-		"b15.p.bench" //If this one is skipped, the trailing comma from the last benchmark needs to be removed.
-};
+//DELETE: benchmarks are now given on the command line.
+//std::vector<std::string> Circuitfiles = {
+//		"c17.bench",
+//		"c432.bench",
+//		"c499.bench",
+//		"c880.bench",
+//		"c1355.bench",
+//		"c1908.bench",
+//		"c2670.bench",
+//		"c3540.bench",
+//		"c5315.p.bench",
+//		"c6288.p.bench",
+//		"c7552.p.bench",
+//		"b01.p.bench",
+//		"b02.p.bench",
+//		"b03.p.bench",
+//		"b04.p.bench",
+//		"b05.p.bench",
+//		"b06.p.bench",
+//		"b07.p.bench",
+//		"b08.p.bench",
+//		"b09.p.bench",
+//		"b10.p.bench",
+//		"b11.p.bench",
+//		"b12.p.bench",
+//		"b13.p.bench",
+//		"b14.p.bench",
+//		"b15.p.bench" //If this one is skipped, the trailing comma from the last benchmark needs to be removed.
+//};
 
 template <class _container>
 void garbage(_container _trashCan) {
@@ -130,59 +246,95 @@ std::vector<type*> orderedPis(Circuit* _circuit) {
 }
 
 
-std::set<GENERIC_TESTPOINT*> chooseTPs(Circuit* _circuit, size_t _pre_sim,  bool _stuck_at) {
+/*
+ * A row of the result table: one (text) entry per column.
+ */
+typedef std::vector<std::string> Row;
 
-	//FIRST, set limits after simulating easy-to-detect faults.
-	FaultSimulator<VALUETYPE> fs(!_stuck_at); 
-	fs.setFaults(FaultGenerator<VALUETYPE>::allFaults(_circuit, _stuck_at));
-	
-	for (size_t i = 0; i < _pre_sim; i++) {
-		std::vector<VALUETYPE> inputVec = ValueVectorFunction<VALUETYPE>::random(_circuit->pis().size());
-		fs.applyStimulus(_circuit, inputVec);
-	}
-
-	
-	//SECOND, set TPI constraints
-	TPI_COP<NODETYPE, LINETYPE, VALUETYPE>tpi(_circuit, MAXVEC,{}, {}, {}, _stuck_at, fs.undetectedFaults());
-	tpi.timeLimit(TPITIMELIMIT);
-	tpi.testpointLimit(_circuit->nodes().size()*TPLIMIT);
-
-	
-	// THIRD, generate all TPs
-	TPGenerator<CONTROLTP, NODETYPE, LINETYPE, VALUETYPE> TPgenerator_control;
-	std::set<GENERIC_TESTPOINT*> all_control_tps = TPgenerator_control.allTPs(_circuit);
-	TPGenerator<OBSERVETP, NODETYPE, LINETYPE, VALUETYPE> TPgenerator_observe;
-	std::set<GENERIC_TESTPOINT*> all_observe_tps = TPgenerator_observe.allTPs(_circuit);
-	std::vector<std::set<GENERIC_TESTPOINT*>> all_tps;
-	all_tps.push_back(all_control_tps);
-	all_tps.push_back(all_observe_tps);
-	
-
-	//FOURTH, select TPs (the long part)
-	clock_t start2, finish2;
-	start2 = clock();
-	
-	std::set<GENERIC_TESTPOINT*> chosen_tps = tpi.testpoints(all_tps);
-	
-	finish2 = clock() - start2;
-	double totaltime2 = finish2 / (float)CLOCKS_PER_SEC;
-	printf("%f\t", totaltime2);
+/*
+ * The columns of the result table (one row per benchmark).
+ */
+const Row TableColumns = {
+	"BENCH", "PIs", "POs", "Nodes",
+	//First fault simulation: no TPs, reach 95%
+	"95_Vec", "95_Iter", "95_FC_No_TPs",
+	//TIME time and results (saf-targeting): control and observe pts
+	"TPI_time_saf", "TPI_results_saf",
+	//TIME time and results (tdf-targeting): control and observe pts
+	"TPI_time_tdf", "TPI_results_tdf",
+	//Second fault simulation: safs
+	"saf_Vec", "saf_Iter", "saf_noTPs_FC", "saf_saf_targeting_FC", "saf_tdf_targeting_FC",
+	//Second fault simulation: tdf
+	"tdf_Vec", "tdf_Iter", "tdf_noTPs_FC", "tdf_saf_targeting_FC", "tdf_tdf_targeting_FC"
+};
 
+/*
+ * The columns added after each TPI's results when TPs are also selected one at
+ * a time (see "[tpi-compare]"): the fault coverage predicted by COP (of the
+ * faults left after pre-TPI vectors) with the chosen TPs, then the time,
+ * results and predicted fault coverage of selecting one TP at a time.
+ */
+const Row CompareColumns = {
+	"TPI_COP_FC", "TPI_single_time", "TPI_single_results", "TPI_single_COP_FC"
+};
 
-	//FOURTH, clean up (create a copy of chosen TPs and delete the originals)
-	for (std::set<GENERIC_TESTPOINT*> tp_set : all_tps) {
-		for (GENERIC_TESTPOINT* tp : tp_set) {
-			if (chosen_tps.count(tp) == 0) {
-				delete tp;
+/*
+ * The columns of the result table, including the comparison columns if TPs
+ * are also selected one at a time (see "CompareColumns").
+ *
+ * @return The columns of the result table.
+ */
+Row tableColumns() {
+	if (settings.tpiCompare == 0) {
+		return TableColumns;
+	}
+	Row toReturn;
+	for (std::string column : TableColumns) {
+		toReturn.push_back(column);
+		if (column.find("TPI_results_") == 0) {
+			std::string target = column.substr(std::string("TPI_results_").size());
+			for (std::string compareColumn : CompareColumns) {
+				toReturn.push_back(compareColumn + "_" + target);
 			}
 		}
 	}
+	return toReturn;
+}
+
+/*
+ * The fault coverage of a circuit predicted by COP (see COP_fault_calculator),
+ * including any active TPs.
+ *
+ * @param _circuit The circuit.
+ * @param _stuck_at If the faults are stuck-at faults (else, transition delay faults).
+ * @param _faults The faults of the circuit to predict the coverage of.
+ * @return The predicted fault coverage.
+ */
+float copCoverage(Circuit* _circuit, bool _stuck_at, std::unordered_set<FAULTTYPE*> _faults) {
+	if (_faults.empty()) { //The calculator would target all faults instead.
+		return 1.0;
+	}
+	COP_fault_calculator<VALUETYPE> calculator(_circuit, _stuck_at, (int)settings.maxVec, _faults);
+	BatchCOP<VALUETYPE> cop;
+	cop.build(_circuit);
+	cop.calculate();
+	return calculator.faultCoverage(cop);
+}
 
+/*
+ * The number of control TPs in a set of TPs.
+ *
+ * An exception will be thrown if a TP is not a control, observe, or inversion TP.
+ *
+ * @param _testpoints The TPs.
+ * @return The number of control TPs.
+ */
+int controlTPs(const std::set<GENERIC_TESTPOINT*> & _testpoints) {
 	int numC = 0;
 	int numO = 0;
 	int numI = 0;
 
-	for (GENERIC_TESTPOINT* tp : chosen_tps) {
+	for (GENERIC_TESTPOINT* tp : _testpoints) {
 		if (dynamic_cast<CONTROLTP*>(tp) != nullptr) {
 			numC++;
 		}
@@ -197,7 +349,78 @@ std::set<GENERIC_TESTPOINT*> chooseTPs(Circuit* _circuit, size_t _pre_sim,  bool
 			throw "Something is wrong here.";
 		}
 	}
-	printf("%d\t", numC);
+	return numC;
+}
+
+std::set<GENERIC_TESTPOINT*> chooseTPs(Row & _row, Circuit* _circuit, std::vector<std::vector<VALUETYPE>> _pre_sim,  bool _stuck_at) {
+
+	//FIRST, set limits after simulating easy-to-detect faults.
+	FaultSimulator<VALUETYPE> fs(!_stuck_at); 
+	fs.setFaults(FaultGenerator<VALUETYPE>::allFaults(_circuit, _stuck_at));
+	
+	for (std::vector<VALUETYPE> inputVec : _pre_sim) {
+		fs.applyStimulus(_circuit, inputVec);
+	}
+
+	
+	//SECOND, set TPI constraints
+	TPI_COP<NODETYPE, LINETYPE, VALUETYPE>tpi(_circuit, settings.maxVec,{}, {}, {}, _stuck_at, fs.undetectedFaults());
+	tpi.timeLimit(settings.tpiTimeLimit);
+	tpi.testpointLimit(_circuit->nodes().size()*settings.tpLimit);
+	tpi.lazy(settings.lazyTpi != 0);
+	tpi.batch(settings.tpiBatch, (float)settings.tpiOverlap);
+	tpi.power((float)settings.tpiPower);
+
+	
+	// THIRD, describe all TPs (only chosen TPs are created)
+	TPCandidates<NODETYPE, LINETYPE, VALUETYPE> candidates(_circuit);
+	std::vector<std::vector<TPCandidate>> all_tps;
+	all_tps.push_back(candidates.candidates(TPCandidate::CONTROL));
+	all_tps.push_back(candidates.candidates(TPCandidate::OBSERVE));
+	
+
+	//FOURTH, select TPs (the long part)
+	ScopedTimer selectTimer("select");
+	
+	std::set<GENERIC_TESTPOINT*> chosen_tps = tpi.testpoints(candidates, all_tps);
+	
+	double totaltime2 = selectTimer.stop();
+	_row.push_back(std::to_string(totaltime2));
+	_row.push_back(std::to_string(controlTPs(chosen_tps)));
+
+
+	//FIFTH (optional), compare with selecting one TP at a time (see "CompareColumns").
+	if (settings.tpiCompare != 0) {
+		_row.push_back(std::to_string(copCoverage(_circuit, _stuck_at, fs.undetectedFaults())));
+
+		//The chosen TPs are removed while selecting one TP at a time, and then restored.
+		for (GENERIC_TESTPOINT* tp : chosen_tps) {
+			tp->deactivate(_circuit);
+		}
+		TPI_COP<NODETYPE, LINETYPE, VALUETYPE>single(_circuit, settings.maxVec,{}, {}, {}, _stuck_at, fs.undetectedFaults());
+		single.timeLimit(settings.tpiTimeLimit);
+		single.testpointLimit(_circuit->nodes().size()*settings.tpLimit);
+		single.power((float)settings.tpiPower);
+		TPCandidates<NODETYPE, LINETYPE, VALUETYPE> singleCandidates(_circuit);
+		std::vector<std::vector<TPCandidate>> single_tps;
+		single_tps.push_back(singleCandidates.candidates(TPCandidate::CONTROL));
+		single_tps.push_back(singleCandidates.candidates(TPCandidate::OBSERVE));
+
+		ScopedTimer singleTimer("select (one at a time)");
+		std::set<GENERIC_TESTPOINT*> single_chosen_tps = single.testpoints(singleCandidates, single_tps);
+		_row.push_back(std::to_string(singleTimer.stop()));
+		_row.push_back(std::to_string(controlTPs(single_chosen_tps)));
+		_row.push_back(std::to_string(copCoverage(_circuit, _stuck_at, fs.undetectedFaults())));
+
+		for (GENERIC_TESTPOINT* tp : single_chosen_tps) {
+			tp->deactivate(_circuit);
+		}
+		garbage<std::set<GENERIC_TESTPOINT*>>(single_chosen_tps);
+		for (GENERIC_TESTPOINT* tp : chosen_tps) {
+			tp->activate(_circuit);
+		}
+		single.clearFaults();
+	}
 
 	//CLEAN UP (the faults in TPI and fault simulator)
 	//Since the faults in TPI are also in the fault simulator, clean the fault simulator only.
@@ -212,177 +435,384 @@ std::set<GENERIC_TESTPOINT*> chooseTPs(Circuit* _circuit, size_t _pre_sim,  bool
 }
 
 #define MAXVECPERITER 10000000000  //The maximnum number of vectors allowed for any single fault simulation iteration.
-/*-> Do not overwrite this value: it is used only if no limit is given, and therefore should be a very large value.
+//-> Do not overwrite this value: it is used only if no limit is given, and therefore should be a very large value.
+
+/*
+ * The objects needed to fault simulate a set of circuits: the circuits, their
+ * faults and testpoints, a fault simulator per circuit, and their ordered PIs.
+ *
+ * Fault simulation modifies circuits (values are stored in lines and nodes), so
+ * every thread of a parallel fault simulation needs its own copy of these.
+ */
+struct FaultSimulationWorker {
+	std::vector<Circuit*> circuits;
+	std::vector<std::unordered_set<FAULTTYPE*>> faults;
+	std::vector<std::set<GENERIC_TESTPOINT*>> testpoints;
+	std::vector<FaultSimulator<VALUETYPE>*> faultSimulators;
+	std::vector<std::vector<SimulationNode<VALUETYPE>*>> pis;
+};
+
+//Create fault simulators and ordered PIs for the circuits of a worker.
+void prepareWorker(FaultSimulationWorker & _worker, bool _tdf) {
+	for (size_t i = 0; i < _worker.circuits.size(); i++) {
+		FaultSimulator<VALUETYPE> * faultsimulator = new FaultSimulator<VALUETYPE>(_tdf); faultsimulator->setFaults(_worker.faults.at(i));
+		_worker.faultSimulators.push_back(faultsimulator);
+		_worker.pis.push_back(orderedPis<SimulationNode<VALUETYPE>>(_worker.circuits.at(i)));
+	}
+}
+
+//Create a worker with its own copy of the given worker's circuits, faults, and testpoints.
+FaultSimulationWorker* copyWorker(const FaultSimulationWorker & _original, bool _tdf) {
+	FaultSimulationWorker* toReturn = new FaultSimulationWorker();
+	for (size_t i = 0; i < _original.circuits.size(); i++) {
+		std::map<Connecting*, Connecting*> oldToNew;
+		toReturn->circuits.push_back(new Circuit(*(_original.circuits.at(i)), oldToNew));
+
+		std::unordered_set<FAULTTYPE*> faults;
+		for (FAULTTYPE* fault : _original.faults.at(i)) {
+			FaultyLine<VALUETYPE>* location = dynamic_cast<FaultyLine<VALUETYPE>*>(oldToNew.at(fault->location()));
+			faults.emplace(new FAULTTYPE(location, fault->value()));
+		}
+		toReturn->faults.push_back(faults);
+
+		std::set<GENERIC_TESTPOINT*> testpoints;
+		if (i < _original.testpoints.size()) {
+			for (GENERIC_TESTPOINT* tp : _original.testpoints.at(i)) {
+				testpoints.emplace(tp->clone(dynamic_cast<LINETYPE*>(oldToNew.at(tp->location()))));
+			}
+			toReturn->testpoints.push_back(testpoints);
+		}
+	}
+	prepareWorker(*toReturn, _tdf);
+	return toReturn;
+}
+
+//Delete a worker created by "copyWorker" (faults and testpoints are deleted before their circuits).
+void deleteWorker(FaultSimulationWorker* _worker) {
+	garbage(_worker->faultSimulators);
+	for (std::unordered_set<FAULTTYPE*> faults : _worker->faults) {
+		garbage(faults);
+	}
+	for (std::set<GENERIC_TESTPOINT*> testpoints : _worker->testpoints) {
+		garbage(testpoints);
+	}
+	garbage(_worker->circuits);
+	delete _worker;
+}
+
+//Activate (or deactivate) all testpoints of a worker and clear the state of its circuits.
+//The events of every testpoint are simulated before the next testpoint changes the circuit: deactivating a testpoint
+//deletes its nodes, which may be reached by the events of another testpoint (e.g., control testpoints on a stem and its branch).
+void setTestpoints(FaultSimulationWorker & _worker, bool _activate) {
+	TraceSpan span(_activate ? "activate TPs" : "deactivate TPs", "simulation");
+	size_t numTestpoints = 0;
+	Simulator<VALUETYPE> clearingSimulator;
+	for (size_t i = 0; i < _worker.testpoints.size(); i++) {
+		std::set<GENERIC_TESTPOINT*> tpset = _worker.testpoints.at(i);
+		numTestpoints += tpset.size();
+		for (GENERIC_TESTPOINT* tp : tpset) {
+			EventQueue<VALUETYPE> clearingQueue;
+			clearingQueue.add(_activate ? tp->activate(_worker.circuits.at(i)) : tp->deactivate(_worker.circuits.at(i)));
+			clearingQueue.process();
+		}
+		clearingSimulator.applyStimulus(_worker.circuits.at(i));
+	}
+	span.arg("tps", numTestpoints);
+}
+
+//Is the given vector (of an iteration of "_vec_per_iter" vectors) applied while TPs are active?
+bool testpointWindow(size_t _iter_vec_applied, size_t _vec_per_iter) {
+	return (_iter_vec_applied >= _vec_per_iter / settings.tpRatio) && (_iter_vec_applied < (_vec_per_iter / settings.tpRatio) + SIZEOFPRIMITIVE);
+}
+
+//Were TPs activated (and therefore deactivated, which clears the circuit state) during an iteration?
+bool testpointsActivated(const FaultSimulationWorker & _worker, size_t _vec_per_iter, size_t _iter_vec_applied) {
+	if (_worker.testpoints.size() == 0) {
+		return false;
+	}
+	for (size_t applied = 0; applied < _iter_vec_applied; applied += SIZEOFPRIMITIVE) {
+		if (testpointWindow(applied, _vec_per_iter)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/*
+ * Perform a single fault simulation iteration (see "faultSimulate" for the limits).
+ *
+ * @param _worker The circuits (and their fault simulators) to simulate.
+ * @param _prpg The source of vectors.
+ * @param _vec_per_iter The number of vectors to apply.
+ * @param _vec_applied The number of vectors applied (across all iterations) before this iteration.
+ * @param _FCLimit The fault coverage limit (only used if _first is true).
+ * @param _first True if this is the first iteration.
+ * @param _deadline When fault simulation must stop.
+ * @return The number of vectors applied in this iteration.
+ */
+size_t simulateIteration(
+	FaultSimulationWorker & _worker,
+	PRPG<VALUETYPE> & _prpg,
+	size_t _vec_per_iter,
+	size_t _vec_applied,
+	float _FCLimit,
+	bool _first,
+	const Deadline & _deadline
+) {
+	float cur_best_fault_coverage = 0.0;
+	size_t iter_vec_applied = 0;
+	bool tpActivated = false;
+	while (
+		((cur_best_fault_coverage < _FCLimit) || _first == false) && //Max fault coverage reached (which we only care if we do not have a vec_per_iter set).
+		(_deadline.expired() == false) &&     //Time limit reached
+		(_vec_applied + iter_vec_applied < settings.maxVec) &&       //Total (across all iterations) vec limit reached.
+		(iter_vec_applied < _vec_per_iter)   //Vec limit (for this iteration) reached
+		) {  //Apply a vector if all conditions are met 
+		std::vector<VALUETYPE> inputVector = _prpg.load();
+
+		//TP activation check
+		if ((_worker.testpoints.size() != 0) && testpointWindow(iter_vec_applied, _vec_per_iter)) {
+			tpActivated = true;
+			setTestpoints(_worker, true);
+		}
+
+		//Circuits are independent, so they are simulated at the same time (unless iterations already are).
+		const char* error = nullptr;
+		#pragma omp parallel for num_threads((int)_worker.circuits.size())
+		for (int i = 0; i < (int)_worker.circuits.size(); i++) {
+			try {
+				_worker.faultSimulators.at(i)->applyStimulus(
+					_worker.circuits.at(i), inputVector, EventQueue<VALUETYPE>(), _worker.pis.at(i)
+				);
+			} catch (const char* thrown) {
+				#pragma omp critical
+				error = thrown;
+			}
+		}
+		if (error != nullptr) {
+			throw error;
+		}
+		for (size_t i = 0; i < _worker.circuits.size(); i++) {
+			cur_best_fault_coverage =
+				cur_best_fault_coverage > _worker.faultSimulators.at(i)->faultcoverage() ?
+				cur_best_fault_coverage : _worker.faultSimulators.at(i)->faultcoverage();
+		}
+
+		iter_vec_applied += SIZEOFPRIMITIVE;
+	}
+
+	//Deactivate TPs
+	if (tpActivated) {
+		setTestpoints(_worker, false);
+	}
+
+	return iter_vec_applied;
+}
+
+/*
 Simulate until...
 1) The maximum number of vectors is reached.
-2) The time limit is reached.
+2) The time limit (or the given outer deadline, if any) is reached.
 3) One benchmark reaches the max fault coverage limit.
 3a) If this is reached, another iteration will be strated. If the other two limits reached in the middle of a non-first iteration, the results of the last iteration will be discarded.
+
+The first iteration sets the number of vectors of every later iteration, so later
+iterations are independent and are simulated in parallel (one copy of the circuits
+per thread). Each iteration's vectors are the same as if all iterations were
+simulated in order: the PRPG is jumped ahead to the iteration's first vector. The
+average fault coverage is taken over the longest run of completed iterations (in
+iteration order), so results do not depend on the number of threads.
 @return The number of vectors simulated per iteration.
 */
 
 size_t faultSimulate(
-	
+	Row & _row,
 	std::vector<Circuit*> _circuits,
 	std::vector<std::unordered_set<FAULTTYPE*>> _faults,
 	
 	float _FCLimit = MAXFAULTCOVERAGE,
 	bool _tdf = false,
 	size_t _vecLimit = MAXVECPERITER,
-	size_t _itrLimit = MAXITER,
+	size_t _itrLimit = settings.maxIter,
 	
-	std::vector<std::set<GENERIC_TESTPOINT*>> _testpoints = std::vector< std::set<GENERIC_TESTPOINT*>>()
+	std::vector<std::set<GENERIC_TESTPOINT*>> _testpoints = std::vector< std::set<GENERIC_TESTPOINT*>>(),
+	Deadline _deadline = Deadline()
 ) {
-	PRPG<VALUETYPE> prpg(_circuits.at(0)->pis().size());
+	size_t numPis = _circuits.at(0)->pis().size();
+	PRPG<VALUETYPE> prpg(numPis);
+	Deadline deadline = Deadline((double)settings.simTimeLimit).earliest(_deadline);
 
 	//PREPARE fault simulators and ordered PIs for each circuit.
-	
-	std::vector<FaultSimulator<VALUETYPE>*> faultSimulators;
-	
-	std::vector<std::vector<SimulationNode<VALUETYPE>*>> pis;
-	
-	for (size_t i = 0; i < _circuits.size(); i++) {
-		Circuit* circuit = _circuits.at(i);
-		FaultSimulator<VALUETYPE> * faultsimulator = new FaultSimulator<VALUETYPE>(_tdf); faultsimulator->setFaults(_faults.at(i));
-		faultSimulators.push_back(faultsimulator);
-		pis.push_back(orderedPis<SimulationNode<VALUETYPE>>(circuit));
-	}
-
+	FaultSimulationWorker original;
+	original.circuits = _circuits;
+	original.faults = _faults;
+	original.testpoints = _testpoints;
+	prepareWorker(original, _tdf);
 
 	//PREPARE Accumulated fault coverages (across all iterations).
 	std::vector<float> faultCoverages = std::vector<float>(_circuits.size(), 0.0);
 
-	size_t iteration_number = 0;
-	size_t num_vec_applied = 0;
-	size_t vec_per_iter = _vecLimit;
-	clock_t start, finish;
-	start = clock();
-
-
-	//FAULT SIMULATION
-	while (iteration_number < _itrLimit) {
-		float cur_best_fault_coverage = 0.0;
-		size_t iter_vec_applied = 0;
-		bool tpActivated = false;
-		while (
-			((cur_best_fault_coverage < _FCLimit) || iteration_number != 0) && //Max fault coverage reached (which we only care if we do not have a vec_per_iter set).
-			(((clock() - start) / CLOCKS_PER_SEC) < SIMTIMELIMIT) &&     //Time limit reached
-			(num_vec_applied < MAXVEC) &&       //Total (across all iterations) vec limit reached.
-			(iter_vec_applied < vec_per_iter)   //Vec limit (for this iteration) reached
-			) {  //Apply a vector if all conditions are met 
-			//debug printf("iter %d\t vec %d\n", iteration_number, num_vec_applied);
-			std::vector<VALUETYPE> inputVector = prpg.load();
-
-			//TP activation check
-			//DEBUG printf("%d + %d (%d): %d %d %d\n", iter_vec_applied, vec_per_iter, TPRATIO, (_testpoints.size() != 0) , (iter_vec_applied >= vec_per_iter / TPRATIO) , (iter_vec_applied < (vec_per_iter / TPRATIO) + SIZEOFPRIMITIVE));
-			if ((_testpoints.size() != 0) && (iter_vec_applied >= vec_per_iter / TPRATIO) && (iter_vec_applied < (vec_per_iter / TPRATIO) + SIZEOFPRIMITIVE)) {
-				//debug printf("Activating tps...\n");
-				tpActivated = true;
-				Simulator<VALUETYPE> clearingSimulator; EventQueue<VALUETYPE> clearingQueue;
-				for (size_t i = 0; i < _testpoints.size(); i++) {
-					std::set<GENERIC_TESTPOINT*> tpset = _testpoints.at(i);
-
-					for (GENERIC_TESTPOINT* tp : tpset) {
-						//debug printf("Adding to queue...\n");
-						clearingQueue.add(tp->activate(_circuits.at(i)));
-					}
-					//debug printf("Clearing circuit state...\n");
-					clearingSimulator.applyStimulus(_circuits.at(i), std::vector<VALUETYPE>(), clearingQueue);
-				}
-				//debug printf("Done activating TPs\n");
-			}
+	//FAULT SIMULATION (first iteration), which sets the number of vectors per iteration.
+	TraceSpan firstSpan("fault simulation iteration", "simulation");
+	firstSpan.arg("circuit", _row.front());
+	firstSpan.arg("iteration", 0);
+	firstSpan.arg("tdf", _tdf);
+	size_t vec_per_iter = simulateIteration(original, prpg, _vecLimit, 0, _FCLimit, true, deadline);
+	firstSpan.arg("vectors", vec_per_iter);
+	firstSpan.end();
+	bool firstCleared = testpointsActivated(original, _vecLimit, vec_per_iter);
+	for (size_t i = 0; i < _circuits.size(); i++) {
+		faultCoverages[i] = faultCoverages.at(i) + original.faultSimulators.at(i)->faultcoverage();
+		original.faultSimulators.at(i)->resetFaults();
+	}
 
-			for (size_t i = 0; i < _circuits.size(); i++) {
-				faultSimulators.at(i)->applyStimulus(
-					_circuits.at(i), inputVector, EventQueue<VALUETYPE>(), pis.at(i)
-				);
-				cur_best_fault_coverage =
-					cur_best_fault_coverage > faultSimulators.at(i)->faultcoverage() ?
-					cur_best_fault_coverage : faultSimulators.at(i)->faultcoverage();
+	//FAULT SIMULATION (all other iterations).
+	//Iteration "n" starts after n*vec_per_iter vectors, so the total vector limit decides how many can complete.
+	size_t itrLimit = _itrLimit;
+	if (vec_per_iter == 0) {
+		itrLimit = 1;
+	} else if (itrLimit > settings.maxVec / vec_per_iter) {
+		itrLimit = settings.maxVec / vec_per_iter;
+	}
+	std::vector<std::vector<float>> iterationCoverages(itrLimit, std::vector<float>(_circuits.size(), 0.0));
+	std::vector<char> iterationComplete(itrLimit, false);
+	if (itrLimit > 1) {
+		int numWorkers = 1;
+#ifdef _OPENMP
+		if (omp_in_parallel() == false) { //E.g., when benchmarks are evaluated concurrently, iterations are not.
+			numWorkers = omp_get_max_threads();
+		}
+#endif
+		if ((size_t)numWorkers > itrLimit - 1) {
+			numWorkers = (int)(itrLimit - 1);
+		}
+		std::vector<FaultSimulationWorker*> workers;
+		if (numWorkers == 1) { //No copies are needed: iterations are simulated in order on the original circuits.
+			workers.push_back(&original);
+		} else {
+			for (int i = 0; i < numWorkers; i++) {
+				workers.push_back(copyWorker(original, _tdf));
 			}
-
-			num_vec_applied += SIZEOFPRIMITIVE;
-			iter_vec_applied += SIZEOFPRIMITIVE;
 		}
 
-		vec_per_iter = (iteration_number == 0) ? iter_vec_applied : vec_per_iter;
+		std::atomic<bool> stop(false); //Set once an iteration is cut short: later iterations will be discarded.
+		const char* error = nullptr;
+		#pragma omp parallel for schedule(dynamic, 1) num_threads(numWorkers)
+		for (int iteration = 1; iteration < (int)itrLimit; iteration++) {
+			if (stop == true) {
+				continue;
+			}
+			int thread = 0;
+#ifdef _OPENMP
+			thread = omp_get_thread_num();
+#endif
+			FaultSimulationWorker* worker = workers.at(thread);
+			TraceSpan span("fault simulation iteration", "simulation");
+			span.arg("circuit", _row.front());
+			span.arg("iteration", iteration);
+			span.arg("tdf", _tdf);
+			try {
+				//Jump to the last vector of the previous iteration (the PRPG's constructor performs one load).
+				PRPG<VALUETYPE> iterationPrpg(numPis);
+				iterationPrpg.skip(iteration * (vec_per_iter / SIZEOFPRIMITIVE) - 1);
+				std::vector<VALUETYPE> previousVector = iterationPrpg.load();
+
+				//Restore the circuit state (needed for TDFs) to what it would be if all iterations were simulated in
+				//order: either the last vector of the previous iteration, or unknown if TPs were deactivated.
+				bool cleared = (iteration == 1) ? firstCleared : testpointsActivated(*worker, vec_per_iter, vec_per_iter);
+				for (size_t i = 0; i < worker->circuits.size(); i++) {
+					Simulator<VALUETYPE> simulator;
+					simulator.applyStimulus(worker->circuits.at(i), cleared ? std::vector<VALUETYPE>() : previousVector, EventQueue<VALUETYPE>(), worker->pis.at(i));
+				}
 
-		//Deactivate TPs
-		if (tpActivated) {
-			//debug printf("Activating tps...\n");
-			Simulator<VALUETYPE> clearingSimulator; EventQueue<VALUETYPE> clearingQueue;
-			for (size_t i = 0; i < _testpoints.size(); i++) {
-				std::set<GENERIC_TESTPOINT*> tpset = _testpoints.at(i);
-				for (GENERIC_TESTPOINT* tp : tpset) {
-					//debug printf("Adding to queue...\n");
-					clearingQueue.add(tp->deactivate(_circuits.at(i)));
+				size_t applied = simulateIteration(*worker, iterationPrpg, vec_per_iter, iteration * vec_per_iter, _FCLimit, false, deadline);
+				if (applied == vec_per_iter && deadline.expired() == false) {
+					for (size_t i = 0; i < worker->circuits.size(); i++) {
+						iterationCoverages[iteration][i] = worker->faultSimulators.at(i)->faultcoverage();
+					}
+					iterationComplete[iteration] = true;
+				} else {
+					stop = true;
+				}
+
+				for (size_t i = 0; i < worker->circuits.size(); i++) {
+					worker->faultSimulators.at(i)->resetFaults();
 				}
-				//debug printf("Clearing circuit state...\n");
-				clearingSimulator.applyStimulus(_circuits.at(i), std::vector<VALUETYPE>(), clearingQueue);
+			} catch (const char* thrown) {
+				#pragma omp critical
+				error = thrown;
+				stop = true;
 			}
-			//debug  printf("Done activating TPs\n");
-		}
-
-		//Save iteration result if 1st iter or not half-way through.
-		if (
-			(iteration_number == 0) ||
-			(
-			(((clock() - start) / CLOCKS_PER_SEC) < SIMTIMELIMIT) &&
-				(num_vec_applied < _vecLimit)
-				)
-			) {
-			for (size_t i = 0; i < _circuits.size(); i++) {
-				faultCoverages[i] = faultCoverages.at(i) + faultSimulators.at(i)->faultcoverage();
-				//DEBUG printf("%d -> %f (%f):\n", i, faultCoverages.at(i) / ((float) iteration_number + 1), faultCoverages.at(i));
+		}
+
+		for (FaultSimulationWorker* worker : workers) {
+			if (worker != &original) {
+				deleteWorker(worker);
 			}
 		}
-		else {
-			break;
+		if (error != nullptr) {
+			throw error;
 		}
+	}
 
+	//Accumulate in iteration order (so the sum is the same regardless of threads).
+	size_t iteration_number = 1;
+	while (iteration_number < itrLimit && iterationComplete.at(iteration_number)) {
 		for (size_t i = 0; i < _circuits.size(); i++) {
-			faultSimulators.at(i)->resetFaults();
+			faultCoverages[i] = faultCoverages.at(i) + iterationCoverages.at(iteration_number).at(i);
 		}
-
 		iteration_number++;
 	}
-	
+
 	//for (size_t i = 0; i < _circuits.size(); i++) {
 	//	faultCoverages[i] = (faultCoverages.at(i) / (float) iteration_number); //Average the fault coverages.
 	//}
 
 	//debug printf("                                             \r");//Clear the line from previous carage return.
-	printf("%d\t", vec_per_iter); //Vectors
-	printf("%d\t", iteration_number); //Iterations
+	_row.push_back(std::to_string(vec_per_iter)); //Vectors
+	_row.push_back(std::to_string(iteration_number)); //Iterations
 	//DEBUG printf("FaultCoverages:\n"); //Fault simulation...
 	for (size_t i = 0; i < _circuits.size(); i++) {
-		printf("%f\t", faultCoverages.at(i) / (float)iteration_number);
+		_row.push_back(std::to_string(faultCoverages.at(i) / (float)iteration_number));
 		//std::vector<FAULTTYPE*> faults = faultSimulators.at(i)->clearFaults();
 		//NO: calling function is responsible for deleting.
 		//for (FAULTTYPE* fault : faults) {
 		//	delete fault;
 		//}
-		delete faultSimulators.at(i);
+		delete original.faultSimulators.at(i);
 	}
 
 	return vec_per_iter;
 }
 
-
-void evalCircuit(std::string _circuitFile) {
+/*
+ * Evaluate a benchmark: fault simulate it without TPs, with SAF-targeting TPs,
+ * and with TDF-targeting TPs.
+ *
+ * @param _circuitFile The benchmark to evaluate.
+ * @return The benchmark's row of the result table (see "tableColumns").
+ */
+Row evalCircuit(std::string _circuitFile) {
+	TraceSpan span("evaluate", "main");
+	span.arg("circuit", _circuitFile);
+	Row row;
 	//FIRST, parse all circuits and get generate circuit information.
+	ScopedTimer parseTimer("parse");
 	Parser<LINETYPE, NODETYPE, VALUETYPE> parser;
+	parser.cache(cacheNetlists);
 	Circuit* circuit_no_tpi = parser.Parse(_circuitFile.c_str());		// cop circuit
 	Circuit* circuit_cop_tpi_saf = parser.Parse(_circuitFile.c_str());	// orginal circuit
 	Circuit* circuit_cop_tpi_tdf = parser.Parse(_circuitFile.c_str());	// orginal circuit
-	printf("%s\t", _circuitFile.c_str()); //BENCH
-	printf("%d\t", circuit_no_tpi->pis().size()); //PIs
-	printf("%d\t", circuit_no_tpi->pos().size()); //POs
-	printf("%d\t", circuit_no_tpi->nodes().size()); //Nodes
+	row.push_back(_circuitFile); //BENCH
+	row.push_back(std::to_string(circuit_no_tpi->pis().size())); //PIs
+	row.push_back(std::to_string(circuit_no_tpi->pos().size())); //POs
+	row.push_back(std::to_string(circuit_no_tpi->nodes().size())); //Nodes
+	parseTimer.stop();
 
 
 	//Generate faults before TPI: otherwise fault coverage comparisons are unfare.
 	//These faults will be deleted at the end of fault simulation.
+	ScopedTimer faultTimer("fault generation");
 	std::vector < std::unordered_set<FAULTTYPE*>> safs = {
 		FaultGenerator<VALUETYPE>::allFaults(circuit_no_tpi,true),
 		FaultGenerator<VALUETYPE>::allFaults(circuit_cop_tpi_saf,true),
@@ -393,37 +823,75 @@ void evalCircuit(std::string _circuitFile) {
 		FaultGenerator<VALUETYPE>::allFaults(circuit_cop_tpi_saf,false),
 		FaultGenerator<VALUETYPE>::allFaults(circuit_cop_tpi_tdf,false)
 	};
+	faultTimer.stop();
 
 
 	//Perform fault simulation on the original circuit to (try to) reach 95% fault coverage.
-	size_t numVec = faultSimulate(std::vector<Circuit*>(
+	ScopedTimer preSimTimer("fault simulation");
+	size_t numVec = faultSimulate(row, std::vector<Circuit*>(
 		{ circuit_no_tpi }),  //No-TPI circuit.
 		std::vector<std::unordered_set<FAULTTYPE*>>({ safs.at(0) }), //The no-TPI circuit's faults.
 		95.0,	//The goal fault coverage
 		false,	//stuck-at fault simulation.
-		MAXVEC,	//Do not limit the number of vectors
+		settings.maxVec,	//Do not limit the number of vectors
 		1 		//Limit to a single iteration.
 	);
+	preSimTimer.stop();
 
 	//Perform TPI (TPs are actiated during fault simulation.
-	std::set<GENERIC_TESTPOINT*> cop_tpi_saf_tps = chooseTPs(circuit_cop_tpi_saf, PRETPIVEC, false);
-	for (GENERIC_TESTPOINT* tp : cop_tpi_saf_tps) {
-		tp->deactivate(circuit_cop_tpi_saf);
+	//Each benchmark has its own random engine, so results do not depend on which benchmarks were evaluated before it.
+	//Both TPI runs are independent (each has its own circuit), so they are run at the same time. Their pre-TPI vectors
+	//are drawn first (in order), so each run gets the same vectors as if the runs were performed one after another.
+	std::default_random_engine engine;
+	std::vector<Circuit*> tpiCircuits = { circuit_cop_tpi_saf, circuit_cop_tpi_tdf };
+	std::vector<bool> tpiStuckAt = { false, true };
+	std::vector<std::vector<std::vector<VALUETYPE>>> preTpiVectors(tpiCircuits.size());
+	for (size_t i = 0; i < tpiCircuits.size(); i++) {
+		for (size_t j = 0; j < settings.preTpiVec; j++) {
+			preTpiVectors[i].push_back(ValueVectorFunction<VALUETYPE>::random(tpiCircuits.at(i)->pis().size(), engine));
+		}
 	}
-	std::set<GENERIC_TESTPOINT*> cop_tpi_tdf_tps = chooseTPs(circuit_cop_tpi_tdf, PRETPIVEC, true);
-	for (GENERIC_TESTPOINT* tp : cop_tpi_tdf_tps) {
-		tp->deactivate(circuit_cop_tpi_tdf);
+	std::vector<std::set<GENERIC_TESTPOINT*>> tpiTestpoints(tpiCircuits.size());
+	std::vector<Row> tpiRows(tpiCircuits.size());
+	const char* error = nullptr;
+	#pragma omp parallel for num_threads((int)tpiCircuits.size())
+	for (int i = 0; i < (int)tpiCircuits.size(); i++) {
+		try {
+			ScopedTimer tpiTimer("TPI"); //Timed per thread.
+			TraceSpan tpiSpan("TPI", "tpi");
+			tpiSpan.arg("circuit", _circuitFile);
+			tpiSpan.arg("stuck_at", (bool)tpiStuckAt.at(i));
+			tpiTestpoints[i] = chooseTPs(tpiRows[i], tpiCircuits.at(i), preTpiVectors.at(i), tpiStuckAt.at(i));
+			tpiSpan.arg("tps", tpiTestpoints.at(i).size());
+			for (GENERIC_TESTPOINT* tp : tpiTestpoints.at(i)) {
+				tp->deactivate(tpiCircuits.at(i));
+			}
+		} catch (const char* thrown) {
+			#pragma omp critical
+			error = thrown;
+		}
+	}
+	if (error != nullptr) {
+		throw error;
+	}
+	for (Row tpiRow : tpiRows) {
+		row.insert(row.end(), tpiRow.begin(), tpiRow.end());
 	}
+	std::set<GENERIC_TESTPOINT*> cop_tpi_saf_tps = tpiTestpoints.at(0);
+	std::set<GENERIC_TESTPOINT*> cop_tpi_tdf_tps = tpiTestpoints.at(1);
 
 	std::vector<Circuit*> allCircuits = { circuit_no_tpi, circuit_cop_tpi_saf, circuit_cop_tpi_tdf };
 	std::vector<std::set<GENERIC_TESTPOINT*>> allTestpoints = {
 		std::set<GENERIC_TESTPOINT*>(),
 		cop_tpi_saf_tps, cop_tpi_tdf_tps };
-	faultSimulate(allCircuits, safs, 100.0, false, numVec, MAXITER, allTestpoints); //Do all safs, use no FC limit, set a vector limit based on the previous 95% fault coverage, repeat iterations and use average FC, time permitting.
-	faultSimulate(allCircuits, tdfs, 100.0, true, numVec, MAXITER, allTestpoints); //Do all tdfs, ...
+	ScopedTimer simTimer("fault simulation");
+	faultSimulate(row, allCircuits, safs, 100.0, false, numVec, settings.maxIter, allTestpoints); //Do all safs, use no FC limit, set a vector limit based on the previous 95% fault coverage, repeat iterations and use average FC, time permitting.
+	faultSimulate(row, allCircuits, tdfs, 100.0, true, numVec, settings.maxIter, allTestpoints); //Do all tdfs, ...
+	simTimer.stop();
 
 
 	//CLEANUP (faults are already deleted)
+	ScopedTimer cleanupTimer("cleanup");
 	garbage<std::set< GENERIC_TESTPOINT*>>(cop_tpi_saf_tps);
 	garbage<std::set< GENERIC_TESTPOINT*>>(cop_tpi_tdf_tps);
 	for (auto tdfList : tdfs) {
@@ -433,6 +901,8 @@ void evalCircuit(std::string _circuitFile) {
 		garbage<std::unordered_set<FAULTTYPE*>>(safList);
 	}
 	garbage<std::vector<Circuit*>>(allCircuits);  //Circuits must be deleted after faults.
+
+	return row;
 }
 
 
@@ -462,34 +932,201 @@ std::vector< float>Features(Circuit* _c, Levelized* _line, int _limit) {
 }
 
 
+
+
+//Print how to use this program.
+void printUsage(const char* _program) {
+	printf("Usage: %s [options] <bench file or glob>...\n", _program);
+	printf("Evaluates TPI on each benchmark and prints one tab-separated row per benchmark.\n\n");
+	printf("Options:\n");
+	printf("  -c, --config <file>      Read settings from a file (one 'key = value' per line).\n");
+	printf("  -j, --jobs <n>           Evaluate up to n benchmarks at once (default: 1, 0: one per core).\n");
+	printf("  -o, --output <file>      Write the table to a file instead of stdout.\n");
+	printf("  -t, --timing             Print the time spent in each phase (all threads) to stderr.\n");
+	printf("  --counters <file>        Write hot-path counts (all threads) as JSON (needs OPENEDA_COUNTERS).\n");
+	printf("  --no-cache               Do not cache parsed benchmarks (<bench file>.netlist, reused while the file is unchanged).\n");
+	printf("  --trace <file>           Write a trace (Chrome trace-event JSON, see chrome://tracing or ui.perfetto.dev).\n");
+	printf("  -h, --help               Print this message.\n\n");
+	printf("Settings (as flags or config keys, flags overwrite the config file):\n");
+	printf("  --tpi-time-limit <s>     TPI time limit, in seconds (default: %zu).\n", settings.tpiTimeLimit);
+	printf("  --tp-limit <fraction>    TP limit as a fraction of nodes (default: %g).\n", settings.tpLimit);
+	printf("  --pre-tpi-vec <n>        Vectors applied before TPI (default: %zu).\n", settings.preTpiVec);
+	printf("  --lazy-tpi <0|1>         Select TPs lazily, re-evaluating only the best TPs every round (default: %zu).\n", settings.lazyTpi);
+	printf("  --tpi-batch <n>          Insert up to n non-interfering TPs every round (default: %zu).\n", settings.tpiBatch);
+	printf("  --tpi-overlap <fraction> Overlap allowed between TPs inserted in one round (default: %g).\n", settings.tpiOverlap);
+	printf("  --tpi-power <weight>     Weight of the power metric in TP quality (default: %g).\n", settings.tpiPower);
+	printf("  --tpi-compare <0|1>      Also select TPs one at a time and report both selections (default: %zu).\n", settings.tpiCompare);
+	printf("  --max-vec <n>            Vectors across all fault simulation iterations (default: %zu).\n", settings.maxVec);
+	printf("  --max-iter <n>           Fault simulation iterations to average (default: %zu).\n", settings.maxIter);
+	printf("  --sim-time-limit <s>     Fault simulation time limit, in seconds (default: %zu).\n", settings.simTimeLimit);
+	printf("  --tp-ratio <n>           TPs are enabled for 1/n of all vectors (default: %zu).\n", settings.tpRatio);
+}
+
+//Print phase times (calls and seconds), e.g., "TPI/select  2  10.5".
+void printTiming(const PhaseTimes & _times) {
+	fprintf(stderr, "%-32s%8s%14s\n", "PHASE", "CALLS", "SECONDS");
+	for (const std::pair<const std::string, PhaseTimes::Phase> & phase : _times.phases()) {
+		fprintf(stderr, "%-32s%8zu%14.3f\n", phase.first.c_str(), phase.second.calls, phase.second.seconds);
+	}
+}
+
+//Write a row of the result table (tab-separated).
+void writeRow(FILE* _output, const Row & _row) {
+	for (size_t i = 0; i < _row.size(); i++) {
+		fprintf(_output, "%s%s", _row.at(i).c_str(), (i + 1 < _row.size()) ? "\t" : "\n");
+	}
+	fflush(_output);
+}
+
 int main(int argc, const char* argv[]) {
-	printf("Printing table header...\n");
-	printf("BENCH\tPIs\tPOs\tNodes\t");
-	//First fault simulation: no TPs, reach 95%
-	printf("95\%_Vec\t95\%_Iter\t");
-	printf("95\%_FC_No_TPs\t");
-	//TIME time and results (saf-targeting): control and observe pts
-	printf("TPI_time_saf\tTPI_results_saf\t");
-	//TIME time and results (tdf-targeting): control and observe pts
-	printf("TPI_time_tdf\tTPI_results_tdf\t");
-	//Second fault simulation: safs 
-	printf("saf_Vec\tsaf_Iter\t");
-	printf("noTPs_FC\t");
-	printf("saf_targeting_FC\t");
-	printf("tdf_targeting_FC\t");
-	//Second fault simulation: tdf 
-	printf("tdf_Vec\ttdf_Iter\t");
-	printf("noTPs_FC\t");
-	printf("saf_targeting_FC\t");
-	printf("tdf_targeting_FC\t");
-	printf("\n");
-	for (std::string circuitFile : Circuitfiles) {
-		evalCircuit("C://lab2//EDA2.0//Open EDA 2.0//"+circuitFile);
-		printf("\n");
+	std::vector<std::string> args(argv + 1, argv + argc);
+	std::vector<std::string> benchmarks;
+	std::string outputFile;
+	std::string countersFile;
+	std::string traceFile;
+	int jobs = 1;
+	bool timing = false;
+	try {
+		//The config file is read first, so flags overwrite it regardless of their order.
+		for (size_t i = 0; i + 1 < args.size(); i++) {
+			if (args.at(i) == "-c" || args.at(i) == "--config") {
+				readSettings(args.at(i + 1));
+			}
+		}
+		for (size_t i = 0; i < args.size(); i++) {
+			std::string arg = args.at(i);
+			if (arg == "-h" || arg == "--help") {
+				printUsage(argv[0]);
+				return 0;
+			}
+			if (arg == "-t" || arg == "--timing") {
+				timing = true;
+				continue;
+			}
+			if (arg == "--no-cache") {
+				cacheNetlists = false;
+				continue;
+			}
+			if (arg.size() < 2 || arg.at(0) != '-') {
+				std::vector<std::string> matches = expandGlob(arg);
+				benchmarks.insert(benchmarks.end(), matches.begin(), matches.end());
+				continue;
+			}
+			if (i + 1 >= args.size()) {
+				fprintf(stderr, "Missing value for '%s'.\n", arg.c_str());
+				return 1;
+			}
+			std::string value = args.at(++i);
+			if (arg == "-c" || arg == "--config") {
+				continue; //Already read.
+			} else if (arg == "-j" || arg == "--jobs") {
+				jobs = std::stoi(value);
+			} else if (arg == "-o" || arg == "--output") {
+				outputFile = value;
+			} else if (arg == "--counters") {
+				countersFile = value;
+			} else if (arg == "--trace") {
+				traceFile = value;
+			} else if (arg.compare(0, 2, "--") != 0 || setSetting(arg.substr(2), value) == false) {
+				fprintf(stderr, "Unknown option '%s'.\n", arg.c_str());
+				printUsage(argv[0]);
+				return 1;
+			}
+		}
+	} catch (const char* error) {
+		fprintf(stderr, "%s\n", error);
+		return 1;
+	} catch (std::exception&) { //Thrown by std::stoi
+		fprintf(stderr, "Invalid number of jobs.\n");
+		return 1;
+	}
+	if (benchmarks.empty()) {
+		printUsage(argv[0]);
+		return 1;
 	}
 
-	
+	FILE* output = stdout;
+	if (outputFile.empty() == false) {
+		output = fopen(outputFile.c_str(), "w");
+		if (output == nullptr) {
+			fprintf(stderr, "Failed to open '%s' for writing.\n", outputFile.c_str());
+			return 1;
+		}
+	}
+	writeRow(output, tableColumns());
+	if (traceFile.empty() == false) {
+		TraceLog::start();
+	}
 
+#ifdef _OPENMP
+	if (jobs <= 0) {
+		jobs = omp_get_num_procs();
+	}
+#endif
+	if (jobs <= 0 || (size_t)jobs > benchmarks.size()) {
+		jobs = (int)benchmarks.size();
+	}
 
-	
-}
\ No newline at end of file
+	//Benchmarks are evaluated concurrently, but rows are written in the given
+	//order (each as soon as all rows before it are written).
+	std::vector<Row> rows(benchmarks.size());
+	std::vector<char> finished(benchmarks.size(), false);
+	size_t nextRow = 0;
+	bool failed = false;
+	#pragma omp parallel for schedule(dynamic, 1) num_threads(jobs)
+	for (int i = 0; i < (int)benchmarks.size(); i++) {
+		Row row;
+		try {
+			row = evalCircuit(benchmarks.at(i));
+		} catch (const char* error) {
+			#pragma omp critical
+			{
+				fprintf(stderr, "%s: %s\n", benchmarks.at(i).c_str(), error);
+				failed = true;
+			}
+		}
+		#pragma omp critical
+		{
+			rows[i] = row;
+			finished[i] = true;
+			while (nextRow < rows.size() && finished.at(nextRow)) {
+				if (rows.at(nextRow).empty() == false) { //Failed benchmarks have no row.
+					writeRow(output, rows.at(nextRow));
+				}
+				rows[nextRow].clear();
+				nextRow++;
+			}
+		}
+	}
+
+	if (output != stdout) {
+		fclose(output);
+	}
+	if (timing) {
+		printTiming(Timing::total());
+	}
+	if (countersFile.empty() == false) {
+		if (Counters::enabled() == false) {
+			fprintf(stderr, "Counters are not compiled in (define OPENEDA_COUNTERS): all counts are 0.\n");
+		}
+		FILE* counters = fopen(countersFile.c_str(), "w");
+		if (counters == nullptr) {
+			fprintf(stderr, "Failed to open '%s' for writing.\n", countersFile.c_str());
+			return 1;
+		}
+		Counters::total().json(counters);
+		fprintf(counters, "\n");
+		fclose(counters);
+	}
+	if (traceFile.empty() == false) {
+		TraceLog::stop();
+		FILE* trace = fopen(traceFile.c_str(), "w");
+		if (trace == nullptr) {
+			fprintf(stderr, "Failed to open '%s' for writing.\n", traceFile.c_str());
+			return 1;
+		}
+		TraceLog::write(trace);
+		fclose(trace);
+	}
+	return failed ? 1 : 0;
+}
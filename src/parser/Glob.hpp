@@ -0,0 +1,71 @@
+/**
+ * @file Glob.hpp
+ * @author Spencer Millican (millican@auburn.edu)
+ * @version 0.1
+ * @date 2020-06-01
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#ifndef Glob_hpp
+#define Glob_hpp
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h> //FindFirstFile (globs)
+#else
+#include <glob.h>
+#endif
+
+/*
+ * Expand a path which may contain wildcards ("*" and "?") into all matching
+ * files (sorted).
+ *
+ * If nothing matches, the path itself is returned (so a missing file will be
+ * reported when it is parsed).
+ *
+ * @param _pattern The path or pattern.
+ * @return All matching paths.
+ */
+inline std::vector<std::string> expandGlob(std::string _pattern) {
+	std::vector<std::string> toReturn;
+#ifdef _WIN32
+	//FindFirstFile only returns file names, so keep the directory part of the pattern.
+	size_t slash = _pattern.find_last_of("/\\");
+	std::string directory = (slash == std::string::npos) ? "" : _pattern.substr(0, slash + 1);
+	WIN32_FIND_DATAA found;
+	HANDLE handle = FindFirstFileA(_pattern.c_str(), &found);
+	if (handle != INVALID_HANDLE_VALUE) {
+		do {
+			if ((found.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) == 0) {
+				toReturn.push_back(directory + found.cFileName);
+			}
+		} while (FindNextFileA(handle, &found));
+		FindClose(handle);
+	}
+#else
+	glob_t found;
+	if (glob(_pattern.c_str(), 0, nullptr, &found) == 0) {
+		for (size_t i = 0; i < found.gl_pathc; i++) {
+			toReturn.push_back(found.gl_pathv[i]);
+		}
+	}
+	globfree(&found);
+#endif
+	std::sort(toReturn.begin(), toReturn.end());
+	if (toReturn.empty()) {
+		toReturn.push_back(_pattern);
+	}
+	return toReturn;
+}
+
+#endif
@@ -0,0 +1,127 @@
+/**
+ * @file MappedFile.hpp
+ * @author Spencer Millican (millican@auburn.edu)
+ * @version 0.1
+ * @date 2020-06-01
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#ifndef MappedFile_h
+#define MappedFile_h
+
+#include <string>
+#include <fstream>
+#include <sstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#define OPENEDA_MMAP
+#endif
+
+/*
+ * The (read-only) contents of a file.
+ *
+ * On POSIX systems, the file is memory-mapped, so its contents are never
+ * copied. Elsewhere, the file is read into memory.
+ *
+ * The contents are only valid while the MappedFile exists.
+ */
+class MappedFile {
+public:
+	/*
+	 * Map (or read) a file.
+	 *
+	 * @param _filePath The file.
+	 */
+	MappedFile(std::string _filePath) {
+#ifdef OPENEDA_MMAP
+		int file = open(_filePath.c_str(), O_RDONLY);
+		if (file < 0) {
+			throw "Failed to open file for parsing.";
+		}
+		struct stat status;
+		if (fstat(file, &status) != 0 || S_ISREG(status.st_mode) == false) {
+			close(file);
+			throw "Failed to open file for parsing.";
+		}
+		this->size_ = (size_t)status.st_size;
+		if (this->size_ != 0) {
+			void* mapped = mmap(nullptr, this->size_, PROT_READ, MAP_PRIVATE, file, 0);
+			if (mapped == MAP_FAILED) {
+				close(file);
+				throw "Failed to map file for parsing.";
+			}
+			madvise(mapped, this->size_, MADV_SEQUENTIAL);
+			this->data_ = (const char*)mapped;
+		}
+		close(file); //The mapping stays valid.
+#else
+		std::ifstream file(_filePath, std::ios::binary);
+		if (file.is_open() == false) {
+			throw "Failed to open file for parsing.";
+		}
+		std::stringstream contents;
+		contents << file.rdbuf();
+		this->contents_ = contents.str();
+		this->data_ = this->contents_.data();
+		this->size_ = this->contents_.size();
+#endif
+	}
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	/*
+	 * Unmap the file.
+	 */
+	~MappedFile() {
+#ifdef OPENEDA_MMAP
+		if (this->data_ != nullptr) {
+			munmap((void*)this->data_, this->size_);
+		}
+#endif
+	}
+
+	/*
+	 * The contents of the file (NOT null-terminated).
+	 *
+	 * @return The first character of the file (nullptr if empty).
+	 */
+	const char* data() const {
+		return this->data_;
+	}
+
+	/*
+	 * The size of the file.
+	 *
+	 * @return The number of characters in the file.
+	 */
+	size_t size() const {
+		return this->size_;
+	}
+
+private:
+	/*
+	 * The contents of the file.
+	 */
+	const char* data_ = nullptr;
+
+	/*
+	 * The number of characters in the file.
+	 */
+	size_t size_ = 0;
+
+#ifndef OPENEDA_MMAP
+	/*
+	 * The file (if it cannot be mapped).
+	 */
+	std::string contents_;
+#endif
+};
+
+#endif
@@ -0,0 +1,527 @@
+/**
+ * @file Netlist.hpp
+ * @author Spencer Millican (millican@auburn.edu)
+ * @version 0.1
+ * @date 2020-06-01
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#ifndef Netlist_h
+#define Netlist_h
+
+#include <string>
+#include <vector>
+#include <cstring>
+#include <cstdint>
+#include <cstdio>
+#include <chrono>
+#include <thread>
+#include <functional> //std::hash
+#include <algorithm> //std::stable_sort
+#include <utility> //std::pair
+
+#include "parser/Tokenizer.hpp"
+
+/*
+ * A parsed (but not yet built) netlist: all nets, statements and functions of
+ * a file, with every name interned.
+ *
+ * A Netlist can be saved in a (versioned) binary format and read back without
+ * tokenizing the original file, i.e., it can be used as a cache of a parsed
+ * file. The binary format is:
+ *   - A Header (magic, version, the size and hash of the source file, the
+ *     order of statements and the number of each item below).
+ *   - Nets: the name (offset and size in the names blob), number of drivers
+ *     and number of readers (i.e., fan-outs) of each net.
+ *   - Statements: the kind, net, function and input nets of each statement
+ *     (i.e., a dense node table, in the order given by "reorder").
+ *   - Inputs: the input nets of all statements (CSR: each statement holds its
+ *     first input and number of inputs).
+ *   - Functions: the (lowercase) name of each function.
+ *   - Names: all names, one after another.
+ * All numbers are native-endian: a cache is only valid on the machine (type)
+ * which wrote it.
+ */
+struct Netlist {
+	/*
+	 * An order of statements.
+	 *
+	 * A Parser creates Lines and Nodes in the order of statements, which
+	 * mostly decides where they are in memory, i.e., which objects share
+	 * cache lines.
+	 */
+	enum Order {
+		/*
+		 * The order of the file.
+		 */
+		PARSE,
+
+		/*
+		 * By level (inputs first, each gate after all gates it reads): gates
+		 * which are evaluated together are next to each other.
+		 */
+		LEVEL,
+
+		/*
+		 * Depth-first through the fan-in cone of every output (in the order of
+		 * the file): each gate is next to (most of) the gates it reads.
+		 */
+		CONE
+	};
+
+	/*
+	 * A statement (line) of a file.
+	 */
+	struct Statement {
+		enum Kind { INPUT, OUTPUT, GATE };
+
+		uint32_t kind;
+
+		/*
+		 * The net driven (INPUT and GATE) or read (OUTPUT).
+		 */
+		uint32_t net;
+
+		/*
+		 * GATE: the (lowercase) function name (an index of functions).
+		 */
+		uint32_t function;
+
+		/*
+		 * GATE: the input nets are inputs[firstInput, firstInput + numInputs).
+		 */
+		uint32_t firstInput;
+		uint32_t numInputs;
+	};
+
+	/*
+	 * A net (i.e., all Lines with the same name).
+	 */
+	struct Net {
+		/*
+		 * The name of the net (pointing into the file or cache read).
+		 */
+		Token name;
+
+		/*
+		 * The number of statements driving the net (which must be 1).
+		 */
+		uint32_t drivers = 0;
+
+		/*
+		 * The number of references to the net as an input (or output). If there
+		 * is more than one, each reference is a fan-out Line of the driver.
+		 */
+		uint32_t readers = 0;
+	};
+
+	/*
+	 * All nets.
+	 */
+	std::vector<Net> nets;
+
+	/*
+	 * All statements (in the order of the file).
+	 */
+	std::vector<Statement> statements;
+
+	/*
+	 * The input nets of all GATE statements.
+	 */
+	std::vector<uint32_t> inputs;
+
+	/*
+	 * All (lowercase) function names.
+	 */
+	std::vector<std::string> functions;
+
+	/*
+	 * The order of statements (an Order).
+	 */
+	uint32_t order = PARSE;
+
+	/*
+	 * Remove all items.
+	 */
+	void clear() {
+		this->nets.clear();
+		this->statements.clear();
+		this->inputs.clear();
+		this->functions.clear();
+		this->order = PARSE;
+	}
+
+	/*
+	 * Put the statements (which must be in the order of the file) in a given
+	 * order.
+	 *
+	 * Nets, inputs and functions are not moved. Statements in a cycle (which
+	 * have no level) are put last, in the order of the file.
+	 *
+	 * @param _order The new order.
+	 */
+	void reorder(Order _order) {
+		if (_order == this->order) {
+			return;
+		}
+		if (this->order != PARSE) {
+			throw "Cannot reorder a netlist which is not in the order of the file.";
+		}
+		const uint32_t NONE = UINT32_MAX;
+		size_t size = this->statements.size();
+		std::vector<uint32_t> driver(this->nets.size(), NONE);
+		for (size_t i = 0; i < size; i++) {
+			if (this->statements[i].kind != Statement::OUTPUT && driver[this->statements[i].net] == NONE) {
+				driver[this->statements[i].net] = (uint32_t)i;
+			}
+		}
+		std::vector<uint32_t> order;
+		order.reserve(size);
+		if (_order == LEVEL) {
+			//Kahn's algorithm: a statement is placed once all statements driving
+			//its inputs are, and its level is one more than theirs.
+			std::vector<uint32_t> waiting(size, 0);
+			std::vector<uint32_t> firstReader(size + 1, 0);
+			for (size_t i = 0; i < size; i++) {
+				for (uint32_t j = 0; j < this->numInputs(i); j++) {
+					uint32_t input = driver[this->input(i, j)];
+					if (input != NONE) {
+						waiting[i]++;
+						firstReader[input + 1]++;
+					}
+				}
+			}
+			for (size_t i = 0; i < size; i++) {
+				firstReader[i + 1] += firstReader[i];
+			}
+			std::vector<uint32_t> readers(firstReader[size]);
+			std::vector<uint32_t> next(firstReader.begin(), firstReader.end() - 1);
+			for (size_t i = 0; i < size; i++) {
+				for (uint32_t j = 0; j < this->numInputs(i); j++) {
+					uint32_t input = driver[this->input(i, j)];
+					if (input != NONE) {
+						readers[next[input]++] = (uint32_t)i;
+					}
+				}
+			}
+			std::vector<uint32_t> level(size, 0);
+			for (size_t i = 0; i < size; i++) {
+				if (waiting[i] == 0) {
+					order.push_back((uint32_t)i);
+				}
+			}
+			for (size_t i = 0; i < order.size(); i++) {
+				uint32_t statement = order[i];
+				for (uint32_t j = firstReader[statement]; j < firstReader[statement + 1]; j++) {
+					uint32_t reader = readers[j];
+					level[reader] = std::max(level[reader], level[statement] + 1);
+					if (--waiting[reader] == 0) {
+						order.push_back(reader);
+					}
+				}
+			}
+			uint32_t cycle = 0;
+			for (uint32_t statementLevel : level) {
+				cycle = std::max(cycle, statementLevel + 1);
+			}
+			order.clear();
+			for (size_t i = 0; i < size; i++) {
+				order.push_back((uint32_t)i);
+				if (waiting[i] != 0) {
+					level[i] = cycle;
+				}
+			}
+			std::stable_sort(order.begin(), order.end(), [&](uint32_t _a, uint32_t _b) {
+				return level[_a] < level[_b];
+			});
+		} else if (_order == CONE) {
+			//Depth-first (not recursively: deep circuits would overflow the
+			//stack), placing each statement after all statements it reads.
+			std::vector<bool> visited(size, false);
+			std::vector<std::pair<uint32_t, uint32_t>> stack; //A statement and its next input.
+			auto visit = [&](uint32_t _root) {
+				if (visited[_root]) {
+					return;
+				}
+				visited[_root] = true;
+				stack.push_back(std::make_pair(_root, 0));
+				while (stack.empty() == false) {
+					uint32_t statement = stack.back().first;
+					if (stack.back().second < this->numInputs(statement)) {
+						uint32_t input = driver[this->input(statement, stack.back().second++)];
+						if (input != NONE && visited[input] == false) {
+							visited[input] = true;
+							stack.push_back(std::make_pair(input, 0));
+						}
+						continue;
+					}
+					order.push_back(statement);
+					stack.pop_back();
+				}
+			};
+			for (size_t i = 0; i < size; i++) {
+				if (this->statements[i].kind == Statement::OUTPUT) {
+					visit((uint32_t)i);
+				}
+			}
+			for (size_t i = 0; i < size; i++) { //Anything which is not observed.
+				visit((uint32_t)i);
+			}
+		} else {
+			throw "Unknown netlist order.";
+		}
+		std::vector<Statement> statements;
+		statements.reserve(size);
+		for (uint32_t statement : order) {
+			statements.push_back(this->statements[statement]);
+		}
+		this->statements.swap(statements);
+		this->order = _order;
+	}
+
+	/*
+	 * The (FNV-1a) hash of a file's contents, used to tell if a cache is stale.
+	 *
+	 * @param _data The contents of the file.
+	 * @param _size The number of characters in the file.
+	 * @return The hash of the contents.
+	 */
+	static uint64_t hash(const char* _data, size_t _size) {
+		uint64_t hash = 14695981039346656037ULL;
+		for (size_t i = 0; i < _size; i++) {
+			hash ^= (unsigned char)_data[i];
+			hash *= 1099511628211ULL;
+		}
+		return hash;
+	}
+
+	/*
+	 * The cache file of a source file.
+	 *
+	 * @param _filePath The source file.
+	 * @return The path of the cache.
+	 */
+	static std::string cachePath(std::string _filePath) {
+		return _filePath + ".netlist";
+	}
+
+	/*
+	 * Write the netlist (as a cache of a source file).
+	 *
+	 * The file is written under a temporary name and then renamed, so
+	 * concurrent readers (and writers) never see a partial file.
+	 *
+	 * @param _filePath The file to write.
+	 * @param _sourceSize The size of the source file.
+	 * @param _sourceHash The hash of the source file (see "hash").
+	 * @return False if the file could not be written.
+	 */
+	bool write(std::string _filePath, uint64_t _sourceSize, uint64_t _sourceHash) const {
+		std::string names;
+		std::vector<NetRecord> nets(this->nets.size());
+		for (size_t i = 0; i < this->nets.size(); i++) {
+			nets[i].name = (uint32_t)names.size();
+			nets[i].size = (uint32_t)this->nets[i].name.size;
+			nets[i].drivers = this->nets[i].drivers;
+			nets[i].readers = this->nets[i].readers;
+			names.append(this->nets[i].name.data, this->nets[i].name.size);
+		}
+		std::vector<uint32_t> functions;
+		for (const std::string & function : this->functions) {
+			functions.push_back((uint32_t)names.size());
+			functions.push_back((uint32_t)function.size());
+			names.append(function);
+		}
+		if (names.size() > UINT32_MAX) {
+			return false;
+		}
+		Header header;
+		memcpy(header.magic, magic(), sizeof(header.magic));
+		header.version = VERSION;
+		header.endian = ENDIAN;
+		header.sourceSize = _sourceSize;
+		header.sourceHash = _sourceHash;
+		header.order = this->order;
+		header.nets = this->nets.size();
+		header.statements = this->statements.size();
+		header.inputs = this->inputs.size();
+		header.functions = this->functions.size();
+		header.names = names.size();
+
+		std::string temporary = _filePath + ".tmp" + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) + "." + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+		FILE* file = fopen(temporary.c_str(), "wb");
+		if (file == nullptr) {
+			return false;
+		}
+		bool written =
+			fwrite(&header, sizeof(header), 1, file) == 1 &&
+			fwrite(nets.data(), sizeof(NetRecord), nets.size(), file) == nets.size() &&
+			fwrite(this->statements.data(), sizeof(Statement), this->statements.size(), file) == this->statements.size() &&
+			fwrite(this->inputs.data(), sizeof(uint32_t), this->inputs.size(), file) == this->inputs.size() &&
+			fwrite(functions.data(), sizeof(uint32_t), functions.size(), file) == functions.size() &&
+			fwrite(names.data(), 1, names.size(), file) == names.size();
+		written = (fclose(file) == 0) && written;
+		if (written == false || std::rename(temporary.c_str(), _filePath.c_str()) != 0) {
+			std::remove(temporary.c_str());
+			return false;
+		}
+		return true;
+	}
+
+	/*
+	 * Read a netlist written by "write" (replacing this netlist).
+	 *
+	 * Net names will point into the given data, which must outlive them.
+	 *
+	 * @param _data The contents of the cache file.
+	 * @param _size The size of the cache file.
+	 * @param _sourceSize The size the source file must have.
+	 * @param _sourceHash The hash the source file must have.
+	 * @return False (and an empty netlist) if the cache is invalid, of another
+	 *         version, or of another source file.
+	 */
+	bool read(const char* _data, size_t _size, uint64_t _sourceSize, uint64_t _sourceHash) {
+		this->clear();
+		Header header;
+		if (_size < sizeof(header)) {
+			return false;
+		}
+		memcpy(&header, _data, sizeof(header));
+		if (memcmp(header.magic, magic(), sizeof(header.magic)) != 0 || header.version != VERSION || header.endian != ENDIAN ||
+			header.sourceSize != _sourceSize || header.sourceHash != _sourceHash || header.order > CONE) {
+			return false;
+		}
+		//A count larger than the file is rejected before its size is used, so a corrupt header cannot overflow.
+		uint64_t remaining = _size - sizeof(header);
+		uint64_t sizes[5] = {
+			header.nets * sizeof(NetRecord), header.statements * sizeof(Statement), header.inputs * sizeof(uint32_t),
+			header.functions * 2 * sizeof(uint32_t), header.names
+		};
+		uint64_t counts[5] = { header.nets, header.statements, header.inputs, header.functions, header.names };
+		for (size_t i = 0; i < 5; i++) {
+			if (counts[i] > remaining || sizes[i] > remaining) {
+				return false;
+			}
+			remaining -= sizes[i];
+		}
+		if (remaining != 0) {
+			return false;
+		}
+		const char* position = _data + sizeof(header);
+		const char* names = _data + (_size - header.names);
+
+		std::vector<NetRecord> nets((size_t)header.nets);
+		memcpy(nets.data(), position, (size_t)sizes[0]);
+		position += sizes[0];
+		this->nets.resize(nets.size());
+		for (size_t i = 0; i < nets.size(); i++) {
+			if ((uint64_t)nets[i].name + nets[i].size > header.names) {
+				this->clear();
+				return false;
+			}
+			this->nets[i].name = Token(names + nets[i].name, nets[i].size);
+			this->nets[i].drivers = nets[i].drivers;
+			this->nets[i].readers = nets[i].readers;
+		}
+
+		this->statements.resize((size_t)header.statements);
+		memcpy(this->statements.data(), position, (size_t)sizes[1]);
+		position += sizes[1];
+		this->inputs.resize((size_t)header.inputs);
+		memcpy(this->inputs.data(), position, (size_t)sizes[2]);
+		position += sizes[2];
+		std::vector<uint32_t> functions((size_t)header.functions * 2);
+		memcpy(functions.data(), position, (size_t)sizes[3]);
+		for (size_t i = 0; i < functions.size(); i += 2) {
+			if ((uint64_t)functions[i] + functions[i + 1] > header.names) {
+				this->clear();
+				return false;
+			}
+			this->functions.push_back(std::string(names + functions[i], functions[i + 1]));
+		}
+
+		//Every index must be valid: the netlist will be built without further checks.
+		for (const Statement & statement : this->statements) {
+			if (statement.kind > Statement::GATE || statement.net >= this->nets.size() ||
+				(statement.kind == Statement::GATE && (statement.function >= this->functions.size() ||
+				(uint64_t)statement.firstInput + statement.numInputs > this->inputs.size()))) {
+				this->clear();
+				return false;
+			}
+		}
+		for (uint32_t input : this->inputs) {
+			if (input >= this->nets.size()) {
+				this->clear();
+				return false;
+			}
+		}
+		this->order = header.order;
+		return true;
+	}
+
+private:
+	/*
+	 * The number of nets a statement reads.
+	 */
+	uint32_t numInputs(size_t _statement) const {
+		const Statement & statement = this->statements[_statement];
+		if (statement.kind == Statement::OUTPUT) {
+			return 1;
+		}
+		return statement.kind == Statement::GATE ? statement.numInputs : 0;
+	}
+
+	/*
+	 * A net a statement reads (see "numInputs").
+	 */
+	uint32_t input(size_t _statement, uint32_t _input) const {
+		const Statement & statement = this->statements[_statement];
+		if (statement.kind == Statement::OUTPUT) {
+			return statement.net;
+		}
+		return this->inputs[statement.firstInput + _input];
+	}
+
+	/*
+	 * The first bytes of every cache.
+	 */
+	static const char* magic() {
+		return "OEDANET";
+	}
+
+	/*
+	 * The version of the format (change whenever the format changes).
+	 */
+	static const uint32_t VERSION = 2;
+
+	/*
+	 * Written as is, so caches of a machine with another byte order are rejected.
+	 */
+	static const uint32_t ENDIAN = 0x01020304;
+
+	struct Header {
+		char magic[8];
+		uint32_t version;
+		uint32_t endian;
+		uint64_t sourceSize;
+		uint64_t sourceHash;
+		uint32_t order;
+		uint32_t reserved = 0;
+		uint64_t nets;
+		uint64_t statements;
+		uint64_t inputs;
+		uint64_t functions;
+		uint64_t names;
+	};
+
+	struct NetRecord {
+		uint32_t name;
+		uint32_t size;
+		uint32_t drivers;
+		uint32_t readers;
+	};
+};
+
+#endif
@@ -0,0 +1,94 @@
+/**
+ * @file Netlist_Test.hpp
+ * @author Spencer Millican (millican@auburn.edu)
+ * @version 0.1
+ * @date 2020-06-01
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#include "gtest/gtest.h"
+#include "Netlist.hpp"
+
+#include <string>
+#include <vector>
+
+class NetlistTest : public ::testing::Test {
+public:
+	/*
+	 * The netlist of (in the order of the file):
+	 *   OUTPUT(y), OUTPUT(z), y = AND(x, a), x = NOT(b), z = NOT(a), INPUT(a), INPUT(b)
+	 */
+	void SetUp() override {
+		const char* names[] = { "y", "z", "x", "a", "b" };
+		for (const char* name : names) {
+			Netlist::Net net;
+			net.name = Token(name, 1);
+			netlist.nets.push_back(net);
+		}
+		netlist.functions = { "and", "not" };
+		netlist.inputs = { X, A, B, A };
+		statement(Netlist::Statement::OUTPUT, Y);
+		statement(Netlist::Statement::OUTPUT, Z);
+		statement(Netlist::Statement::GATE, Y, 0, 0, 2);
+		statement(Netlist::Statement::GATE, X, 1, 2, 1);
+		statement(Netlist::Statement::GATE, Z, 1, 3, 1);
+		statement(Netlist::Statement::INPUT, A);
+		statement(Netlist::Statement::INPUT, B);
+	}
+
+	void statement(uint32_t _kind, uint32_t _net, uint32_t _function = 0, uint32_t _firstInput = 0, uint32_t _numInputs = 0) {
+		Netlist::Statement statement;
+		statement.kind = _kind;
+		statement.net = _net;
+		statement.function = _function;
+		statement.firstInput = _firstInput;
+		statement.numInputs = _numInputs;
+		netlist.statements.push_back(statement);
+	}
+
+	//The statements by the name of their net ("Y" for OUTPUT(y) and "y" for y = AND(...)).
+	std::vector<std::string> names() {
+		std::vector<std::string> toReturn;
+		for (const Netlist::Statement & statement : netlist.statements) {
+			std::string name = netlist.nets.at(statement.net).name.str();
+			if (statement.kind == Netlist::Statement::OUTPUT) {
+				name[0] = (char)toupper(name[0]);
+			}
+			toReturn.push_back(name);
+		}
+		return toReturn;
+	}
+
+	enum { Y, Z, X, A, B };
+	Netlist netlist;
+};
+
+TEST_F(NetlistTest, LevelOrderTest) {
+	netlist.reorder(Netlist::LEVEL);
+	EXPECT_EQ(Netlist::LEVEL, netlist.order);
+	//Level 0: a, b. Level 1: x, z. Level 2: Z, y (in the order of the file). Level 3: Y.
+	EXPECT_EQ(std::vector<std::string>({ "a", "b", "x", "z", "Z", "y", "Y" }), names());
+}
+
+TEST_F(NetlistTest, ConeOrderTest) {
+	netlist.reorder(Netlist::CONE);
+	EXPECT_EQ(Netlist::CONE, netlist.order);
+	//The cone of y (pins in order), then the cone of z.
+	EXPECT_EQ(std::vector<std::string>({ "b", "x", "a", "y", "Y", "z", "Z" }), names());
+}
+
+TEST_F(NetlistTest, CycleTest) {
+	netlist.inputs.at(1) = Y; //y = AND(x, y): y (and its output) have no level.
+	netlist.reorder(Netlist::LEVEL);
+	EXPECT_EQ(std::vector<std::string>({ "a", "b", "x", "z", "Z", "Y", "y" }), names());
+}
+
+TEST_F(NetlistTest, ReorderTest) {
+	netlist.reorder(Netlist::PARSE); //Nothing to do.
+	EXPECT_EQ(std::vector<std::string>({ "Y", "Z", "y", "x", "z", "a", "b" }), names());
+	netlist.reorder(Netlist::LEVEL);
+	EXPECT_NO_THROW(netlist.reorder(Netlist::LEVEL));
+	EXPECT_ANY_THROW(netlist.reorder(Netlist::CONE)); //The order of the file is lost.
+}
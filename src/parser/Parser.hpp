@@ -15,15 +15,22 @@
 #include <utility> //std::pair
 #include <set>
 #include <map>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
 
 #include "Circuit.h""
 #include "Level.h"
 #include "Function.hpp"
+#include "timing/Trace.hpp"
+#include "parser/MappedFile.hpp"
+#include "parser/Tokenizer.hpp"
+#include "parser/Netlist.hpp"
 
-#include <algorithm> //std::transform
+#include <memory> //std::unique_ptr
+#include <algorithm> //std::sort
 #include <cctype> //std::tolower
-#include <fstream> //File handeling. 
-#include <string> //String, getline
+#include <cstdio> //printf
 
  /*
   * An object which converts a text file into a Circuit object.
@@ -87,6 +94,32 @@ public:
 	 */
 	std::vector<Function<_valueType>*> clearFunctions();
 
+	/*
+	 * Cache parsed files (or not, the default).
+	 *
+	 * When caching, the netlist of every parsed file is written next to it in
+	 * a binary format (see Netlist and Netlist::cachePath). Later parses of the
+	 * same file map the cache instead of tokenizing the file, as long as the
+	 * contents of the file (its hash) did not change. Caches which cannot be
+	 * written (e.g., in read-only directories) are skipped silently.
+	 *
+	 * @param _cache True if parsed files should be cached.
+	 */
+	void cache(bool _cache);
+
+	/*
+	 * Set the order in which Lines and Nodes are created (by default, by
+	 * level; see Netlist::Order).
+	 *
+	 * Objects are (mostly) placed in memory in the order they are created, so
+	 * the order decides which objects share cache lines. Fan-out Lines are
+	 * created next to the Node which reads them and each Node next to the Line
+	 * it drives.
+	 *
+	 * @param _order The order of statements when creating objects.
+	 */
+	void order(Netlist::Order _order);
+
 private:
 	/*
 	 * This is the list of possible functions for each node.
@@ -112,27 +145,74 @@ private:
 	virtual _nodeType* newNode(std::string _functionName, std::unordered_set<_lineType*> _inputs, std::unordered_set<_lineType*> _outputs);
 
 	/*
-	 * Adds a Line to the "Line tracking" data structure.
+	 * Return the net of a name, creating the net if it is the first reference.
 	 *
-	 * @param _line The Line to add.
+	 * @param _name The name of the net.
+	 * @return The net's index in the netlist.
 	 */
-	void addLine(_lineType* _line);
+	size_t intern(Token _name);
 
 	/*
-	 * Convert a given line of into corresponding Lines and Nodes.
+	 * Convert the tokens of a line of text into a Statement of the netlist.
 	 *
-	 * @param _textLine A line of text to convert to Lines and Nodes./
-	 * @return The number of Lines created.
+	 * @param _tokens The tokens of a line of text.
+	 * @return The number of Lines referenced.
 	 */
-	size_t ParseLine(std::string _textLine);
+	size_t ParseLine(const std::vector<Token> & _tokens);
 
 	/*
-	 * Merge all Lines in the Circuit to be created.
+	 * Create all Lines and Nodes of all Statements of the netlist.
 	 *
-	 * For all the lines in the "Line tracking" data structure, merge them through
-	 * connecting and delecting.
+	 * Every net is resolved once: its driver is a single Line, and if it is
+	 * read more than once, every reader gets its own fan-out Line.
+	 */
+	void Build();
+
+	/*
+	 * Return the Line driving a net, creating it if it is the first reference.
+	 *
+	 * @param _net The net (an index of the netlist's nets).
+	 * @return The driver of the net.
+	 */
+	_lineType* driver(size_t _net);
+
+	/*
+	 * Return the Line a (new) reader of a net reads.
+	 *
+	 * @param _net The net read (an index of the netlist's nets).
+	 * @return The driver (if the net has one reader) or a new fan-out Line.
+	 */
+	_lineType* reader(size_t _net);
+
+	/*
+	 * The netlist of the file being parsed (see "intern").
+	 */
+	Netlist netlist_;
+
+	/*
+	 * The Line driving each net of the netlist (once created).
+	 */
+	std::vector<_lineType*> drivers_;
+
+	/*
+	 * The index (in the netlist) of every net name.
 	 */
-	void MergeLines();
+	std::unordered_map<Token, size_t, TokenHash> symbols_;
+
+	/*
+	 * The index (in the netlist) of every function name (as written).
+	 */
+	std::unordered_map<Token, size_t, TokenHash> functionSymbols_;
+
+	/*
+	 * Should parsed files be cached (see "cache")?
+	 */
+	bool cache_ = false;
+
+	/*
+	 * The order in which objects are created (see "order").
+	 */
+	Netlist::Order order_ = Netlist::LEVEL;
 
 	/*
 	 * A local copy of all PIs, which will eventually be used to create the Circuit.
@@ -149,14 +229,6 @@ private:
 	 */
 	std::unordered_set<_nodeType*> nodes_;
 
-	/*
-	 * A data structure used to keep track of (identical) Lines.
-	 *
-	 * The map is used to return all Lines matching a given name. The returned
-	 * set is all Lines which match that name.
-	 */
-	std::map<std::string, std::set<_lineType*>> lines_;
-
 	/*
 	 * Clean all local storage (after parsing a file).
 	 */
@@ -166,34 +238,6 @@ private:
 };
 
 
-/*
- * Split a string into a serries of sub-strings seperated by a set of deliminter characters.
- *
- * @param source The string to split.
- * @param delimiter One or more characters to split the string based off of.
- * @param keepEmpty Should "empty entries" be thrown away?
- * @return A vector of strings created after the string is split.
- */
-std::vector<std::string> StringToTokins(const std::string &source, const char *delimiter, bool keepEmpty) {
-	std::vector<std::string> results;
-
-	size_t prev = 0;
-	size_t next = 0;
-
-	while ((next = source.find_first_of(delimiter, prev)) != std::string::npos) {
-		if (keepEmpty || (next - prev != 0)) {
-			results.push_back(source.substr(prev, next - prev));
-		}
-		prev = next + 1;
-	}
-
-	if (prev < source.size()) {
-		results.push_back(source.substr(prev));
-	}
-
-	return results;
-}
-
 template<class _lineType, class _nodeType, class _valueType>
 inline Parser<_lineType, _nodeType, _valueType>::Parser() {
 	this->functions_["and"] = new BooleanFunction<_valueType>("and");
@@ -217,17 +261,44 @@ inline Parser<_lineType, _nodeType, _valueType>::~Parser() {
 
 template <class _lineType, class _nodeType, class _valueType>
 Circuit * Parser<_lineType, _nodeType, _valueType>::Parse(std::string _filePath) {
-	//Open the file.
-	std::string currentLine;
-	std::ifstream file(_filePath);
-	if (file.is_open() == false) {
-		throw "Failed to open file for parsing.";
+	TraceSpan span("parse", "parser");
+	span.arg("file", _filePath);
+	//Tokenize the (mapped) file: tokens point into the file (or the mapped cache), which must be kept until all Lines are named.
+	MappedFile file(_filePath);
+	std::unique_ptr<MappedFile> cacheFile;
+	uint64_t hash = 0;
+	bool cached = false;
+	if (this->cache_) {
+		hash = Netlist::hash(file.data(), file.size());
+		try {
+			cacheFile.reset(new MappedFile(Netlist::cachePath(_filePath)));
+			cached = this->netlist_.read(cacheFile->data(), cacheFile->size(), file.size(), hash);
+		} catch (const char*) { //No cache (yet).
+		}
+		if (cached == true && this->netlist_.order != (uint32_t)this->order_) { //Cached in another order: it will be replaced.
+			this->netlist_.clear();
+			cached = false;
+		}
 	}
-	while (std::getline(file, currentLine)) {
-		this->ParseLine(currentLine);
+	try {
+		if (cached == false) {
+			Tokenizer tokenizer(file.data(), file.size(), " (,)=\r");
+			std::vector<Token> tokens;
+			while (tokenizer.next(tokens)) {
+				this->ParseLine(tokens);
+			}
+			this->netlist_.reorder(this->order_);
+		}
+		this->Build();
+		if (this->cache_ && cached == false) {
+			this->netlist_.write(Netlist::cachePath(_filePath), file.size(), hash);
+		}
+	} catch (...) {
+		this->Clean();
+		throw;
 	}
-	file.close();
-	this->MergeLines();
+	span.arg("cached", cached);
+	span.arg("bytes", file.size());
 
 	std::unordered_set<Levelized*> nodes = std::unordered_set<Levelized*>(this->nodes_.begin(), this->nodes_.end());
 	std::unordered_set<Levelized*> pis = std::unordered_set<Levelized*>(this->pis_.begin(), this->pis_.end());
@@ -235,9 +306,20 @@ Circuit * Parser<_lineType, _nodeType, _valueType>::Parse(std::string _filePath)
 	Circuit* toReturn = new Circuit(nodes, pis, pos);
 	this->Clean();
 
+	span.arg("nodes", nodes.size());
 	return toReturn;
 }
 
+template<class _lineType, class _nodeType, class _valueType>
+inline void Parser<_lineType, _nodeType, _valueType>::cache(bool _cache) {
+	this->cache_ = _cache;
+}
+
+template<class _lineType, class _nodeType, class _valueType>
+inline void Parser<_lineType, _nodeType, _valueType>::order(Netlist::Order _order) {
+	this->order_ = _order;
+}
+
 template<class _lineType, class _nodeType, class _valueType>
 inline std::vector<Function<_valueType>*> Parser<_lineType, _nodeType, _valueType>::clearFunctions() {
 	std::vector<Function<_valueType>*> toReturn;
@@ -272,109 +354,142 @@ _nodeType * Parser<_lineType, _nodeType, _valueType>::newNode(std::string _funct
 }
 
 template <class _lineType, class _nodeType, class _valueType>
-void Parser<_lineType, _nodeType, _valueType>::addLine(_lineType * _line) {
-	std::string name = _line->name();
-	if (lines_.count(name) == 0) {//Name is not in use yet.
-		lines_[name] = std::set<_lineType*>({ _line });
-	}
-	else {
-		lines_.at(name).emplace(_line);
+size_t Parser<_lineType, _nodeType, _valueType>::intern(Token _name) {
+	auto found = this->symbols_.find(_name);
+	if (found != this->symbols_.end()) {
+		return found->second;
 	}
+	size_t toReturn = this->netlist_.nets.size();
+	Netlist::Net net;
+	net.name = _name;
+	this->netlist_.nets.push_back(net);
+	this->symbols_.emplace(_name, toReturn);
+	return toReturn;
 }
 
 template <class _lineType, class _nodeType, class _valueType>
-size_t Parser<_lineType, _nodeType, _valueType>::ParseLine(std::string _textLine) {
+size_t Parser<_lineType, _nodeType, _valueType>::ParseLine(const std::vector<Token> & _tokens) {
 	//Reminder: the line format:
 	//  #comment
 	//  GATE_NAME = PRIMITIVE(INPUT1, INPUT2, ... INPUTX)
 	//  INPUT(GX)
 	//  OUTPUT(GX)
-	std::vector<std::string> tokins = StringToTokins(_textLine, " (,)=\r", false);
-	if (tokins.size() == 0) { //Blank line.
+	if (_tokens.size() == 0) { //Blank line.
 		return 0;
 	}
-	if (!tokins.at(0).compare("#")) { //Comment
+	if (_tokens.at(0).data[0] == '#') { //Comment
 		return 0;
 	}
-	if (!tokins.at(0).compare("OUTPUT") || !tokins.at(0).compare("INPUT")) { //WE HAVE AN OUTPUT/INPUT
-		std::string name = tokins.at(1);
-		_lineType* line = this->newLine(name);
-		this->addLine(line);
-		if (!tokins.at(0).compare("OUTPUT")) { //po
-			_nodeType* newNode = this->newNode("po", std::unordered_set<_lineType*>({ line }), std::unordered_set<_lineType*>());
-			pos_.emplace(newNode);
-			nodes_.emplace(newNode);
-			line->addOutput(newNode);
-		}
-		else { //pi
-			_nodeType* newNode = this->newNode("pi", std::unordered_set<_lineType*>(), std::unordered_set<_lineType*>({ line }));
-			pis_.emplace(newNode);
-			nodes_.emplace(newNode);
-			line->addInput(newNode);
+	if (_tokens.size() < 2) {
+		throw "Failed to parse a line: too few names.";
+	}
+	std::vector<Netlist::Net> & nets = this->netlist_.nets;
+	Netlist::Statement statement;
+	statement.function = 0;
+	statement.firstInput = 0;
+	statement.numInputs = 0;
+	if (_tokens.at(0).is("OUTPUT") || _tokens.at(0).is("INPUT")) { //WE HAVE AN OUTPUT/INPUT
+		statement.kind = _tokens.at(0).is("OUTPUT") ? Netlist::Statement::OUTPUT : Netlist::Statement::INPUT;
+		statement.net = (uint32_t)this->intern(_tokens.at(1));
+		if (statement.kind == Netlist::Statement::OUTPUT) {
+			nets[statement.net].readers++;
+		} else {
+			nets[statement.net].drivers++;
 		}
+		this->netlist_.statements.push_back(statement);
 		return 1;
 	}
-	else { //WE HAVE A GENERIC NODE
-		std::string nodeFunctionName = tokins.at(1); std::transform(nodeFunctionName.begin(), nodeFunctionName.end(), nodeFunctionName.begin(), (int(*)(int))std::tolower);
-		_lineType* outputLine = this->newLine(tokins.at(0));
-		this->addLine(outputLine);
-		std::unordered_set<_lineType*> intputLines;
-		for (size_t i = 2; i < tokins.size(); ++i) {
-			std::string inputLineName = tokins.at(i);
-			_lineType* inputLine = this->newLine(inputLineName);
-			this->addLine(inputLine);
-			intputLines.emplace(inputLine);
-		}
-
-		_nodeType* newNode = this->newNode(nodeFunctionName, intputLines, std::unordered_set<_lineType*>({ outputLine }));
-		if (intputLines.size() != newNode->inputs().size() || newNode->outputs().size() != 1) {
-			throw "Your _nodeType constructor is flawed: it most likely needs to call 'Connecting'.";
-		}
-
-		/*If you need the followign code, your _nodeType needs to call "Connecting" in its constructor.
-		for (_lineType* inputLine : intputLines) {
-			inputLine->addOutput(newNode);
-			}
-		*/
-
-		this->nodes_.emplace(newNode);
+	//WE HAVE A GENERIC NODE
+	statement.kind = Netlist::Statement::GATE;
+	auto function = this->functionSymbols_.find(_tokens.at(1));
+	if (function == this->functionSymbols_.end()) { //Lowercase each spelling once.
+		std::string functionName = _tokens.at(1).str();
+		std::transform(functionName.begin(), functionName.end(), functionName.begin(), (int(*)(int))std::tolower);
+		function = this->functionSymbols_.emplace(_tokens.at(1), this->netlist_.functions.size()).first;
+		this->netlist_.functions.push_back(functionName);
+	}
+	statement.function = (uint32_t)function->second;
+	statement.net = (uint32_t)this->intern(_tokens.at(0));
+	nets[statement.net].drivers++;
+	statement.firstInput = (uint32_t)this->netlist_.inputs.size();
+	statement.numInputs = (uint32_t)(_tokens.size() - 2);
+	for (size_t i = 2; i < _tokens.size(); ++i) {
+		size_t input = this->intern(_tokens.at(i));
+		nets[input].readers++;
+		this->netlist_.inputs.push_back((uint32_t)input);
+	}
+	this->netlist_.statements.push_back(statement);
+	return statement.numInputs + 1;
+}
 
-		return intputLines.size() + 1;
+template <class _lineType, class _nodeType, class _valueType>
+_lineType* Parser<_lineType, _nodeType, _valueType>::driver(size_t _net) {
+	if (this->drivers_[_net] == nullptr) {
+		this->drivers_[_net] = this->newLine(this->netlist_.nets[_net].name.str());
 	}
+	return this->drivers_[_net];
 }
 
+template <class _lineType, class _nodeType, class _valueType>
+_lineType* Parser<_lineType, _nodeType, _valueType>::reader(size_t _net) {
+	if (this->netlist_.nets[_net].readers == 1) { //Not a fan-out: the driver is read directly.
+		return this->driver(_net);
+	}
+	_lineType* branch = this->newLine(this->netlist_.nets[_net].name.str());
+	this->driver(_net)->addOutput(branch);
+	return branch;
+}
 
 template <class _lineType, class _nodeType, class _valueType>
-void Parser<_lineType, _nodeType, _valueType>::MergeLines() {
-	for (auto it = lines_.begin(); it != lines_.end(); ++it) {
-		std::string lineName = it->first;
-		std::set<_lineType*> lines = it->second;
-		_lineType* base = nullptr;
-		for (_lineType* line : lines) {
-			if (line->outputs().size() == 0) { base = line; lines.erase(line); break; }
+void Parser<_lineType, _nodeType, _valueType>::Build() {
+	//FIRST, check every net has one driver (created with the first statement which references it).
+	std::vector<std::string> unread;
+	this->drivers_.assign(this->netlist_.nets.size(), nullptr);
+	for (const Netlist::Net & net : this->netlist_.nets) {
+		if (net.drivers == 0) { throw "Could not merge lines: there is no base."; }
+		if (net.drivers > 1) { throw "Problem: multiple lines have no output."; }
+		if (net.readers == 0) {
+			unread.push_back(net.name.str());
 		}
-		if (base == nullptr) { throw "Could not merge lines: there is no base."; }
-		if (lines.size() == 0) {
-			printf("%s \n", base->name().c_str());
-			//printf("WARNING: A line in circuit doesn't drive anything \n");
+	}
+	std::sort(unread.begin(), unread.end());
+	for (std::string name : unread) {
+		printf("%s \n", name.c_str());
+		//printf("WARNING: A line in circuit doesn't drive anything \n");
+	}
+
+	//SECOND, create all Nodes in the order of statements (Lines are created as they are referenced).
+	this->nodes_.reserve(this->netlist_.statements.size());
+	for (const Netlist::Statement & statement : this->netlist_.statements) {
+		_lineType* driver = this->driver(statement.net);
+		if (statement.kind == Netlist::Statement::INPUT) { //pi
+			_nodeType* newNode = this->newNode("pi", std::unordered_set<_lineType*>(), std::unordered_set<_lineType*>({ driver }));
+			pis_.emplace(newNode);
+			nodes_.emplace(newNode);
+			if (newNode->outputSpan().size() == 0) { //The _nodeType constructor did not connect the line.
+				driver->addInput(newNode);
+			}
+			continue;
 		}
-		if (lines.size() == 1) {	//Same non-fanout line, so delete.
-			_lineType* toDelete = *lines.begin();
-			if (toDelete->outputs().size() == 0) {	//Sanity check, this should not happen
-				throw "Problem: multiple lines have no output.";
+		if (statement.kind == Netlist::Statement::OUTPUT) { //po
+			_lineType* line = this->reader(statement.net);
+			_nodeType* newNode = this->newNode("po", std::unordered_set<_lineType*>({ line }), std::unordered_set<_lineType*>());
+			pos_.emplace(newNode);
+			nodes_.emplace(newNode);
+			if (newNode->inputSpan().size() == 0) { //The _nodeType constructor did not connect the line.
+				line->addOutput(newNode);
 			}
-			base->addOutput(*toDelete->outputs().begin());
-			toDelete->outputs(std::unordered_set<Connecting*>()); 
-			//This shouldn't be necessary, but was added in order to clear COP values consistently.
-			
-			toDelete->inputs(std::unordered_set<Connecting*>());
-			delete toDelete;	//This will automatically delete its connections.
 			continue;
 		}
-		//All other lines are fanouts.
-		for (auto otherLineIterator = lines.begin(); otherLineIterator != lines.end(); ++otherLineIterator) {
-			base->addOutput(*otherLineIterator);
+		//Inputs are connected one at a time, so they are kept in the order of the file.
+		_nodeType* newNode = this->newNode(this->netlist_.functions.at(statement.function), std::unordered_set<_lineType*>(), std::unordered_set<_lineType*>({ driver }));
+		if (newNode->outputSpan().size() != 1) {
+			throw "Your _nodeType constructor is flawed: it most likely needs to call 'Connecting'.";
+		}
+		for (size_t i = 0; i < statement.numInputs; i++) {
+			newNode->addInput(this->reader(this->netlist_.inputs[statement.firstInput + i]));
 		}
+		this->nodes_.emplace(newNode);
 	}
 }
 
@@ -383,7 +498,10 @@ void Parser<_lineType, _nodeType, _valueType>::Clean() {
 	pis_.clear();
 	pos_.clear();
 	nodes_.clear();
-	lines_.clear();
+	netlist_.clear();
+	drivers_.clear();
+	symbols_.clear();
+	functionSymbols_.clear();
 }
 
 #endif
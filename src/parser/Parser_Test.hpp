@@ -12,7 +12,11 @@
 #include "Parser.hpp"
 #include "SimulationStructures.hpp"
 #include "Circuit.h"
+#include "Tokenizer_Test.hpp"
+#include "Netlist_Test.hpp"
 #include <unordered_set>
+#include <fstream>
+#include <set>
 
 class ParserTest : public ::testing::Test {
 public:
@@ -75,4 +79,150 @@ TEST_F(ParserTest, C17TEST) {
 	for (Levelized* node : c->nodes()) {
 		EXPECT_LE(node->outputs().size(), 1);
 	}
-}
\ No newline at end of file
+}
+
+//Write a bench file (for tests).
+void writeBench(std::string _filePath, std::string _contents) {
+	std::ofstream file(_filePath, std::ios::binary);
+	file << _contents;
+}
+
+//Fan-outs: a net read more than once gets one fan-out Line per reader; a net read once is read directly.
+TEST_F(ParserTest, FanoutTest) {
+	writeBench("fanout_test.bench",
+		"#comment without a space\r\n"
+		"INPUT(a)\r\n"
+		"INPUT(b)\r\n"
+		"OUTPUT(y)\r\n"
+		"OUTPUT(a)\r\n"
+		"y = nand(a, x)\r\n"
+		"x = Not(b)\r\n" //Used before it is defined.
+	);
+	Circuit* fanout = parse.Parse("fanout_test.bench");
+	remove("fanout_test.bench");
+	EXPECT_EQ(6, fanout->nodes().size());
+	EXPECT_EQ(2, fanout->pis().size());
+	EXPECT_EQ(2, fanout->pos().size());
+	for (Levelized* pi : fanout->pis()) {
+		Connecting* stem = *pi->outputs().begin();
+		if (stem->name() == "a") { //Read by the NAND and a PO: two fan-out Lines.
+			EXPECT_EQ(2, stem->outputs().size());
+			for (Connecting* branch : stem->outputs()) {
+				EXPECT_EQ("a", branch->name());
+				EXPECT_EQ(1, branch->outputs().size());
+			}
+		} else { //Read once (by the NOT) directly.
+			EXPECT_EQ("b", stem->name());
+			ASSERT_EQ(1, stem->outputs().size());
+			EXPECT_EQ(1, fanout->nodes().count(dynamic_cast<Levelized*>(*stem->outputs().begin())));
+		}
+	}
+	delete fanout;
+}
+
+//The inputs of a gate are in the order of the file, and PIs/POs connect to their Lines once.
+TEST_F(ParserTest, PinOrderTest) {
+	Circuit* c17 = parse.Parse("c17.bench");
+	for (Levelized* node : c17->nodes()) {
+		std::vector<std::string> inputs;
+		for (Connecting* input : node->inputSpan()) {
+			inputs.push_back(input->name());
+		}
+		if (node->name() == "pi") {
+			EXPECT_EQ(1, node->outputSpan().size());
+		}
+		if (node->name() == "po") {
+			EXPECT_EQ(1, node->inputSpan().size());
+		}
+		Connecting* output = node->outputSpan().empty() ? nullptr : node->outputSpan()[0];
+		if (output == nullptr || node->name() == "pi") {
+			continue;
+		}
+		if (output->name() == "16") {
+			EXPECT_EQ(std::vector<std::string>({ "2", "11" }), inputs);
+		}
+		if (output->name() == "19") {
+			EXPECT_EQ(std::vector<std::string>({ "11", "7" }), inputs);
+		}
+		if (output->name() == "22") {
+			EXPECT_EQ(std::vector<std::string>({ "10", "16" }), inputs);
+		}
+	}
+	delete c17;
+}
+
+TEST_F(ParserTest, InvalidTest) {
+	writeBench("invalid_test.bench", "INPUT(a)\ny = AND(a, x)\nOUTPUT(y)\n"); //"x" is never driven.
+	EXPECT_ANY_THROW(parse.Parse("invalid_test.bench"));
+	writeBench("invalid_test.bench", "INPUT(a)\nINPUT(a)\nOUTPUT(a)\n"); //"a" is driven twice.
+	EXPECT_ANY_THROW(parse.Parse("invalid_test.bench"));
+	writeBench("invalid_test.bench", "INPUT\n");
+	EXPECT_ANY_THROW(parse.Parse("invalid_test.bench"));
+	remove("invalid_test.bench");
+	EXPECT_NO_THROW(delete parse.Parse("c17.bench")); //Nothing is left over from failures.
+}
+
+//Caching: the first parse writes the cache, later parses read it (unless the file changed).
+TEST_F(ParserTest, CacheTest) {
+	writeBench("cache_test.bench", "INPUT(a)\nINPUT(b)\nOUTPUT(y)\ny = AND(a, b)\n");
+	remove("cache_test.bench.netlist");
+	parse.cache(true);
+	Circuit* first = parse.Parse("cache_test.bench");
+	EXPECT_TRUE(std::ifstream("cache_test.bench.netlist").good());
+	Circuit* cached = parse.Parse("cache_test.bench");
+	EXPECT_EQ(first->nodes().size(), cached->nodes().size());
+	EXPECT_EQ(2, cached->pis().size());
+	EXPECT_EQ(1, cached->pos().size());
+	for (Levelized* pi : cached->pis()) {
+		EXPECT_EQ(1, pi->outputs().size());
+		EXPECT_EQ(1, (*pi->outputs().begin())->outputs().size());
+	}
+	writeBench("cache_test.bench", "INPUT(a)\nOUTPUT(y)\nOUTPUT(z)\ny = NOT(a)\nz = BUFF(a)\n"); //The cache is now stale.
+	Circuit* changed = parse.Parse("cache_test.bench");
+	EXPECT_EQ(5, changed->nodes().size());
+	EXPECT_EQ(1, changed->pis().size());
+	EXPECT_EQ(2, changed->pos().size());
+	writeBench("cache_test.bench.netlist", "OEDANET"); //A corrupt cache is ignored.
+	Circuit* corrupt = parse.Parse("cache_test.bench");
+	EXPECT_EQ(5, corrupt->nodes().size());
+	remove("cache_test.bench");
+	remove("cache_test.bench.netlist");
+	delete first;
+	delete cached;
+	delete changed;
+	delete corrupt;
+}
+
+//Every order creates the same circuit; a cache of another order is replaced.
+TEST_F(ParserTest, OrderTest) {
+	Netlist::Order orders[] = { Netlist::PARSE, Netlist::LEVEL, Netlist::CONE };
+	std::multiset<std::string> expected;
+	for (Levelized* node : nodes) {
+		std::string name = node->name() + ":";
+		for (Connecting* input : node->inputSpan()) {
+			name += " " + input->name();
+		}
+		expected.emplace(name);
+	}
+	remove("c17.bench.netlist");
+	parse.cache(true);
+	for (Netlist::Order order : orders) {
+		parse.order(order);
+		for (size_t i = 0; i < 2; i++) { //Written, then read.
+			Circuit* ordered = parse.Parse("c17.bench");
+			std::multiset<std::string> found;
+			for (Levelized* node : ordered->nodes()) {
+				std::string name = node->name() + ":";
+				for (Connecting* input : node->inputSpan()) {
+					name += " " + input->name();
+				}
+				found.emplace(name);
+			}
+			EXPECT_EQ(expected, found);
+			EXPECT_EQ(5, ordered->pis().size());
+			EXPECT_EQ(2, ordered->pos().size());
+			delete ordered;
+		}
+	}
+	remove("c17.bench.netlist");
+}
@@ -0,0 +1,154 @@
+/**
+ * @file Tokenizer.hpp
+ * @author Spencer Millican (millican@auburn.edu)
+ * @version 0.1
+ * @date 2020-06-01
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#ifndef Tokenizer_h
+#define Tokenizer_h
+
+#include <string>
+#include <vector>
+#include <cstring>
+
+/*
+ * A (non-owning) view of characters, e.g., a token of a file.
+ *
+ * The characters must outlive the token.
+ */
+struct Token {
+	/*
+	 * The first character.
+	 */
+	const char* data = nullptr;
+
+	/*
+	 * The number of characters.
+	 */
+	size_t size = 0;
+
+	Token() = default;
+
+	Token(const char* _data, size_t _size) : data(_data), size(_size) {}
+
+	bool operator==(const Token & _other) const {
+		return this->size == _other.size && (this->size == 0 || memcmp(this->data, _other.data, this->size) == 0);
+	}
+
+	bool operator!=(const Token & _other) const {
+		return !(*this == _other);
+	}
+
+	/*
+	 * Is this token a given (null-terminated) string?
+	 *
+	 * @param _string The string to compare to.
+	 * @return True if the characters are the same.
+	 */
+	bool is(const char* _string) const {
+		return *this == Token(_string, strlen(_string));
+	}
+
+	/*
+	 * A copy of the characters.
+	 *
+	 * @return The token as a string.
+	 */
+	std::string str() const {
+		return std::string(this->data, this->size);
+	}
+};
+
+/*
+ * Hashes the characters of a Token (FNV-1a).
+ */
+struct TokenHash {
+	size_t operator()(const Token & _token) const {
+		unsigned long long int hash = 14695981039346656037ULL;
+		for (size_t i = 0; i < _token.size; i++) {
+			hash ^= (unsigned char)_token.data[i];
+			hash *= 1099511628211ULL;
+		}
+		return (size_t)hash;
+	}
+};
+
+/*
+ * Splits text into lines, and lines into tokens, without copying.
+ *
+ * Tokens are separated by any number of delimiter characters. Lines end with
+ * "\n" (a "\r" before it is a delimiter).
+ */
+class Tokenizer {
+public:
+	/*
+	 * Tokenize text.
+	 *
+	 * @param _data The text (which must outlive the tokenizer).
+	 * @param _size The number of characters of text.
+	 * @param _delimiters The (null-terminated) characters which separate tokens.
+	 */
+	Tokenizer(const char* _data, size_t _size, const char* _delimiters) {
+		this->position_ = _data;
+		this->end_ = _data + _size;
+		memset(this->delimiter_, 0, sizeof(this->delimiter_));
+		for (const char* delimiter = _delimiters; *delimiter != '\0'; delimiter++) {
+			this->delimiter_[(unsigned char)*delimiter] = true;
+		}
+		this->delimiter_[(unsigned char)'\n'] = true;
+	}
+
+	/*
+	 * Read the tokens of the next line.
+	 *
+	 * @param _tokens The tokens of the line (replaced, empty for blank lines).
+	 * @return False if there are no more lines.
+	 */
+	bool next(std::vector<Token> & _tokens) {
+		_tokens.clear();
+		if (this->position_ >= this->end_) {
+			return false;
+		}
+		const char* lineEnd = (const char*)memchr(this->position_, '\n', (size_t)(this->end_ - this->position_));
+		if (lineEnd == nullptr) {
+			lineEnd = this->end_;
+		}
+		const char* position = this->position_;
+		while (position < lineEnd) {
+			while (position < lineEnd && this->delimiter_[(unsigned char)*position]) {
+				position++;
+			}
+			const char* start = position;
+			while (position < lineEnd && this->delimiter_[(unsigned char)*position] == false) {
+				position++;
+			}
+			if (position != start) {
+				_tokens.push_back(Token(start, (size_t)(position - start)));
+			}
+		}
+		this->position_ = lineEnd + (lineEnd < this->end_ ? 1 : 0);
+		return true;
+	}
+
+private:
+	/*
+	 * The start of the next line.
+	 */
+	const char* position_;
+
+	/*
+	 * The end of the text.
+	 */
+	const char* end_;
+
+	/*
+	 * Is a character a delimiter?
+	 */
+	bool delimiter_[256];
+};
+
+#endif
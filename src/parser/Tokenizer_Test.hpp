@@ -0,0 +1,57 @@
+/**
+ * @file Tokenizer_Test.hpp
+ * @author Spencer Millican (millican@auburn.edu)
+ * @version 0.1
+ * @date 2020-06-01
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#include "gtest/gtest.h"
+#include "Tokenizer.hpp"
+
+#include <string>
+#include <vector>
+
+TEST(TokenizerTest, LineTest) {
+	std::string text = "# 4 inputs\r\nINPUT(G0)\n\nG8 = AND(G14, G6)\r\nOUTPUT(G17)";
+	Tokenizer tokenizer(text.data(), text.size(), " (,)=\r");
+	std::vector<Token> tokens;
+
+	ASSERT_TRUE(tokenizer.next(tokens));
+	ASSERT_EQ(3, tokens.size());
+	EXPECT_EQ("#", tokens.at(0).str());
+
+	ASSERT_TRUE(tokenizer.next(tokens));
+	ASSERT_EQ(2, tokens.size());
+	EXPECT_TRUE(tokens.at(0).is("INPUT"));
+	EXPECT_EQ("G0", tokens.at(1).str());
+
+	ASSERT_TRUE(tokenizer.next(tokens)); //Blank line.
+	EXPECT_EQ(0, tokens.size());
+
+	ASSERT_TRUE(tokenizer.next(tokens));
+	ASSERT_EQ(4, tokens.size());
+	EXPECT_EQ("G8", tokens.at(0).str());
+	EXPECT_EQ("AND", tokens.at(1).str());
+	EXPECT_EQ("G6", tokens.at(3).str()); //"\r" is a delimiter.
+	EXPECT_EQ(text.data() + text.find("G14"), tokens.at(2).data); //Tokens are not copied.
+
+	ASSERT_TRUE(tokenizer.next(tokens)); //No final "\n".
+	ASSERT_EQ(2, tokens.size());
+	EXPECT_EQ("G17", tokens.at(1).str());
+
+	EXPECT_FALSE(tokenizer.next(tokens));
+}
+
+TEST(TokenizerTest, HashTest) {
+	std::string text = "G1 G1 G10";
+	Token first(text.data(), 2);
+	Token second(text.data() + 3, 2);
+	Token third(text.data() + 6, 3);
+	EXPECT_TRUE(first == second);
+	EXPECT_TRUE(first != third);
+	EXPECT_EQ(TokenHash()(first), TokenHash()(second));
+	EXPECT_TRUE(Token().is(""));
+}
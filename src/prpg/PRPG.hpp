@@ -67,6 +67,21 @@ public:
 	 */
 	std::vector<_valueType> load();
 
+	/*
+	 * Advance the PRPG by a given number of loads without generating them.
+	 *
+	 * The LFSR is jumped ahead directly (by raising its GF(2) transition matrix
+	 * to the needed power), so skipping is logarithmic in the number of loads.
+	 * The next call to load() will return the same vector as if the skipped
+	 * loads had been performed one-by-one.
+	 *
+	 * NOTE: The last-returned vector is not updated, so increment() should not
+	 *       be called until after the next load().
+	 *
+	 * @param _loads The number of loads to skip.
+	 */
+	void skip(unsigned long long int _loads);
+
 private:
 	/*
 	 * The current state of the PRPG.
@@ -182,4 +197,50 @@ inline std::vector<_valueType> PRPG<_valueType>::load() {
 	return this->increment(); //NOTE: see the above note on "-1".
 }
 
+template<class _valueType>
+inline void PRPG<_valueType>::skip(unsigned long long int _loads) {
+	//A single LFSR shift is linear over GF(2), so it is represented as a
+	//64x64 bit-matrix. Each entry of "shift" is the column for one state bit,
+	//i.e., the result of shifting a state where only that bit is set.
+	typedef std::vector<unsigned long long int> Matrix;
+	auto apply = [](const Matrix& _matrix, unsigned long long int _state) {
+		unsigned long long int toReturn = 0;
+		for (size_t bit = 0; bit < 64; bit++) {
+			if ((_state >> bit) & 0x1) {
+				toReturn = toReturn ^ _matrix.at(bit);
+			}
+		}
+		return toReturn;
+	};
+	auto multiply = [&apply](const Matrix& _a, const Matrix& _b) {
+		Matrix toReturn(64);
+		for (size_t bit = 0; bit < 64; bit++) {
+			toReturn[bit] = apply(_a, _b.at(bit));
+		}
+		return toReturn;
+	};
+
+	Matrix shift(64);
+	for (size_t bit = 0; bit < 64; bit++) {
+		unsigned long long int state = (unsigned long long int)1 << bit;
+		shift[bit] = (state >> 1) | (state << 63);
+		if (bit == 0) {
+			shift[bit] = shift[bit] ^ this->exp_;
+		}
+	}
+
+	//Every load is "size" shifts of the LFSR (see load()). Overflow is not
+	//checked for: the LFSR's period is far beyond any simulation length.
+	unsigned long long int shifts = _loads * (unsigned long long int)this->last_.size();
+	while (shifts > 0) { //Square-and-multiply.
+		if (shifts & 0x1) {
+			this->lfsr_ = apply(shift, this->lfsr_);
+		}
+		shifts = shifts >> 1;
+		if (shifts > 0) {
+			shift = multiply(shift, shift);
+		}
+	}
+}
+
 #endif //PRPG_h
\ No newline at end of file
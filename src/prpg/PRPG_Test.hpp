@@ -106,6 +106,19 @@ TEST_F(PRPGTest, BinaryValuesTest) {
 	EXPECT_EQ(secondLoad, excpectedSecondLoad);
 }
 
+//TEST: Will skipping loads give the same vectors as performing them?
+TEST_F(PRPGTest, SkipTest) {
+	PRPG<Value<unsigned long long int>> skipped = PRPG<Value<unsigned long long int>>(3);
+	PRPG<Value<unsigned long long int>> loaded = PRPG<Value<unsigned long long int>>(3);
+	for (unsigned long long int loads : { 0, 1, 5, 1000 }) {
+		skipped.skip(loads);
+		for (unsigned long long int i = 0; i < loads; i++) {
+			loaded.load();
+		}
+		EXPECT_EQ(skipped.load(), loaded.load());
+	}
+}
+
 //This test is no longer implmented becuase of long long int accuracy issues: the excel spreadsheet which generated
 //the testing values converted floating to int, and therefore large numbers were not accurate. However, results
 //were manually checked.
@@ -119,10 +119,10 @@ public:
 	) {
 		std::vector<_lineType*> lines;
 		for (_nodeType* node : _nodes) {
-			if (node->outputs().size() != 1) {
+			if (node->outputSpan().size() != 1) {
 				throw "Cannot make a combination from nodes which do not have 1 output.";
 			}
-			_lineType* outputLine = dynamic_cast<_lineType*>(*(node->outputs().begin()));
+			_lineType* outputLine = dynamic_cast<_lineType*>(node->outputSpan()[0]);
 			if (outputLine == nullptr) {
 				throw "Combination line is not of the right type.";
 			}
@@ -159,7 +159,7 @@ public:
 	 * @return The evaluated value of this object (will always be the default Value).
 	 */
 	virtual _valueType value(std::vector<_valueType> _values) {
-		if (this->inputs().size() == 0) {
+		if (this->inputSpan().size() == 0) {
 			return _valueType();
 			//DELETE: flawed. throw "This combination has already been seen.";
 		}
@@ -194,7 +194,7 @@ public:
 	 * @return True if the combination has been seen.
 	 */
 	virtual bool success() {
-		return this->inputs().size() == 0;
+		return this->inputSpan().size() == 0;
 	};
 
 	/*
@@ -275,12 +275,12 @@ public:
 	 */
 	static std::unordered_set<Combination<_lineType, _nodeType, _valueType>*> allNodeCombinations(_nodeType* _node) {
 		std::unordered_set<Combination<_lineType, _nodeType, _valueType>*> toReturn;
-		std::vector<_valueType> inputValues(_node->inputs().size(), _valueType(0));
+		std::vector<_valueType> inputValues(_node->inputSpan().size(), _valueType(0));
 		if (inputValues.size() == 0) {
 			return toReturn;
 		}
 		std::vector<_lineType*> inputLines;
-		for (Connecting* input : _node->inputs()) {
+		for (Connecting* input : _node->inputSpan()) {
 			_lineType* inputCast = dynamic_cast<_lineType*>(input);
 			inputLines.push_back(inputCast);
 		}
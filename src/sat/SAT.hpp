@@ -11,13 +11,14 @@
 #ifndef SAT_h
 #define SAT_h
 
-#include <ctime>
 #include <algorithm>
+#include <limits>
 
 #include "sat/Goal.hpp"
 #include "sat/ImplicationStack.hpp"
 #include "sat/Backtracer.hpp"
 #include "simulation/EventQueue.hpp"
+#include "timing/Timing.hpp"
 
 
 /*
@@ -34,7 +35,7 @@ public:
 	 * @param _limit Time limit (in seconds).
 	 */
 	SAT(int _limit) {
-		this->limit_ = _limit * CLOCKS_PER_SEC;
+		this->limit_ = _limit;
 	}
 
 	SAT() = default;
@@ -77,10 +78,10 @@ public:
 		Goal<_valueType>* _goal
 	) {
 		//1. Setup
-		std::clock_t startTime = this->setup();
+		Deadline deadline = this->setup();
 		ImplicationStack<_valueType> implicationStack;
 
-		while (this->timeLeft(startTime) == true) {
+		while (this->timeLeft(deadline) == true) {
 			if (_goal->success()) { //Goal complete: return success
 				implicationStack.backtrack(true).process(); //clean the circuit back to an X state.
 				this->clean();
@@ -104,22 +105,30 @@ public:
 	}
 
 	/*
-	 * With the current clock, is there time left?
+	 * Is there time left before a given deadline?
 	 *
-	 * @param The start time of a given process.
+	 * @param _deadline The deadline of a given process.
 	 * @return True if there is time left.
 	 */
-	bool timeLeft(clock_t _time) {
-		if ((clock() - _time) < this->limit_) {
-			return true;
-		}
-		return false;
+	bool timeLeft(const Deadline & _deadline) {
+		return _deadline.expired() == false;
+	}
+
+	/*
+	 * Set an outer deadline which every SAT operation will honor along with
+	 * the per-combination time limit (e.g., a time budget for an entire run).
+	 *
+	 * @param _deadline The outer deadline.
+	 */
+	void deadline(Deadline _deadline) {
+		this->outerDeadline_ = _deadline;
 	}
 
 	/*
-	* The per-combination time limit of this object (in clock ticks).
+	* The per-combination time limit of this object (in seconds). By default,
+	* there is no limit.
 	*/
-	clock_t limit_;
+	double limit_ = std::numeric_limits<double>::max();
 
 private:
 	/*
@@ -134,14 +143,18 @@ private:
 	 *
 	 * @param _coi The cone-of-influence which needs to be reset. May be empty.
 	 * @param _combination The combination to set-up for.
-	 * @return The time when setup is complete.
+	 * @return The deadline of the SAT operation (starting when setup is complete).
 	 */
-	std::clock_t setup(
+	Deadline setup(
 	) {
-		std::clock_t startTime = std::clock();
-		return startTime;
+		return Deadline(this->limit_).earliest(this->outerDeadline_);
 	}
 
+	/*
+	 * An outer deadline to honor (by default, never).
+	 */
+	Deadline outerDeadline_;
+
 	/*
 	 * The backtracer algorithm to use.
 	 */
@@ -18,6 +18,7 @@
 
 #include "simulation/Value.hpp"
 #include "Level.h"
+#include "timing/Counters.hpp"
 
 //Forward declaration: Event <-> Evented are cross dependent.
 template <class _valueType>
@@ -233,7 +234,7 @@ Evented<_valueType>::Evented(
 template <class _valueType>
 std::vector<_valueType> inputValues(Evented<_valueType>* _obj) {
 	std::vector <_valueType> values;
-	for (Connecting* input : _obj->inputs()) {
+	for (Connecting* input : _obj->inputSpan()) {
 		Evented<_valueType>* cast = dynamic_cast<Evented<_valueType>*>(input);
 		values.push_back(cast->value());
 	}
@@ -260,7 +261,7 @@ std::vector<Event<_valueType>> Evented<_valueType>::go(
 	}
 	std::vector<Event<_valueType>> toReturn;
 	if (oldValue != newValue) { //Value changed, so change line values and update the queue.
-		for (Connecting* output : this->outputs()) {
+		for (Connecting* output : this->outputSpan()) {
 			Evented<_valueType>* cast = dynamic_cast<Evented<_valueType>*>(output);
 			toReturn.push_back( cast->selfAsEvent() );
 		}
@@ -290,6 +291,7 @@ inline void EventQueue<_valueType>::populateLevels(size_t _levels) {
 
 template <class _valueType>
 void EventQueue<_valueType>::add(Event<_valueType> _event) {
+	COUNT(EVENTS_QUEUED);
 	this->populateLevels(_event.priority()); //Queue levels may be populated.
 	this->queue_.at(_event.priority()).push_back(_event.location());
 }
@@ -309,15 +311,16 @@ bool EventQueue<_valueType>::process() {
 
 	for (size_t currentLevel = 0; currentLevel <= maxLevel_; currentLevel++) {
 		std::vector<Evented<_valueType>*> events = this->queue_.at(currentLevel);
-		#pragma omp parallel for
-		for (int eventNum = 0; eventNum < events.size(); eventNum++) {
+		//Serial: simulations are run in parallel per fault simulation iteration
+		//(each on its own circuit), and events may not be processed concurrently.
+		for (size_t eventNum = 0; eventNum < events.size(); eventNum++) {
 			Evented<_valueType>* currentEvent = events.at(eventNum);
+			COUNT(EVENTS_PROCESSED);
 			std::vector<Event<_valueType>> newEvents = currentEvent->go();
 			for (Event<_valueType> toAdd : newEvents) {
 				if (toAdd.priority() <= currentLevel) {
 					throw "EventQueue can only add events during processing 'in order'.";
 				}
-				#pragma omp critical 
 				this->add(toAdd);
 			}
 		}
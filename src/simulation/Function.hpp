@@ -19,6 +19,7 @@
 
 #include "simulation/Value.hpp"
 #include "Connection.h"
+#include "timing/Counters.hpp"
 
 template <class T>
 class Value;
@@ -311,6 +312,7 @@ inline Function<_valueType>* BooleanFunction<_valueType>::clone() const {
 
 template<class _valueType>
 _valueType BooleanFunction<_valueType>::evaluate(std::vector<_valueType> _vector) const {
+	COUNT(GATE_EVALUATIONS);
 	return (this->*function_)(_vector);
 }
 
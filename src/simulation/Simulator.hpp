@@ -157,8 +157,7 @@ std::vector<_valueType> Simulator<_valueType>::outputs(
 			continue;
 		}
 		SimulationNode<_valueType>* output = _outputs.at(i);
-		std::unordered_set<Connecting*> lines = output->inputs();
-		SimulationLine<_valueType>* outputLine = dynamic_cast<SimulationLine<_valueType>*>(*(lines.begin()));
+		SimulationLine<_valueType>* outputLine = dynamic_cast<SimulationLine<_valueType>*>(output->inputSpan()[0]);
 		toReturn.push_back(outputLine->value());
 	}
 	return toReturn;
@@ -169,6 +169,20 @@ public:
 	 */
 	static std::vector<_valueType> random(size_t _size, std::vector<float> _weights = std::vector<float>());
 
+	/*
+	 * Create a random vector (see above) from a given random engine.
+	 *
+	 * Unlike the above (which shares a single engine), this can be used from
+	 * multiple threads, and the vectors generated by one engine do not depend
+	 * on any other vectors generated.
+	 *
+	 * @param _size The size of the vector to return.
+	 * @param (reference) _engine The random engine to use.
+	 * @param (optional) _weights The weight assigned to each input, by default, "50%".
+	 * @return The generated random vector.
+	 */
+	static std::vector<_valueType> random(size_t _size, std::default_random_engine & _engine, std::vector<float> _weights = std::vector<float>());
+
 	/*
 	 * Shift a vector left.
 	 *
@@ -232,7 +246,7 @@ private:
 
 
 template<>
-inline std::vector<Value<bool>> ValueVectorFunction<Value<bool>>::random(size_t _size, std::vector<float> _weights) {
+inline std::vector<Value<bool>> ValueVectorFunction<Value<bool>>::random(size_t _size, std::default_random_engine & _engine, std::vector<float> _weights) {
 	if (_weights.size() == 0) {
 		_weights = std::vector<float>(_size, 0.5);
 	}
@@ -240,14 +254,19 @@ inline std::vector<Value<bool>> ValueVectorFunction<Value<bool>>::random(size_t
 		throw "Cannot generate random vector: incorrect number of weights given";
 	}
 	std::vector<Value<bool>> toReturn;
-	static std::default_random_engine e;
 	for (size_t a = 0; a < _weights.size(); a++) {
 		std::bernoulli_distribution b(_weights.at(a));
-		toReturn.push_back(Value<bool>(b(e)));
+		toReturn.push_back(Value<bool>(b(_engine)));
 	}
 	return toReturn;
 }
 
+template<>
+inline std::vector<Value<bool>> ValueVectorFunction<Value<bool>>::random(size_t _size, std::vector<float> _weights) {
+	static std::default_random_engine e;
+	return ValueVectorFunction<Value<bool>>::random(_size, e, _weights);
+}
+
 //template<>
 //inline std::vector<FaultyValue<bool>> ValueVectorFunction<FaultyValue<bool>>::random(size_t _size, std::vector<float> _weights) {
 //	if (_weights.size() == 0) {
@@ -269,6 +288,12 @@ inline std::vector<Value<bool>> ValueVectorFunction<Value<bool>>::random(size_t
 //      declarations, but it will be inefficient.
 template<class _valueType>
 inline std::vector<_valueType> ValueVectorFunction<_valueType>::random(size_t _size, std::vector<float> _weights) {
+	static std::default_random_engine e;
+	return ValueVectorFunction<_valueType>::random(_size, e, _weights);
+}
+
+template<class _valueType>
+inline std::vector<_valueType> ValueVectorFunction<_valueType>::random(size_t _size, std::default_random_engine & _engine, std::vector<float> _weights) {
 	if (_weights.size() == 0) {
 		_weights = std::vector<float>(_size, 0.5);
 	}
@@ -276,7 +301,6 @@ inline std::vector<_valueType> ValueVectorFunction<_valueType>::random(size_t _s
 		throw "Cannot generate random vector: incorrect number of weights given";
 	}
 	std::vector<_valueType> toReturn;
-	static std::default_random_engine e;
 	for (size_t a = 0; a < _weights.size(); a++) {
 		//std::bernoulli_distribution b(_weights.at(a));
 		//unsigned long long int num = rand(); //Only 16 bits, because, why not make things confusing.
@@ -284,14 +308,12 @@ inline std::vector<_valueType> ValueVectorFunction<_valueType>::random(size_t _s
 		//num = num << 16; num = num | rand();
 	 //   num = num << 16; num = num | rand();
 		//toReturn.push_back(_valueType(num));
-		static std::default_random_engine e;		
-		
 			unsigned long long int num = 0x0000000000000000;
 			
 			std::bernoulli_distribution b(_weights.at(a));
 			for (size_t i = 0; i < 64; i++)
 			{
-				unsigned long long int weight_rand = (b(e));
+				unsigned long long int weight_rand = (b(_engine));
 				//printf("%llu", weight_rand);
 				num = num | weight_rand;
 				num = num << 1;
@@ -11,128 +11,104 @@
 #include "Circuit.h"
 
 #include <map>
-
- //On a given clonable, levelized object, go both forward and backwards to 
- //create and connect objects until the given stopping points are reached.
- //
- //@returns A new object which is created or a nullptr.
-Connecting* spread(
-	Connecting* point,
-	std::map<Connecting*, Connecting*> & oldToNew,
-	std::map<Connecting*, Connecting*> & newToOld,
-	bool forwards = true,
-	bool backwards = true
-) {
-	//If we already have seen the point, don't go any further.
-	if (
-		(forwards == true && backwards == true) &&
-		oldToNew.find(point) != oldToNew.end()
-		) {
-		return nullptr;
+#include <utility>
+#include <unordered_map>
+#include <vector>
+
+void Circuit::copy(const std::unordered_set<Levelized*> & _nodes, const std::unordered_set<Levelized*> & _pis, const std::unordered_set<Levelized*> & _pos, std::map<Connecting*, Connecting*>* _oldToNew) {
+	//FIRST, number every object reachable from the given nodes (breadth-first,
+	//not recursively: deep circuits would overflow the stack). The outputs of
+	//each object are recorded by number, i.e., objects[i] drives
+	//objects[outputs[firstOutput[i], firstOutput[i + 1])], and so are its
+	//inputs (in the same way).
+	std::unordered_map<Connecting*, size_t> ids;
+	std::vector<Connecting*> objects;
+	ids.reserve(3 * _nodes.size());
+	objects.reserve(3 * _nodes.size());
+	auto number = [&](Connecting* _object) {
+		auto inserted = ids.emplace(_object, objects.size());
+		if (inserted.second == true) {
+			objects.push_back(_object);
+		}
+		return inserted.first->second;
+	};
+	for (Levelized* node : _nodes) { number(node); }
+	for (Levelized* pi : _pis) { number(pi); }
+	for (Levelized* po : _pos) { number(po); }
+	std::vector<size_t> firstOutput;
+	std::vector<size_t> outputs;
+	std::vector<size_t> firstInput;
+	std::vector<size_t> inputs;
+	firstOutput.reserve(objects.capacity() + 1);
+	outputs.reserve(objects.capacity());
+	firstInput.reserve(objects.capacity() + 1);
+	inputs.reserve(objects.capacity());
+	for (size_t i = 0; i < objects.size(); i++) {
+		firstOutput.push_back(outputs.size());
+		firstInput.push_back(inputs.size());
+		for (Connection* input : objects[i]->inputs_) {
+			inputs.push_back(number(input->input()));
+		}
+		for (Connection* output : objects[i]->outputs_) {
+			outputs.push_back(number(output->output()));
+		}
 	}
-
-	Connecting* newPoint = point;
-	if (forwards == true && backwards == true) {
-		newPoint = point->clone();
-		newToOld[newPoint] = point;
-		oldToNew[point] = newPoint;
+	firstOutput.push_back(outputs.size());
+	firstInput.push_back(inputs.size());
+
+	//SECOND, clone every object (by number) and make every connection. Clones
+	//hold nothing derived from their connections, so nothing needs to be
+	//cleared when connecting them (as when Nodes are connected while they are
+	//constructed).
+	std::vector<Connecting*> clones(objects.size());
+	for (size_t i = 0; i < objects.size(); i++) {
+		clones[i] = objects[i]->clone();
 	}
-
-	//For each input, attempt to spread and connect.
-	if (backwards == true) {
-		for (Connecting* input : point->inputs()) {
-			Connecting* newInputConnection = spread(input, oldToNew, newToOld);
-			//if (newInputConnection != nullptr) {
-			//	newPoint->addInput(newInputConnection);
-			//	//newPoint->removeInput(newToOld.find(newInputConnection)->second);
-			//}
+	for (size_t i = 0; i < objects.size(); i++) {
+		for (size_t j = firstOutput[i]; j < firstOutput[i + 1]; j++) {
+			new Connection(clones[i], clones[outputs[j]], false);
 		}
 	}
-
-	//For each output, attempt to spread and connect.
-	if (forwards == true) {
-		for (Connecting* output : point->outputs()) {
-			Connecting* newOutputConnection = spread(output, oldToNew, newToOld);
-			//if (newOutputConnection != nullptr) {
-			//	newPoint->addOutput(newOutputConnection);
-			//	//newPoint->removeOutput(newToOld.find(newOutputConnection)->second);
-			//}
+	//Connections were made in the order of outputs: put the inputs of every
+	//clone back in the order of the original (e.g., the pin order of gates).
+	for (size_t i = 0; i < objects.size(); i++) {
+		SmallVector<Connection*, 4> & cloneInputs = clones[i]->inputs_;
+		for (size_t j = 0; j < cloneInputs.size(); j++) {
+			Connecting* input = clones[inputs[firstInput[i] + j]];
+			size_t k = j;
+			while (k + 1 < cloneInputs.size() && cloneInputs[k]->input() != input) {
+				k++;
+			}
+			std::swap(cloneInputs[j], cloneInputs[k]);
 		}
 	}
 
-	return newPoint;
-}
-
-void Circuit::copy(std::unordered_set<Levelized*> _nodes, std::unordered_set<Levelized*> _pis, std::unordered_set<Levelized*> _pos) {
-	std::map<Connecting*, Connecting*> oldToNew;
-	std::map<Connecting*, Connecting*> newToOld;
-
-	//First, set all PIs and POs of the circuit.
-	for (Levelized* pi : _pis) {
-		Levelized* newNode = dynamic_cast<Levelized*>(pi->clone());
-		//Not needed //this->addNode(newNode);
-		this->addPI(newNode);
-		newToOld[newNode] = pi;
-		oldToNew[pi] = newNode;
-	}
-	for (Levelized* po : _pos) {
-		Levelized* newNode = dynamic_cast<Levelized*>(po->clone());
-		//Not needed //this->addNode(newNode);
-		this->addPO(newNode);
-		newToOld[newNode] = po;
-		oldToNew[po] = newNode;
+	//THIRD, keep all (known) levels.
+	for (size_t i = 0; i < objects.size(); i++) {
+		Levelized* object = dynamic_cast<Levelized*>(objects[i]);
+		Levelized* clone = dynamic_cast<Levelized*>(clones[i]);
+		if (object != nullptr && clone != nullptr) {
+			clone->copyLevels(object);
+		}
 	}
 
-	//Spread to populate the circuit.
+	this->nodes_.reserve(_nodes.size());
 	for (Levelized* pi : _pis) {
-		spread(pi, oldToNew, newToOld, true, false);
+		this->addPI(dynamic_cast<Levelized*>(clones[ids.at(pi)]));
 	}
 	for (Levelized* po : _pos) {
-		spread(po, oldToNew, newToOld, false, true);
+		this->addPO(dynamic_cast<Levelized*>(clones[ids.at(po)]));
 	}
-
-
-	//Go through old nodes to make this circuit's new nodes.
-	for (Levelized* oldNode : _nodes) {
-		Levelized* newNode = dynamic_cast<Levelized*>(oldToNew.at(oldNode));
-		this->addNode(newNode);
+	for (Levelized* node : _nodes) {
+		this->addNode(dynamic_cast<Levelized*>(clones[ids.at(node)]));
 	}
 
-	////DEBUG DUMP:
-	//for (auto objs : oldToNew) {
-	//	Connecting* oldObj = objs.first;
-	//	Connecting* newObj = objs.second;
-	//	printf("%s -> %s, %d->%d, %d->%d\n", 
-	//		   oldObj->name().c_str(), newObj->name().c_str(),
-	//		   oldObj->inputs().size(), newObj->inputs().size(),
-	//		   oldObj->outputs().size(), newObj->outputs().size()
-	//	);
-	//	oldToNew.at(oldObj);
-	//	newToOld.at(newObj);
-	//}
-
-	//int q = 0;
-
-	//Go through old objects to make this circuit's new connections.
-	for (auto objs : oldToNew) {
-		Connecting* oldObj = objs.first;
-		Connecting* newObj = objs.second;
-		std::unordered_set<Connecting*> oldInputs = oldObj->inputs();
-		std::unordered_set<Connecting*> oldOutputs = oldObj->outputs();
-		std::unordered_set<Connecting*> newInputs;
-		std::unordered_set<Connecting*> newOutputs;
-		for (Connecting* oldInput : oldInputs) {
-			Connecting* newInput = oldToNew.at(oldInput);
-			newInputs.emplace(newInput);
-		}
-		for (Connecting* oldOutput : oldOutputs) {
-			Connecting* newOutput = oldToNew.at(oldOutput);
-			newOutputs.emplace(newOutput);
+	if (_oldToNew != nullptr) {
+		_oldToNew->clear();
+		for (size_t i = 0; i < objects.size(); i++) {
+			_oldToNew->emplace(objects[i], clones[i]);
 		}
-		newObj->inputs(newInputs);
-		newObj->outputs(newOutputs);
 	}
-
 }
 
 Circuit::Circuit(
@@ -155,7 +131,7 @@ Circuit::Circuit(
 		}
 	}
 	else {
-		this->copy(_nodes, _inputs, _outputs);
+		this->copy(_nodes, _inputs, _outputs, nullptr);
 	}
 }
 
@@ -163,9 +139,19 @@ Circuit::Circuit(
 
 Circuit::Circuit(const Circuit& _circuit) {
 	this->copy(
-		_circuit.nodes(),
-		_circuit.pis(),
-		_circuit.pos()
+		_circuit.nodes_,
+		_circuit.pis_,
+		_circuit.pos_,
+		nullptr
+	);
+}
+
+Circuit::Circuit(const Circuit& _circuit, std::map<Connecting*, Connecting*> & _oldToNew) {
+	this->copy(
+		_circuit.nodes_,
+		_circuit.pis_,
+		_circuit.pos_,
+		&_oldToNew
 	);
 }
 
@@ -190,45 +176,26 @@ Circuit::Circuit(const Circuit& _circuit) {
 //	}
 //}
 
-void visit(
-	Levelized* _point,
-	std::unordered_set<Levelized*> & _unvisitedCircuitObjects,
-	std::unordered_set<Levelized*> & _visitedCircuitObjects
-) {
-	_unvisitedCircuitObjects.erase(_point);
-	if (_visitedCircuitObjects.find(_point) != _visitedCircuitObjects.end()) {
-		return;
-	}
-	_visitedCircuitObjects.emplace(_point);
-
-
-	for (Connecting* input : _point->inputs()) {
-		Levelized* cast = dynamic_cast<Levelized*>(input);
-		if (_visitedCircuitObjects.find(cast) != _visitedCircuitObjects.end()) {
-			_unvisitedCircuitObjects.emplace(cast);
+Circuit::~Circuit() {
+	//Every object reachable (forward) from the nodes of the circuit is deleted.
+	//Objects are found breadth-first (see "copy"), reading Connections directly.
+	std::unordered_set<Connecting*> found;
+	std::vector<Connecting*> objects;
+	found.reserve(3 * this->nodes_.size());
+	objects.reserve(3 * this->nodes_.size());
+	for (Levelized* node : this->nodes_) {
+		if (found.emplace(node).second == true) {
+			objects.push_back(node);
 		}
 	}
-	for (Connecting* output : _point->outputs()) {
-		Levelized* cast = dynamic_cast<Levelized*>(output);
-		_unvisitedCircuitObjects.emplace(cast);
-		if (_visitedCircuitObjects.find(cast) != _visitedCircuitObjects.end()) {
-			_unvisitedCircuitObjects.emplace(cast);
+	for (size_t i = 0; i < objects.size(); i++) {
+		for (Connection* output : objects[i]->outputs_) {
+			if (found.emplace(output->output()).second == true) {
+				objects.push_back(output->output());
+			}
 		}
 	}
-}
-
-Circuit::~Circuit() {
-	std::unordered_set<Levelized*> unvisitedCircuitObjects = this->nodes_;
-	std::unordered_set<Levelized*> visitedCircuitObjects;
-	while (unvisitedCircuitObjects.empty() == false) {
-		Levelized* curCircuitObject = *(unvisitedCircuitObjects.begin());
-		visit(curCircuitObject, unvisitedCircuitObjects, visitedCircuitObjects);
-	}
-	//DELETE: see "spread" comment
-	/*for (Levelized* node : this->nodes_) {
-		spread(node, allCircuitObjects);
-	}*/
-	for (Levelized* object : visitedCircuitObjects) {
+	for (Connecting* object : objects) {
 		delete object;
 	}
 }
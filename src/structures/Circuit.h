@@ -53,10 +53,27 @@ public:
 	 * NOTE: If the "clone" function is not properly support for the type of nodes
 	 *       and lines in the circuit, lower-level forms will be created.
 	 *
+	 * Copying takes O(V+E) time and does not recurse (see "copy"), so large
+	 * circuits can be copied from any thread.
+	 *
 	 * @param _circuit The Circuit to copy.
 	 */
 	Circuit(const Circuit& _circuit);
 
+	/*
+	 * Create a copy of a given circuit (see the copy constructor) and report
+	 * which object (node or line) of the copy was created from which object of
+	 * the given circuit.
+	 *
+	 * This is needed to move objects which refer to circuit locations (e.g.,
+	 * faults and testpoints) onto the copy.
+	 *
+	 * @param _circuit The Circuit to copy.
+	 * @param _oldToNew Will be filled with each object of the given circuit and
+	 *        the object of the copy which was created from it.
+	 */
+	Circuit(const Circuit& _circuit, std::map<Connecting*, Connecting*> & _oldToNew);
+
 	/*
 	 * Delete the circuit and all objects in it.
 	 *
@@ -159,11 +176,18 @@ private:
 	/*
 	 * Make this circuit an identical copy of another circuit form a given set 
 	 * of pis, pos, and nodes.
+	 *
+	 * Every object (node and line) is cloned once and every connection is made
+	 * once, i.e., copying takes O(V+E) time. Names and (known) levels are kept.
+	 *
+	 * @param _oldToNew (optional) Will be filled with each copied object and
+	 *        its copy.
 	 */
 	void copy(
-		std::unordered_set<Levelized*> _nodes,
-		std::unordered_set<Levelized*> _pis,
-		std::unordered_set<Levelized*> _pos
+		const std::unordered_set<Levelized*> & _nodes,
+		const std::unordered_set<Levelized*> & _pis,
+		const std::unordered_set<Levelized*> & _pos,
+		std::map<Connecting*, Connecting*>* _oldToNew
 	);
 
 	/*
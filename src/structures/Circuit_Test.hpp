@@ -88,6 +88,60 @@ TEST_F(CopyTest, c17CopyTest) {
 	} while (ValueVectorFunction<Value<bool>>::increment(inputVector));
 }
 
+//A copy has the same structure (names, connections and levels) and no objects of the original.
+TEST_F(CopyTest, StructureTest) {
+	for (Levelized* node : c17->nodes()) {
+		node->inputLevel();
+	}
+	std::map<Connecting*, Connecting*> oldToNew;
+	Circuit* copy = new Circuit(*c17, oldToNew);
+	EXPECT_EQ(c17->nodes().size(), copy->nodes().size());
+	EXPECT_EQ(c17->pis().size(), copy->pis().size());
+	EXPECT_EQ(c17->pos().size(), copy->pos().size());
+	for (Levelized* node : c17->nodes()) {
+		EXPECT_EQ(1, copy->nodes().count(dynamic_cast<Levelized*>(oldToNew.at(node))));
+	}
+	for (std::pair<Connecting* const, Connecting*> objects : oldToNew) {
+		Connecting* original = objects.first;
+		Connecting* clone = objects.second;
+		EXPECT_NE(original, clone);
+		EXPECT_EQ(original->name(), clone->name());
+		std::unordered_set<Connecting*> inputs;
+		for (Connecting* input : original->inputs()) {
+			inputs.emplace(oldToNew.at(input));
+		}
+		std::unordered_set<Connecting*> outputs;
+		for (Connecting* output : original->outputs()) {
+			outputs.emplace(oldToNew.at(output));
+		}
+		EXPECT_EQ(inputs, clone->inputs());
+		EXPECT_EQ(outputs, clone->outputs());
+		EXPECT_EQ(dynamic_cast<Levelized*>(original)->inputLevelConst(), dynamic_cast<Levelized*>(clone)->inputLevelConst());
+	}
+	delete copy;
+}
+
+//A copy keeps the order of every object's inputs and outputs (e.g., the pin order of gates).
+TEST_F(CopyTest, OrderTest) {
+	std::map<Connecting*, Connecting*> oldToNew;
+	Circuit* copy = new Circuit(*c17, oldToNew);
+	for (std::pair<Connecting* const, Connecting*> objects : oldToNew) {
+		ConnectingSpan originalInputs = objects.first->inputSpan();
+		ConnectingSpan cloneInputs = objects.second->inputSpan();
+		ASSERT_EQ(originalInputs.size(), cloneInputs.size());
+		for (size_t i = 0; i < originalInputs.size(); i++) {
+			EXPECT_EQ(oldToNew.at(originalInputs[i]), cloneInputs[i]);
+		}
+		ConnectingSpan originalOutputs = objects.first->outputSpan();
+		ConnectingSpan cloneOutputs = objects.second->outputSpan();
+		ASSERT_EQ(originalOutputs.size(), cloneOutputs.size());
+		for (size_t i = 0; i < originalOutputs.size(); i++) {
+			EXPECT_EQ(oldToNew.at(originalOutputs[i]), cloneOutputs[i]);
+		}
+	}
+	delete copy;
+}
+
 class Circuit_Test : public ::testing::Test {
 public:
 	void SetUp() override {
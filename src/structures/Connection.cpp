@@ -12,6 +12,8 @@
 
 #include "Connection.h"
 
+#include <algorithm>
+
 Connection::Connection() {
 	throw "Invalid Connection. Must have a valid input and output.";
 }
@@ -24,11 +26,39 @@ Connection::Connection(Connecting * _input, Connecting * _output) {
 	output_->addInputConnection(this);
 }
 
+Connection::Connection(Connecting * _input, Connecting * _output, bool _notify) {
+	if (_input == nullptr || _output == nullptr) { throw "Invalid Connection. Must have a valid input and output."; }
+	input_ = _input;
+	output_ = _output;
+	if (_notify == true) {
+		input_->addOutputConnection(this);
+		output_->addInputConnection(this);
+	} else {
+		input_->Connecting::addOutputConnection(this);
+		output_->Connecting::addInputConnection(this);
+	}
+}
+
 Connection::~Connection() {
 	input_->removeOutputConnection(this, false);
 	output_->removeInputConnection(this, false);
 }
 
+void* Connection::operator new(size_t _size) {
+	if (_size != sizeof(Connection)) {
+		return ::operator new(_size);
+	}
+	return Pool<sizeof(Connection)>::allocate();
+}
+
+void Connection::operator delete(void* _connection, size_t _size) {
+	if (_size != sizeof(Connection)) {
+		::operator delete(_connection);
+		return;
+	}
+	Pool<sizeof(Connection)>::deallocate(_connection);
+}
+
 Connecting* Connection::input() const { return this->input_; }
 
 Connecting* Connection::output() const { return this->output_; }
@@ -73,6 +103,7 @@ Connecting::~Connecting() {
 
 std::unordered_set<Connecting*> Connecting::inputs() const {
 	std::unordered_set < Connecting* > ret;
+	ret.reserve(this->inputs_.size());
 	for (Connection* input : this->inputs_) {
 		ret.emplace(input->input());
 	}
@@ -80,7 +111,7 @@ std::unordered_set<Connecting*> Connecting::inputs() const {
 }
 
 std::unordered_set<Connecting*> Connecting::inputs(std::unordered_set<Connecting*> _inputs) {
-	std::unordered_set<Connection*> inputsCopy = this->inputs_;
+	SmallVector<Connection*, 4> inputsCopy = this->inputs_;
 	for (Connection* input : inputsCopy) {
 		this->removeInputConnection(input);
 
@@ -94,6 +125,7 @@ std::unordered_set<Connecting*> Connecting::inputs(std::unordered_set<Connecting
 
 std::unordered_set<Connecting*> Connecting::outputs() const {
 	std::unordered_set < Connecting* > ret;
+	ret.reserve(this->outputs_.size());
 	for (Connection* output : this->outputs_) {
 		ret.emplace(output->output());
 	}
@@ -101,7 +133,7 @@ std::unordered_set<Connecting*> Connecting::outputs() const {
 }
 
 std::unordered_set<Connecting*> Connecting::outputs(std::unordered_set<Connecting*> _outputs) {
-	std::unordered_set<Connection*> outputsCopy = this->outputs_;
+	SmallVector<Connection*, 4> outputsCopy = this->outputs_;
 	for (Connection* output : outputsCopy) {
 		this->removeOutputConnection(output);
 	}
@@ -113,7 +145,7 @@ std::unordered_set<Connecting*> Connecting::outputs(std::unordered_set<Connectin
 
 void Connecting::removeInput(Connecting * _rmv) {
 	bool found = false;
-	std::unordered_set<Connection*> toSearch = this->inputs_;
+	SmallVector<Connection*, 4> toSearch = this->inputs_;
 	for (Connection* input : toSearch) {
 		if (input->input() == _rmv) {
 			this->removeInputConnection(input);
@@ -128,7 +160,7 @@ void Connecting::removeInput(Connecting * _rmv) {
 
 void Connecting::removeOutput(Connecting * _rmv) {
 	bool found = false;
-	std::unordered_set<Connection*> toSearch = this->outputs_;
+	SmallVector<Connection*, 4> toSearch = this->outputs_;
 	for (Connection* output : toSearch) {
 		if (output->output() == _rmv) {
 			this->removeOutputConnection(output);
@@ -158,33 +190,35 @@ void Connecting::name(std::string _name) {
 }
 
 void Connecting::removeInputConnection(Connection * _rmv, bool _deleteConnection) {
-	if (this->inputs_.find(_rmv) == this->inputs_.end()) {
+	Connection** found = std::find(this->inputs_.begin(), this->inputs_.end(), _rmv);
+	if (found == this->inputs_.end()) {
 		throw "Cannot remove connection which does not exist";
 	}
 	if (_deleteConnection == true) {
-		delete _rmv;
+		delete _rmv; //The Connection removes itself from both of its objects.
+		return;
 	}
-	this->inputs_.erase(_rmv);
-
+	this->inputs_.erase(found);
 }
 
 void Connecting::removeOutputConnection(Connection * _rmv, bool _deleteConnection) {
-	if (this->outputs_.find(_rmv) == this->outputs_.end()) {
+	Connection** found = std::find(this->outputs_.begin(), this->outputs_.end(), _rmv);
+	if (found == this->outputs_.end()) {
 		throw "Cannot remove connection which does not exist";
 	}
 	if (_deleteConnection == true) {
-		delete _rmv;
+		delete _rmv; //The Connection removes itself from both of its objects.
+		return;
 	}
-	this->outputs_.erase(_rmv);
-
+	this->outputs_.erase(found);
 }
 
 void Connecting::addInputConnection(Connection * _add) {
-	this->inputs_.emplace(_add);
+	this->inputs_.push_back(_add);
 }
 
 void Connecting::addOutputConnection(Connection * _add) {
-	this->outputs_.emplace(_add);
+	this->outputs_.push_back(_add);
 }
 
 
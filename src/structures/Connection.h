@@ -14,10 +14,85 @@
 
 #include <unordered_set>
 #include <string>
+#include <iterator>
+
+#include "structures/Pool.h"
+#include "structures/SmallVector.h"
 
 class Connecting;
 class Connection;
 
+/*
+ * The objects on one side of a list of Connections, e.g., all inputs of an
+ * object, in the order they were connected.
+ *
+ * A span does not copy (or allocate) anything: it is only valid until the
+ * Connections of its object change.
+ */
+class ConnectingSpan {
+ public:
+  class iterator {
+   public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef Connecting* value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef Connecting* const* pointer;
+    typedef Connecting* reference;
+
+    iterator(Connection* const* _position, bool _inputs) : position_(_position), inputs_(_inputs) {}
+    Connecting* operator*() const;
+    iterator & operator++() { this->position_++; return *this; }
+    iterator operator++(int) { iterator toReturn = *this; this->position_++; return toReturn; }
+    bool operator==(const iterator & _other) const { return this->position_ == _other.position_; }
+    bool operator!=(const iterator & _other) const { return this->position_ != _other.position_; }
+
+   private:
+    Connection* const* position_;
+    bool inputs_;
+  };
+
+  /*
+   * Create a span of Connections.
+   *
+   * @param _connections The first Connection.
+   * @param _size The number of Connections.
+   * @param _inputs True to see the inputs of the Connections, false to see
+   *        their outputs.
+   */
+  ConnectingSpan(Connection* const* _connections, size_t _size, bool _inputs) :
+    connections_(_connections), size_(_size), inputs_(_inputs) {}
+
+  iterator begin() const { return iterator(this->connections_, this->inputs_); }
+  iterator end() const { return iterator(this->connections_ + this->size_, this->inputs_); }
+
+  /*
+   * The number of objects.
+   *
+   * @return The number of objects.
+   */
+  size_t size() const { return this->size_; }
+
+  /*
+   * Are there no objects?
+   *
+   * @return True if there are no objects.
+   */
+  bool empty() const { return this->size_ == 0; }
+
+  /*
+   * An object (by position).
+   *
+   * @param _index The position of the object.
+   * @return The object.
+   */
+  Connecting* operator[](size_t _index) const;
+
+ private:
+  Connection* const* connections_;
+  size_t size_;
+  bool inputs_;
+};
+
 /**
  * This class models any object which connects to other objects through
  * Connections.
@@ -31,7 +106,8 @@ class Connection;
  * Connections, but not Connections of an unspecified direction.
  *
  * A Connecting class can have any number of input/output Cconnections.
- * Connections can be added and removed.
+ * Connections can be added and removed. Connections are kept in the order they
+ * were made, e.g., the inputs of a gate are in the order of its pins.
  *
  */
 class Connecting {
@@ -113,6 +189,22 @@ class Connecting {
    */
   virtual std::unordered_set<Connecting*> outputs(std::unordered_set<Connecting*> _outputs);
 
+  /*
+   * Get all the input Connecting objects, in order, without copying them.
+   *
+   * @return A span of all objects which connect to this object through an
+   *         input Connection (valid until the inputs change).
+   */
+  ConnectingSpan inputSpan() const;
+
+  /*
+   * Get all the output Connecting objects, in order, without copying them.
+   *
+   * @return A span of all objects which connect to this object through an
+   *         output Connection (valid until the outputs change).
+   */
+  ConnectingSpan outputSpan() const;
+
   /*
    * Delete the input Connection which connects the given input object.
    *
@@ -175,14 +267,14 @@ class Connecting {
 private:
 
   /**
-   * This vector contains all the input connections.
+   * This vector contains all the input connections (in order).
    */
-  std::unordered_set<Connection*> inputs_;
+  SmallVector<Connection*, 4> inputs_;
 
   /**
-   * This vector contains all the output connections.
+   * This vector contains all the output connections (in order).
    */
-  std::unordered_set<Connection*> outputs_;
+  SmallVector<Connection*, 4> outputs_;
 
   /*
    * The name of this connection.
@@ -196,6 +288,13 @@ protected:
    */
   friend Connection;
 
+  /*
+   * Circuits are friends, so they can be copied by reading and adding
+   * Connections directly (without creating a set of inputs and outputs per
+   * object).
+   */
+  friend class Circuit;
+
   /*
  * Delete a given input connection
  *
@@ -307,7 +406,44 @@ class Connection {
    */
   Connecting* output() const;
 
+  /*
+   * Connections are allocated from a Pool (they are created and deleted
+   * every time a circuit is modified, e.g., by every testpoint).
+   *
+   * @param _size The size of a Connection.
+   * @return Memory for a new Connection.
+   */
+  static void* operator new(size_t _size);
+
+  /*
+   * Return the memory of a deleted Connection to the Pool.
+   *
+   * @param _connection The memory of the Connection.
+   * @param _size The size of a Connection.
+   */
+  static void operator delete(void* _connection, size_t _size);
+
  private:
+  /*
+   * Circuits are friends, so they can connect copies (see the private
+   * constructor).
+   */
+  friend class Circuit;
+
+  /*
+   * Create a new Connection without notifying the input/output through their
+   * (virtual) "add connection" functions, i.e., nothing derived from their
+   * connections (levels, COP values, etc.) is cleared.
+   *
+   * This is only valid for objects which hold nothing derived from their
+   * connections, e.g., freshly cloned objects.
+   *
+   * @param input - A pointer to the input of the Connection.
+   * @param output - A pointer to the output of the Connection.
+   * @param _notify False.
+   */
+  Connection(Connecting * _input, Connecting * _output, bool _notify);
+
   /**
    * A pointer to the input Connecting object.
    *
@@ -327,4 +463,20 @@ class Connection {
   Connecting* output_;
 };
 
-#endif
\ No newline at end of file
+inline Connecting* ConnectingSpan::iterator::operator*() const {
+  return this->inputs_ ? (*this->position_)->input() : (*this->position_)->output();
+}
+
+inline Connecting* ConnectingSpan::operator[](size_t _index) const {
+  return this->inputs_ ? this->connections_[_index]->input() : this->connections_[_index]->output();
+}
+
+inline ConnectingSpan Connecting::inputSpan() const {
+  return ConnectingSpan(this->inputs_.data(), this->inputs_.size(), true);
+}
+
+inline ConnectingSpan Connecting::outputSpan() const {
+  return ConnectingSpan(this->outputs_.data(), this->outputs_.size(), false);
+}
+
+#endif
@@ -152,3 +152,50 @@ TEST_F(Connection_Test, Connection_Test_Constructor_04) {
 	EXPECT_EQ(c1, a->input());
 	EXPECT_EQ(c2, a->output());
 }
+
+//static void* operator new(size_t _size);
+//static void operator delete(void* _connection, size_t _size);
+TEST(Connection_Test_Pool, Connection_Test_Pool_01) {
+	Connecting* c1 = new Connecting;
+	Connecting* c2 = new Connecting;
+	Connection* a = new Connection(c1, c2);
+	delete a;
+	EXPECT_TRUE(c1->outputs().empty());
+	EXPECT_TRUE(c2->inputs().empty());
+	Connection* b = new Connection(c1, c2);
+#ifndef __SANITIZE_ADDRESS__
+	EXPECT_EQ(a, b); //The memory of a deleted Connection is reused.
+#endif
+	EXPECT_EQ(c1, b->input());
+	EXPECT_EQ(c2, b->output());
+	delete c1; //Deletes the Connection.
+	EXPECT_TRUE(c2->inputs().empty());
+	delete c2;
+}
+
+//ConnectingSpan inputSpan() const;
+//ConnectingSpan outputSpan() const;
+TEST(Connecting_Test_Span, Connecting_Test_Span_01) {
+	Connecting* gate = new Connecting;
+	std::vector<Connecting*> pins;
+	for (size_t i = 0; i < 6; i++) { //More than are held inline.
+		pins.push_back(new Connecting);
+		gate->addInput(pins.back());
+	}
+	ConnectingSpan inputs = gate->inputSpan();
+	ASSERT_EQ(6, inputs.size());
+	for (size_t i = 0; i < pins.size(); i++) {
+		EXPECT_EQ(pins.at(i), inputs[i]); //In the order connected.
+		EXPECT_EQ(gate, pins.at(i)->outputSpan()[0]);
+	}
+	gate->removeInput(pins.at(1));
+	std::vector<Connecting*> remaining(gate->inputSpan().begin(), gate->inputSpan().end());
+	EXPECT_EQ(std::vector<Connecting*>({ pins.at(0), pins.at(2), pins.at(3), pins.at(4), pins.at(5) }), remaining);
+	EXPECT_TRUE(pins.at(1)->outputSpan().empty());
+	EXPECT_EQ(std::unordered_set<Connecting*>(remaining.begin(), remaining.end()), gate->inputs());
+	delete gate;
+	for (Connecting* pin : pins) {
+		EXPECT_TRUE(pin->outputSpan().empty());
+		delete pin;
+	}
+}
@@ -35,7 +35,7 @@ int Levelized::inputLevel() {
 
 	//Level is not known/does not exist, calculate it.
 	std::vector<int> levels;
-	for (Connecting* input : this->inputs()) {
+	for (Connecting* input : this->inputSpan()) {
 		Levelized* castLevelized = dynamic_cast<Levelized*>(input);
 		levels.push_back(castLevelized->inputLevel());
 	}
@@ -63,7 +63,7 @@ void Levelized::inputLevelClear() {
 	}
 
 	this->inputLevel_ = UNKNOWN_LEVEL;
-	for (Connecting* output : this->outputs()) {
+	for (Connecting* output : this->outputSpan()) {
 		Levelized* castLevelized = dynamic_cast<Levelized*>(output);
 		castLevelized->inputLevelClear();
 	}
@@ -81,7 +81,7 @@ int Levelized::outputLevel() {
 	//Level is not known/does not exist, calculate it.
 	int ret = UNKNOWN_LEVEL;
 	std::vector<int> levels;
-	for (Connecting* output : this->outputs()) {
+	for (Connecting* output : this->outputSpan()) {
 		Levelized* castLevelized = dynamic_cast<Levelized*>(output);
 		levels.push_back(castLevelized->outputLevel());
 	}
@@ -109,7 +109,7 @@ void Levelized::outputLevelClear() {
 	}
 
 	this->outputLevel_ = UNKNOWN_LEVEL;
-	for (Connecting* input : this->inputs()) {
+	for (Connecting* input : this->inputSpan()) {
 		Levelized* castLevelized = dynamic_cast<Levelized*>(input);
 		castLevelized->outputLevelClear();
 	}
@@ -119,6 +119,11 @@ void Levelized::outputLevelZero() {
 	this->outputLevel_ = 0;
 }
 
+void Levelized::copyLevels(const Levelized* _other) {
+	this->inputLevel_ = _other->inputLevel_;
+	this->outputLevel_ = _other->outputLevel_;
+}
+
 int Levelized::levelCalculation(std::vector<int> _levels) {
 	int toReturn = -2; //May be incremented to -1
 	for (auto level : _levels) {
@@ -110,6 +110,14 @@ public:
 
 
 
+	/*
+	 * Set this object's input and output levels to those of another object,
+	 * e.g., the object this object is a copy of.
+	 *
+	 * @param _other The object whose levels are copied (known or not).
+	 */
+	void copyLevels(const Levelized* _other);
+
 	/*
 	 * This constant is assigned as the level for objects with no defined
 	 * level.
@@ -0,0 +1,118 @@
+/**
+ * @file Pool.h
+ * @author Spencer Millican (millican@auburn.edu)
+ * @version 0.1
+ * @date 2020-06-01
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#ifndef Pool_h
+#define Pool_h
+
+#include <cstddef>
+#include <new>
+
+/*
+ * Under AddressSanitizer, the pool is bypassed (see "Pool"). GCC defines
+ * __SANITIZE_ADDRESS__, clang has __has_feature(address_sanitizer).
+ */
+#if defined(__SANITIZE_ADDRESS__)
+#define POOL_BYPASS
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define POOL_BYPASS
+#endif
+#endif
+
+/*
+ * A pool of fixed-size memory blocks for objects which are created and deleted
+ * often, e.g., Connections.
+ *
+ * Blocks are taken from chunks of many blocks, so memory is requested from the
+ * system once per chunk rather than once per object. Freed blocks are kept in
+ * a free list and handed out again by the next allocation. Chunks are never
+ * returned to the system.
+ *
+ * Each thread has its own free list, so no locking is needed. A block may be
+ * freed by another thread than the one which allocated it (it will be reused
+ * by the freeing thread). Hence, each thread's blocks only grow to the most
+ * blocks that thread ever had in use at once (counting blocks freed to it by
+ * other threads), and a thread's free list is lost when the thread exits. When
+ * objects are created and deleted on different threads (e.g., in parallel
+ * TPI or fault simulation), the pool may grow past the most blocks ever in use
+ * at once.
+ *
+ * Under AddressSanitizer, every block is allocated on its own, so use after
+ * free is still detected.
+ *
+ * @param _size The size of every block.
+ */
+template <size_t _size>
+class Pool {
+public:
+	/*
+	 * Take a block (from the free list, or from a new chunk).
+	 *
+	 * @return A block of (at least) _size bytes.
+	 */
+	static void* allocate() {
+#ifdef POOL_BYPASS
+		return ::operator new(sizeof(Block));
+#endif
+		if (free_ == nullptr) {
+			Block* chunk = static_cast<Block*>(::operator new(CHUNK * sizeof(Block)));
+			for (size_t i = 0; i < CHUNK - 1; i++) {
+				chunk[i].next = &chunk[i + 1];
+			}
+			chunk[CHUNK - 1].next = nullptr;
+			free_ = chunk;
+		}
+		Block* block = free_;
+		free_ = block->next;
+		return block;
+	}
+
+	/*
+	 * Return a block to the (calling thread's) free list.
+	 *
+	 * @param _block A block given by "allocate" (nullptr is ignored).
+	 */
+	static void deallocate(void* _block) {
+		if (_block == nullptr) {
+			return;
+		}
+#ifdef POOL_BYPASS
+		::operator delete(_block);
+		return;
+#endif
+		Block* block = static_cast<Block*>(_block);
+		block->next = free_;
+		free_ = block;
+	}
+
+private:
+	/*
+	 * A free block links to the next free block. A used block holds an object.
+	 */
+	union Block {
+		Block* next;
+		alignas(std::max_align_t) char data[_size];
+	};
+
+	/*
+	 * The number of blocks per chunk.
+	 */
+	static const size_t CHUNK = 1024;
+
+	/*
+	 * The first free block of this thread.
+	 */
+	static thread_local Block* free_;
+};
+
+template <size_t _size>
+thread_local typename Pool<_size>::Block* Pool<_size>::free_ = nullptr;
+
+#endif
@@ -0,0 +1,166 @@
+/**
+ * @file SmallVector.h
+ * @author Spencer Millican (millican@auburn.edu)
+ * @version 0.1
+ * @date 2020-06-01
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#ifndef SmallVector_h
+#define SmallVector_h
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+/*
+ * A vector which holds its first items inside itself, e.g., the connections
+ * of an object (most objects have a handful).
+ *
+ * Nothing is allocated until more than _inline items are held, after which
+ * the items are moved onto the heap (and the capacity doubles as needed).
+ * Items are kept in the order they were added.
+ *
+ * Only trivially copyable items (e.g., pointers) are supported.
+ *
+ * @param _type The type of the items.
+ * @param _inline The number of items held without allocating.
+ */
+template <class _type, size_t _inline>
+class SmallVector {
+	static_assert(std::is_trivially_copyable<_type>::value, "SmallVector only holds trivially copyable items.");
+	static_assert(_inline > 0, "SmallVector must hold at least one item inline.");
+
+public:
+	/*
+	 * Create an empty vector.
+	 */
+	SmallVector() : data_(inline_), size_(0), capacity_(_inline) {}
+
+	SmallVector(const SmallVector & _other) : SmallVector() {
+		*this = _other;
+	}
+
+	SmallVector & operator=(const SmallVector & _other) {
+		if (this != &_other) {
+			this->clear();
+			this->reserve(_other.size_);
+			for (size_t i = 0; i < _other.size_; i++) {
+				this->data_[i] = _other.data_[i];
+			}
+			this->size_ = _other.size_;
+		}
+		return *this;
+	}
+
+	~SmallVector() {
+		if (this->data_ != this->inline_) {
+			delete[] this->data_;
+		}
+	}
+
+	/*
+	 * The number of items.
+	 *
+	 * @return The number of items.
+	 */
+	size_t size() const {
+		return this->size_;
+	}
+
+	/*
+	 * Are there no items?
+	 *
+	 * @return True if there are no items.
+	 */
+	bool empty() const {
+		return this->size_ == 0;
+	}
+
+	_type* data() { return this->data_; }
+	const _type* data() const { return this->data_; }
+	_type* begin() { return this->data_; }
+	const _type* begin() const { return this->data_; }
+	_type* end() { return this->data_ + this->size_; }
+	const _type* end() const { return this->data_ + this->size_; }
+	_type & operator[](size_t _index) { return this->data_[_index]; }
+	const _type & operator[](size_t _index) const { return this->data_[_index]; }
+
+	/*
+	 * Make room for a number of items (without adding any).
+	 *
+	 * @param _capacity The number of items to make room for.
+	 */
+	void reserve(size_t _capacity) {
+		if (_capacity <= this->capacity_) {
+			return;
+		}
+		_type* data = new _type[_capacity];
+		for (size_t i = 0; i < this->size_; i++) {
+			data[i] = this->data_[i];
+		}
+		if (this->data_ != this->inline_) {
+			delete[] this->data_;
+		}
+		this->data_ = data;
+		this->capacity_ = (uint32_t)_capacity;
+	}
+
+	/*
+	 * Add an item (after all other items).
+	 *
+	 * @param _item The item to add.
+	 */
+	void push_back(const _type & _item) {
+		if (this->size_ == this->capacity_) {
+			this->reserve(2 * (size_t)this->capacity_);
+		}
+		this->data_[this->size_++] = _item;
+	}
+
+	/*
+	 * Remove an item, keeping the order of the other items.
+	 *
+	 * @param _position The item to remove.
+	 * @return The item after the removed item.
+	 */
+	_type* erase(_type* _position) {
+		for (_type* item = _position; item + 1 < this->end(); item++) {
+			*item = *(item + 1);
+		}
+		this->size_--;
+		return _position;
+	}
+
+	/*
+	 * Remove all items (keeping the capacity).
+	 */
+	void clear() {
+		this->size_ = 0;
+	}
+
+private:
+	/*
+	 * The items (inline_ or on the heap).
+	 */
+	_type* data_;
+
+	/*
+	 * The number of items.
+	 */
+	uint32_t size_;
+
+	/*
+	 * The number of items which fit in data_.
+	 */
+	uint32_t capacity_;
+
+	/*
+	 * The first items (while they fit).
+	 */
+	_type inline_[_inline];
+};
+
+#endif
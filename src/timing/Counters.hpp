@@ -0,0 +1,279 @@
+/**
+ * @file Counters.hpp
+ * @author Spencer Millican (millican@auburn.edu)
+ * @version 0.1
+ * @date 2020-06-01
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#ifndef Counters_h
+#define Counters_h
+
+#include <atomic>
+#include <string>
+#include <map>
+#include <set>
+#include <mutex>
+#include <cstdio>
+
+/*
+ * Count an event on a hot path, e.g., COUNT(GATE_EVALUATIONS).
+ *
+ * Counting is only compiled in if OPENEDA_COUNTERS is defined. Otherwise,
+ * counting is removed entirely (and has no cost).
+ */
+#ifdef OPENEDA_COUNTERS
+#define COUNT(_counter) Counters::thread().add(Counters::_counter)
+#define COUNT_N(_counter, _amount) Counters::thread().add(Counters::_counter, _amount)
+#else
+#define COUNT(_counter)
+#define COUNT_N(_counter, _amount)
+#endif
+
+/*
+ * Per-thread counts of hot-path events.
+ *
+ * Every thread counts in its own counters, so counting never needs to
+ * synchronize with other threads. The counts of all threads (including threads
+ * which have finished) can be combined with "total".
+ */
+class Counters {
+public:
+	/*
+	 * All counted events.
+	 */
+	enum Counter {
+		EVENTS_QUEUED,                //Events added to an EventQueue.
+		EVENTS_PROCESSED,             //Events processed by an EventQueue.
+		GATE_EVALUATIONS,             //Calls to BooleanFunction::evaluate.
+		FAULT_ACTIVATIONS,            //Faults activated (and simulated) by a FaultSimulator.
+		FAULT_EARLY_DROPS,            //Faults not simulated (no faulty value at their location).
+		FAULT_DETECTIONS,             //Faults detected (and dropped) by a FaultSimulator.
+		COP_CONTROLLABILITY_CLEARS,   //COP controllabilities cleared.
+		COP_OBSERVABILITY_CLEARS,     //COP observabilities cleared.
+		COP_CONTROLLABILITY_RECOMPUTES, //COP controllabilities (re)calculated.
+		COP_OBSERVABILITY_RECOMPUTES, //COP observabilities (re)calculated.
+		TPI_CANDIDATES,               //TP candidates evaluated by TPI.
+		NUM_COUNTERS
+	};
+
+	/*
+	 * The (JSON) name of a counter, e.g., "events_queued".
+	 *
+	 * @param _counter The counter.
+	 * @return The name of the counter.
+	 */
+	static std::string name(Counter _counter) {
+		static const char* names[NUM_COUNTERS] = {
+			"events_queued",
+			"events_processed",
+			"gate_evaluations",
+			"fault_activations",
+			"fault_early_drops",
+			"fault_detections",
+			"cop_controllability_clears",
+			"cop_observability_clears",
+			"cop_controllability_recomputes",
+			"cop_observability_recomputes",
+			"tpi_candidates"
+		};
+		return names[_counter];
+	}
+
+	/*
+	 * Is counting compiled in?
+	 *
+	 * @return True if OPENEDA_COUNTERS is defined.
+	 */
+	static bool enabled() {
+#ifdef OPENEDA_COUNTERS
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	/*
+	 * Create counters (all 0).
+	 */
+	Counters() {
+		for (size_t i = 0; i < NUM_COUNTERS; i++) {
+			this->counts_[i].store(0, std::memory_order_relaxed);
+		}
+	}
+
+	Counters(const Counters & _other) : Counters() {
+		this->add(_other);
+	}
+
+	Counters& operator=(const Counters & _other) {
+		for (size_t i = 0; i < NUM_COUNTERS; i++) {
+			this->counts_[i].store(_other.count((Counter)i), std::memory_order_relaxed);
+		}
+		return *this;
+	}
+
+	/*
+	 * Add to a counter.
+	 *
+	 * Only the owning thread may add to its counters (other threads may read
+	 * them at any time).
+	 *
+	 * @param _counter The counter to add to.
+	 * @param (optional) _amount The amount to add.
+	 */
+	void add(Counter _counter, unsigned long long int _amount = 1) {
+		std::atomic<unsigned long long int> & count = this->counts_[_counter];
+		count.store(count.load(std::memory_order_relaxed) + _amount, std::memory_order_relaxed);
+	}
+
+	/*
+	 * Add all counts of other counters to these.
+	 *
+	 * @param _other The counters to add.
+	 */
+	void add(const Counters & _other) {
+		for (size_t i = 0; i < NUM_COUNTERS; i++) {
+			this->add((Counter)i, _other.count((Counter)i));
+		}
+	}
+
+	/*
+	 * Return a count.
+	 *
+	 * @param _counter The counter to return.
+	 * @return The count.
+	 */
+	unsigned long long int count(Counter _counter) const {
+		return this->counts_[_counter].load(std::memory_order_relaxed);
+	}
+
+	/*
+	 * Return all counts by name (see "name").
+	 *
+	 * @return All counts.
+	 */
+	std::map<std::string, unsigned long long int> counts() const {
+		std::map<std::string, unsigned long long int> toReturn;
+		for (size_t i = 0; i < NUM_COUNTERS; i++) {
+			toReturn[Counters::name((Counter)i)] = this->count((Counter)i);
+		}
+		return toReturn;
+	}
+
+	/*
+	 * Set all counts to 0.
+	 */
+	void clear() {
+		for (size_t i = 0; i < NUM_COUNTERS; i++) {
+			this->counts_[i].store(0, std::memory_order_relaxed);
+		}
+	}
+
+	/*
+	 * Write all counts as a JSON object, e.g., {"events_queued": 10, ...}.
+	 *
+	 * @param _output The file to write to.
+	 */
+	void json(FILE* _output) const {
+		fprintf(_output, "{");
+		for (size_t i = 0; i < NUM_COUNTERS; i++) {
+			fprintf(_output, "%s\"%s\": %llu", i == 0 ? "" : ", ", Counters::name((Counter)i).c_str(), this->count((Counter)i));
+		}
+		fprintf(_output, "}");
+	}
+
+	/*
+	 * The counters of the calling thread.
+	 *
+	 * @return The counters of this thread.
+	 */
+	static Counters & thread();
+
+	/*
+	 * The combined counters of all threads.
+	 *
+	 * @return The counters of all threads.
+	 */
+	static Counters total();
+
+	/*
+	 * Set the counters of all threads to 0.
+	 *
+	 * NOTE: This should not be called while other threads are counting.
+	 */
+	static void reset();
+
+private:
+	/*
+	 * The counts (indexed by Counter).
+	 */
+	std::atomic<unsigned long long int> counts_[NUM_COUNTERS];
+};
+
+/*
+ * The counters of a single thread (registered while the thread runs).
+ */
+struct ThreadCounters {
+	ThreadCounters();
+
+	//Keep the counts of finished threads.
+	~ThreadCounters();
+
+	Counters counters;
+};
+
+/*
+ * All (running) threads' counters.
+ */
+struct CountersRegistry {
+	std::mutex mutex;
+	std::set<ThreadCounters*> threads;
+	Counters finished;
+
+	static CountersRegistry & instance() {
+		static CountersRegistry registry;
+		return registry;
+	}
+};
+
+inline ThreadCounters::ThreadCounters() {
+	CountersRegistry & registry = CountersRegistry::instance();
+	std::lock_guard<std::mutex> lock(registry.mutex);
+	registry.threads.emplace(this);
+}
+
+inline ThreadCounters::~ThreadCounters() {
+	CountersRegistry & registry = CountersRegistry::instance();
+	std::lock_guard<std::mutex> lock(registry.mutex);
+	registry.finished.add(this->counters);
+	registry.threads.erase(this);
+}
+
+inline Counters & Counters::thread() {
+	thread_local ThreadCounters counters;
+	return counters.counters;
+}
+
+inline Counters Counters::total() {
+	CountersRegistry & registry = CountersRegistry::instance();
+	std::lock_guard<std::mutex> lock(registry.mutex);
+	Counters toReturn = registry.finished;
+	for (ThreadCounters* thread : registry.threads) {
+		toReturn.add(thread->counters);
+	}
+	return toReturn;
+}
+
+inline void Counters::reset() {
+	CountersRegistry & registry = CountersRegistry::instance();
+	std::lock_guard<std::mutex> lock(registry.mutex);
+	registry.finished.clear();
+	for (ThreadCounters* thread : registry.threads) {
+		thread->counters.clear();
+	}
+}
+
+#endif
@@ -0,0 +1,52 @@
+#include "gtest/gtest.h"
+#include "timing/Counters.hpp"
+
+#include <thread>
+
+class CountersTest : public ::testing::Test {
+public:
+	void SetUp() override {
+		Counters::reset();
+	}
+};
+
+TEST_F(CountersTest, AddTest) {
+	Counters::thread().add(Counters::GATE_EVALUATIONS);
+	Counters::thread().add(Counters::GATE_EVALUATIONS, 4);
+	EXPECT_EQ(5, Counters::thread().count(Counters::GATE_EVALUATIONS));
+	EXPECT_EQ(0, Counters::thread().count(Counters::EVENTS_QUEUED));
+	EXPECT_EQ(5, Counters::thread().counts().at("gate_evaluations"));
+	Counters::reset();
+	EXPECT_EQ(0, Counters::thread().count(Counters::GATE_EVALUATIONS));
+}
+
+TEST_F(CountersTest, MacroTest) {
+	COUNT(EVENTS_PROCESSED);
+	COUNT_N(EVENTS_PROCESSED, 2);
+	EXPECT_EQ(Counters::enabled() ? 3 : 0, Counters::thread().count(Counters::EVENTS_PROCESSED));
+}
+
+TEST_F(CountersTest, ThreadTest) {
+	Counters::thread().add(Counters::TPI_CANDIDATES, 2);
+	std::thread other([]() {
+		Counters::thread().add(Counters::TPI_CANDIDATES, 3);
+		EXPECT_EQ(3, Counters::thread().count(Counters::TPI_CANDIDATES)); //Counters are per-thread.
+	});
+	other.join();
+	EXPECT_EQ(2, Counters::thread().count(Counters::TPI_CANDIDATES));
+	EXPECT_EQ(5, Counters::total().count(Counters::TPI_CANDIDATES)); //Includes the finished thread.
+}
+
+TEST_F(CountersTest, JsonTest) {
+	Counters counters;
+	counters.add(Counters::FAULT_DETECTIONS, 7);
+	FILE* file = tmpfile();
+	counters.json(file);
+	rewind(file);
+	char buffer[1024] = {};
+	fread(buffer, 1, sizeof(buffer) - 1, file);
+	fclose(file);
+	std::string json(buffer);
+	EXPECT_NE(std::string::npos, json.find("\"fault_detections\": 7"));
+	EXPECT_NE(std::string::npos, json.find("\"events_queued\": 0"));
+}
@@ -0,0 +1,228 @@
+/**
+ * @file HardwareCounters.hpp
+ * @author Spencer Millican (millican@auburn.edu)
+ * @version 0.1
+ * @date 2020-06-01
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#ifndef HardwareCounters_h
+#define HardwareCounters_h
+
+#include <string>
+#include <map>
+#include <cstring>
+#include <cstdint>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+/*
+ * Hardware performance counters (cycles, instructions, cache and branch misses)
+ * of the calling thread, read through Linux's perf_event_open.
+ *
+ * Counters which cannot be opened (e.g., not on Linux, no PMU in a virtual
+ * machine, or forbidden by /proc/sys/kernel/perf_event_paranoid) are simply
+ * left out of all measurements: see "available" and "error".
+ *
+ * Only user-space events of the thread which created the counters are counted.
+ *
+ * Example:
+ *    HardwareCounters counters;
+ *    counters.start();
+ *    ... //Events here are counted.
+ *    std::map<std::string, double> counts = counters.stop();
+ */
+class HardwareCounters {
+public:
+	/*
+	 * All counted hardware events.
+	 */
+	enum Event {
+		CYCLES,        //CPU cycles.
+		INSTRUCTIONS,  //Instructions retired.
+		L1D_MISSES,    //L1 data cache read misses.
+		LLC_MISSES,    //Last-level cache misses.
+		BRANCH_MISSES, //Mispredicted branches.
+		NUM_EVENTS
+	};
+
+	/*
+	 * The (JSON) name of an event, e.g., "cycles".
+	 *
+	 * @param _event The event.
+	 * @return The name of the event.
+	 */
+	static std::string name(Event _event) {
+		static const char* names[NUM_EVENTS] = {
+			"cycles",
+			"instructions",
+			"l1d_misses",
+			"llc_misses",
+			"branch_misses"
+		};
+		return names[_event];
+	}
+
+	/*
+	 * Open all counters (which can be opened) for the calling thread.
+	 */
+	HardwareCounters() {
+		for (size_t i = 0; i < NUM_EVENTS; i++) {
+			this->files_[i] = -1;
+		}
+#ifdef __linux__
+		const uint32_t types[NUM_EVENTS] = {
+			PERF_TYPE_HARDWARE,
+			PERF_TYPE_HARDWARE,
+			PERF_TYPE_HW_CACHE,
+			PERF_TYPE_HARDWARE,
+			PERF_TYPE_HARDWARE
+		};
+		const uint64_t configs[NUM_EVENTS] = {
+			PERF_COUNT_HW_CPU_CYCLES,
+			PERF_COUNT_HW_INSTRUCTIONS,
+			PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16),
+			PERF_COUNT_HW_CACHE_MISSES,
+			PERF_COUNT_HW_BRANCH_MISSES
+		};
+		for (size_t i = 0; i < NUM_EVENTS; i++) {
+			struct perf_event_attr attributes;
+			memset(&attributes, 0, sizeof(attributes));
+			attributes.size = sizeof(attributes);
+			attributes.type = types[i];
+			attributes.config = configs[i];
+			attributes.disabled = 1;
+			attributes.exclude_kernel = 1;
+			attributes.exclude_hv = 1;
+			attributes.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+			this->files_[i] = (int)syscall(__NR_perf_event_open, &attributes, 0, -1, -1, 0);
+			if (this->files_[i] < 0 && this->error_.empty()) {
+				this->error_ = "perf_event_open failed for " + HardwareCounters::name((Event)i) + ": " + strerror(errno);
+			}
+		}
+#else
+		this->error_ = "hardware counters are only supported on Linux";
+#endif
+	}
+
+	HardwareCounters(const HardwareCounters&) = delete;
+	HardwareCounters& operator=(const HardwareCounters&) = delete;
+
+	/*
+	 * Close all counters.
+	 */
+	~HardwareCounters() {
+#ifdef __linux__
+		for (size_t i = 0; i < NUM_EVENTS; i++) {
+			if (this->files_[i] >= 0) {
+				close(this->files_[i]);
+			}
+		}
+#endif
+	}
+
+	/*
+	 * Can an event be counted?
+	 *
+	 * @param _event The event.
+	 * @return True if the event's counter is open.
+	 */
+	bool available(Event _event) const {
+		return this->files_[_event] >= 0;
+	}
+
+	/*
+	 * Can any event be counted?
+	 *
+	 * @return True if at least one counter is open.
+	 */
+	bool available() const {
+		for (size_t i = 0; i < NUM_EVENTS; i++) {
+			if (this->available((Event)i)) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	/*
+	 * Why the first counter which failed to open did so ("" if all opened).
+	 *
+	 * @return The reason counters are unavailable.
+	 */
+	std::string error() const {
+		return this->error_;
+	}
+
+	/*
+	 * Reset all counters (to 0) and start counting.
+	 */
+	void start() {
+#ifdef __linux__
+		for (size_t i = 0; i < NUM_EVENTS; i++) {
+			if (this->files_[i] >= 0) {
+				ioctl(this->files_[i], PERF_EVENT_IOC_RESET, 0);
+				ioctl(this->files_[i], PERF_EVENT_IOC_ENABLE, 0);
+			}
+		}
+#endif
+	}
+
+	/*
+	 * Stop counting and return all counts since "start".
+	 *
+	 * If the kernel multiplexed a counter (ran it only part of the time), its
+	 * count is scaled up to the whole time.
+	 *
+	 * @return The counts of all available events (by name, see "name").
+	 */
+	std::map<std::string, double> stop() {
+		std::map<std::string, double> toReturn;
+#ifdef __linux__
+		for (size_t i = 0; i < NUM_EVENTS; i++) {
+			if (this->files_[i] >= 0) {
+				ioctl(this->files_[i], PERF_EVENT_IOC_DISABLE, 0);
+			}
+		}
+		for (size_t i = 0; i < NUM_EVENTS; i++) {
+			if (this->files_[i] < 0) {
+				continue;
+			}
+			uint64_t values[3] = { 0, 0, 0 }; //Value, time enabled, time running.
+			if (read(this->files_[i], values, sizeof(values)) != (ssize_t)sizeof(values)) {
+				continue;
+			}
+			double count = (double)values[0];
+			if (values[2] == 0) { //Never scheduled: the count is unknown.
+				continue;
+			}
+			if (values[2] < values[1]) {
+				count = count * (double)values[1] / (double)values[2];
+			}
+			toReturn[HardwareCounters::name((Event)i)] = count;
+		}
+#endif
+		return toReturn;
+	}
+
+private:
+	/*
+	 * The file descriptor of each event's counter (-1 if unavailable).
+	 */
+	int files_[NUM_EVENTS];
+
+	/*
+	 * Why counters are unavailable.
+	 */
+	std::string error_;
+};
+
+#endif
@@ -0,0 +1,34 @@
+#include "gtest/gtest.h"
+#include "timing/HardwareCounters.hpp"
+
+#include <vector>
+
+//Hardware counters may be unavailable (e.g., in a virtual machine): tests must pass either way.
+TEST(HardwareCountersTest, CountTest) {
+	HardwareCounters counters;
+	if (counters.available() == false) {
+		EXPECT_FALSE(counters.error().empty());
+	}
+	counters.start();
+	volatile unsigned long long int sum = 0;
+	for (unsigned long long int i = 0; i < 1000000; i++) {
+		sum = sum + i;
+	}
+	std::map<std::string, double> counts = counters.stop();
+	for (size_t i = 0; i < HardwareCounters::NUM_EVENTS; i++) {
+		std::string name = HardwareCounters::name((HardwareCounters::Event)i);
+		if (counters.available((HardwareCounters::Event)i) == false) {
+			EXPECT_EQ(0, counts.count(name));
+		} else if (counts.count(name) != 0) {
+			EXPECT_LE(0.0, counts.at(name));
+		}
+	}
+	if (counts.count("instructions") != 0) {
+		EXPECT_LT(1000000.0, counts.at("instructions"));
+	}
+}
+
+TEST(HardwareCountersTest, NameTest) {
+	EXPECT_EQ("cycles", HardwareCounters::name(HardwareCounters::CYCLES));
+	EXPECT_EQ("branch_misses", HardwareCounters::name(HardwareCounters::BRANCH_MISSES));
+}
@@ -0,0 +1,6 @@
+#pragma once
+
+#include "timing/Timing_Test.hpp"
+#include "timing/Counters_Test.hpp"
+#include "timing/Trace_Test.hpp"
+#include "timing/HardwareCounters_Test.hpp"
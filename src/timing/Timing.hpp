@@ -0,0 +1,425 @@
+/**
+ * @file Timing.hpp
+ * @author Spencer Millican (millican@auburn.edu)
+ * @version 0.1
+ * @date 2020-06-01
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#ifndef Timing_h
+#define Timing_h
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <mutex>
+
+/*
+ * A point in (wall-clock) time by which work must be finished.
+ *
+ * Deadlines use std::chrono::steady_clock, i.e., elapsed real time. Unlike
+ * std::clock() (the processor time of the whole program), this does not run
+ * faster when multiple threads are working.
+ *
+ * Deadlines are small values which can be copied freely and shared between
+ * threads.
+ */
+class Deadline {
+public:
+	typedef std::chrono::steady_clock Clock;
+
+	/*
+	 * Create a deadline which never expires.
+	 */
+	Deadline() {
+		this->end_ = Clock::time_point::max();
+	}
+
+	/*
+	 * Create a deadline a given number of seconds from now.
+	 *
+	 * Very large limits (e.g., std::numeric_limits<size_t>::max()) never
+	 * expire.
+	 *
+	 * @param _seconds The time limit (in seconds).
+	 */
+	Deadline(double _seconds) {
+		Clock::time_point now = Clock::now();
+		std::chrono::duration<double> limit(_seconds);
+		if (limit >= std::chrono::duration<double>(Clock::time_point::max() - now)) {
+			this->end_ = Clock::time_point::max();
+		} else {
+			this->end_ = now + std::chrono::duration_cast<Clock::duration>(limit);
+		}
+	}
+
+	/*
+	 * Has the deadline passed?
+	 *
+	 * @return True if the deadline has passed.
+	 */
+	bool expired() const {
+		return Clock::now() >= this->end_;
+	}
+
+	/*
+	 * The time left before the deadline (0 if it has passed).
+	 *
+	 * @return The time left (in seconds).
+	 */
+	double remaining() const {
+		Clock::time_point now = Clock::now();
+		if (now >= this->end_) {
+			return 0.0;
+		}
+		return std::chrono::duration<double>(this->end_ - now).count();
+	}
+
+	/*
+	 * Return whichever deadline (this or another) comes first.
+	 *
+	 * This is used to honor an outer deadline (e.g., a budget for an entire
+	 * run) along with a local time limit.
+	 *
+	 * @param _other The other deadline.
+	 * @return The earlier of the two deadlines.
+	 */
+	Deadline earliest(const Deadline & _other) const {
+		return (this->end_ <= _other.end_) ? *this : _other;
+	}
+
+private:
+	/*
+	 * When the deadline expires.
+	 */
+	Clock::time_point end_;
+};
+
+/*
+ * The accumulated (wall-clock) time spent in named phases.
+ *
+ * Nested phases are named by their full path, i.e., a "fault simulation" phase
+ * timed inside of a "TPI" phase is named "TPI/fault simulation".
+ */
+class PhaseTimes {
+public:
+	/*
+	 * The time spent in a single phase.
+	 */
+	struct Phase {
+		/*
+		 * The number of times the phase was timed.
+		 */
+		size_t calls = 0;
+
+		/*
+		 * The total time spent in the phase (in seconds).
+		 */
+		double seconds = 0.0;
+	};
+
+	PhaseTimes() = default;
+
+	/*
+	 * Copy the phases (but not the lock) of other phase times.
+	 *
+	 * @param _other The phase times to copy.
+	 */
+	PhaseTimes(const PhaseTimes & _other) {
+		this->phases_ = _other.phases();
+	}
+
+	PhaseTimes& operator=(const PhaseTimes & _other) {
+		std::map<std::string, Phase> phases = _other.phases();
+		std::lock_guard<std::mutex> lock(this->mutex_);
+		this->phases_ = phases;
+		return *this;
+	}
+
+	/*
+	 * Add time to a phase.
+	 *
+	 * @param _phase The (full) name of the phase.
+	 * @param _seconds The time to add (in seconds).
+	 * @param (optional) _calls The number of times the phase was timed.
+	 */
+	void add(std::string _phase, double _seconds, size_t _calls = 1) {
+		std::lock_guard<std::mutex> lock(this->mutex_);
+		Phase & phase = this->phases_[_phase];
+		phase.calls += _calls;
+		phase.seconds += _seconds;
+	}
+
+	/*
+	 * Add all phases of other phase times to these.
+	 *
+	 * @param _other The phase times to add.
+	 */
+	void add(const PhaseTimes & _other) {
+		for (const std::pair<const std::string, Phase> & phase : _other.phases()) {
+			this->add(phase.first, phase.second.seconds, phase.second.calls);
+		}
+	}
+
+	/*
+	 * Return all phases (by full name).
+	 *
+	 * @return All phases.
+	 */
+	std::map<std::string, Phase> phases() const {
+		std::lock_guard<std::mutex> lock(this->mutex_);
+		return this->phases_;
+	}
+
+	/*
+	 * Return the time spent in a phase (or 0 if the phase was never timed).
+	 *
+	 * @param _phase The (full) name of the phase.
+	 * @return The time spent (in seconds).
+	 */
+	double seconds(std::string _phase) const {
+		std::lock_guard<std::mutex> lock(this->mutex_);
+		auto found = this->phases_.find(_phase);
+		return found == this->phases_.end() ? 0.0 : found->second.seconds;
+	}
+
+	/*
+	 * Forget all phases.
+	 */
+	void clear() {
+		std::lock_guard<std::mutex> lock(this->mutex_);
+		this->phases_.clear();
+	}
+
+private:
+	/*
+	 * Phases may be read by other threads (see Timing::total) while they are
+	 * being added to.
+	 */
+	mutable std::mutex mutex_;
+
+	/*
+	 * All phases, by full name.
+	 */
+	std::map<std::string, Phase> phases_;
+};
+
+/*
+ * Per-thread phase timing.
+ *
+ * Every thread accumulates its own phase times (see ScopedTimer), so timing
+ * never needs to synchronize with other threads. The times of all threads
+ * (including threads which have finished) can be combined with "total".
+ */
+class Timing {
+public:
+	/*
+	 * The phase times of the calling thread.
+	 *
+	 * @return The phase times of this thread.
+	 */
+	static PhaseTimes & thread() {
+		return Timing::local().times;
+	}
+
+	/*
+	 * The combined phase times of all threads.
+	 *
+	 * @return The phase times of all threads.
+	 */
+	static PhaseTimes total() {
+		Registry & registry = Timing::registry();
+		std::lock_guard<std::mutex> lock(registry.mutex);
+		PhaseTimes toReturn;
+		toReturn.add(registry.finished);
+		for (ThreadTimes* thread : registry.threads) {
+			toReturn.add(thread->times);
+		}
+		return toReturn;
+	}
+
+	/*
+	 * Forget the phase times of all threads.
+	 *
+	 * NOTE: Timers which are running when this is called will still add their
+	 *       time when they stop.
+	 */
+	static void reset() {
+		Registry & registry = Timing::registry();
+		std::lock_guard<std::mutex> lock(registry.mutex);
+		registry.finished.clear();
+		for (ThreadTimes* thread : registry.threads) {
+			thread->times.clear();
+		}
+	}
+
+	/*
+	 * The full name of the innermost phase being timed by the calling thread
+	 * ("" if none).
+	 *
+	 * @return The full name of the current phase.
+	 */
+	static std::string current() {
+		std::vector<std::string> & scopes = Timing::local().scopes;
+		return scopes.empty() ? "" : scopes.back();
+	}
+
+private:
+	friend class ScopedTimer;
+
+	/*
+	 * The timing state of a single thread.
+	 */
+	struct ThreadTimes {
+		ThreadTimes() {
+			Registry & registry = Timing::registry();
+			std::lock_guard<std::mutex> lock(registry.mutex);
+			registry.threads.emplace(this);
+		}
+
+		//Keep the times of finished threads.
+		~ThreadTimes() {
+			Registry & registry = Timing::registry();
+			std::lock_guard<std::mutex> lock(registry.mutex);
+			registry.finished.add(this->times);
+			registry.threads.erase(this);
+		}
+
+		/*
+		 * The accumulated phase times.
+		 */
+		PhaseTimes times;
+
+		/*
+		 * The full names of all phases currently being timed (outermost first).
+		 */
+		std::vector<std::string> scopes;
+	};
+
+	/*
+	 * All (running) threads' timing states.
+	 */
+	struct Registry {
+		std::mutex mutex;
+		std::set<ThreadTimes*> threads;
+		PhaseTimes finished;
+	};
+
+	static Registry & registry() {
+		static Registry registry;
+		return registry;
+	}
+
+	static ThreadTimes & local() {
+		thread_local ThreadTimes times;
+		return times;
+	}
+};
+
+/*
+ * Time a (named) phase from creation until it is stopped or destroyed.
+ *
+ * Timers may be nested: a timer created while another timer is running on the
+ * same thread is a sub-phase of it.
+ *
+ * Example:
+ *    {
+ *        ScopedTimer timer("parse");
+ *        ... //Time spent here is added to the "parse" phase.
+ *    }
+ */
+class ScopedTimer {
+public:
+	/*
+	 * Start timing a phase.
+	 *
+	 * @param _phase The name of the phase.
+	 */
+	ScopedTimer(std::string _phase) {
+		std::vector<std::string> & scopes = Timing::local().scopes;
+		this->phase_ = scopes.empty() ? _phase : scopes.back() + "/" + _phase;
+		scopes.push_back(this->phase_);
+		this->start_ = Deadline::Clock::now();
+		this->running_ = true;
+	}
+
+	ScopedTimer(const ScopedTimer&) = delete;
+	ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+	/*
+	 * Stop timing (if not already stopped).
+	 */
+	~ScopedTimer() {
+		this->stop();
+	}
+
+	/*
+	 * Stop timing and add the time spent to this thread's phase times.
+	 *
+	 * Stopping a timer more than once has no effect.
+	 *
+	 * NOTE: Timers should be stopped in the reverse order they were started.
+	 *
+	 * @return The time spent (in seconds).
+	 */
+	double stop() {
+		if (this->running_ == true) {
+			this->running_ = false;
+			this->seconds_ = std::chrono::duration<double>(Deadline::Clock::now() - this->start_).count();
+			Timing::thread().add(this->phase_, this->seconds_);
+			std::vector<std::string> & scopes = Timing::local().scopes;
+			if (scopes.empty() == false && scopes.back() == this->phase_) {
+				scopes.pop_back();
+			}
+		}
+		return this->seconds_;
+	}
+
+	/*
+	 * The time spent so far (or in total, if stopped).
+	 *
+	 * @return The time spent (in seconds).
+	 */
+	double elapsed() const {
+		if (this->running_ == true) {
+			return std::chrono::duration<double>(Deadline::Clock::now() - this->start_).count();
+		}
+		return this->seconds_;
+	}
+
+	/*
+	 * The full name of the phase being timed.
+	 *
+	 * @return The full name of the phase.
+	 */
+	std::string phase() const {
+		return this->phase_;
+	}
+
+private:
+	/*
+	 * The full name of the phase.
+	 */
+	std::string phase_;
+
+	/*
+	 * When timing started.
+	 */
+	Deadline::Clock::time_point start_;
+
+	/*
+	 * The time spent (set when stopped).
+	 */
+	double seconds_ = 0.0;
+
+	/*
+	 * Is the timer running?
+	 */
+	bool running_ = false;
+};
+
+#endif
@@ -0,0 +1,92 @@
+#include "gtest/gtest.h"
+#include "timing/Timing.hpp"
+
+#include <thread>
+
+class TimingTest : public ::testing::Test {
+public:
+	void SetUp() override {
+		Timing::reset();
+	}
+
+	//Wait (at least) a given number of milliseconds.
+	void wait(int _milliseconds) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(_milliseconds));
+	}
+};
+
+TEST_F(TimingTest, DeadlineTest) {
+	Deadline never;
+	EXPECT_FALSE(never.expired());
+	EXPECT_GT(never.remaining(), 1000000.0);
+
+	Deadline huge((double)std::numeric_limits<size_t>::max());
+	EXPECT_FALSE(huge.expired());
+
+	Deadline now(0.0);
+	EXPECT_TRUE(now.expired());
+	EXPECT_EQ(0.0, now.remaining());
+
+	Deadline soon(0.01);
+	EXPECT_FALSE(soon.expired());
+	this->wait(20);
+	EXPECT_TRUE(soon.expired());
+
+	Deadline later(1000.0);
+	EXPECT_TRUE(later.earliest(now).expired());
+	EXPECT_TRUE(now.earliest(later).expired());
+	EXPECT_FALSE(later.earliest(never).expired());
+	EXPECT_LE(later.earliest(never).remaining(), 1000.0);
+}
+
+TEST_F(TimingTest, NestedTest) {
+	{
+		ScopedTimer outer("outer");
+		EXPECT_EQ("outer", Timing::current());
+		{
+			ScopedTimer inner("inner");
+			EXPECT_EQ("outer/inner", inner.phase());
+			EXPECT_EQ("outer/inner", Timing::current());
+			this->wait(10);
+		}
+		ScopedTimer second("inner");
+		second.stop();
+		EXPECT_EQ("outer", Timing::current());
+	}
+	EXPECT_EQ("", Timing::current());
+
+	std::map<std::string, PhaseTimes::Phase> phases = Timing::thread().phases();
+	EXPECT_EQ(2, phases.size());
+	EXPECT_EQ(1, phases.at("outer").calls);
+	EXPECT_EQ(2, phases.at("outer/inner").calls);
+	EXPECT_GE(phases.at("outer/inner").seconds, 0.01);
+	EXPECT_GE(phases.at("outer").seconds, phases.at("outer/inner").seconds);
+}
+
+TEST_F(TimingTest, StopTest) {
+	ScopedTimer timer("phase");
+	this->wait(10);
+	double seconds = timer.stop();
+	EXPECT_GE(seconds, 0.01);
+	this->wait(10);
+	EXPECT_EQ(seconds, timer.stop());
+	EXPECT_EQ(seconds, timer.elapsed());
+	EXPECT_EQ(1, Timing::thread().phases().at("phase").calls);
+}
+
+TEST_F(TimingTest, ThreadTest) {
+	ScopedTimer outer("outer");
+	std::thread other([]() {
+		EXPECT_EQ("", Timing::current()); //Scopes are per-thread.
+		ScopedTimer timer("other");
+		timer.stop();
+		EXPECT_EQ(1, Timing::thread().phases().size());
+	});
+	other.join();
+	outer.stop();
+
+	EXPECT_EQ(0, Timing::thread().phases().count("other"));
+	PhaseTimes total = Timing::total(); //Includes the finished thread.
+	EXPECT_EQ(1, total.phases().at("other").calls);
+	EXPECT_EQ(1, total.phases().at("outer").calls);
+}
@@ -0,0 +1,347 @@
+/**
+ * @file Trace.hpp
+ * @author Spencer Millican (millican@auburn.edu)
+ * @version 0.1
+ * @date 2020-06-01
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#ifndef Trace_h
+#define Trace_h
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <utility>
+#include <mutex>
+#include <algorithm>
+#include <cstdio>
+#include <cmath>
+
+/*
+ * A single (complete) span of a trace.
+ */
+struct TraceEvent {
+	/*
+	 * The name of the span, e.g., "parse".
+	 */
+	std::string name;
+
+	/*
+	 * The category of the span, e.g., "tpi".
+	 */
+	std::string category;
+
+	/*
+	 * The start of the span (in microseconds since tracing started).
+	 */
+	long long int start;
+
+	/*
+	 * The duration of the span (in microseconds).
+	 */
+	long long int duration;
+
+	/*
+	 * The (trace) ID of the thread which ran the span.
+	 */
+	int thread;
+
+	/*
+	 * The arguments of the span as (name, JSON value) pairs.
+	 */
+	std::vector<std::pair<std::string, std::string>> args;
+};
+
+/*
+ * Records spans (see TraceSpan) and writes them in the Chrome trace-event
+ * format, which can be opened in chrome://tracing or https://ui.perfetto.dev.
+ *
+ * Tracing is off until "start" is called. While off, spans cost a single check.
+ */
+class TraceLog {
+public:
+	/*
+	 * Start tracing (and forget all previously recorded spans).
+	 */
+	static void start() {
+		TraceLog & tracer = TraceLog::instance();
+		std::lock_guard<std::mutex> lock(tracer.mutex_);
+		tracer.events_.clear();
+		tracer.origin_ = std::chrono::steady_clock::now();
+		tracer.enabled_ = true;
+	}
+
+	/*
+	 * Stop tracing (recorded spans are kept).
+	 */
+	static void stop() {
+		TraceLog::instance().enabled_ = false;
+	}
+
+	/*
+	 * Is tracing on?
+	 *
+	 * @return True if spans are being recorded.
+	 */
+	static bool enabled() {
+		return TraceLog::instance().enabled_;
+	}
+
+	/*
+	 * The (trace) ID of the calling thread: threads are numbered 1, 2, ... in
+	 * the order they first trace.
+	 *
+	 * @return The ID of this thread.
+	 */
+	static int thread() {
+		static std::atomic<int> nextThread(1);
+		thread_local int id = nextThread++;
+		return id;
+	}
+
+	/*
+	 * The time since tracing started (in microseconds).
+	 *
+	 * @return The current trace time.
+	 */
+	static long long int now() {
+		return std::chrono::duration_cast<std::chrono::microseconds>(
+			std::chrono::steady_clock::now() - TraceLog::instance().origin_
+			).count();
+	}
+
+	/*
+	 * Record a span (if tracing).
+	 *
+	 * @param _event The span to record.
+	 */
+	static void record(TraceEvent _event) {
+		TraceLog & tracer = TraceLog::instance();
+		if (tracer.enabled_ == false) {
+			return;
+		}
+		std::lock_guard<std::mutex> lock(tracer.mutex_);
+		tracer.events_.push_back(_event);
+	}
+
+	/*
+	 * All recorded spans (in the order they ended).
+	 *
+	 * @return All recorded spans.
+	 */
+	static std::vector<TraceEvent> events() {
+		TraceLog & tracer = TraceLog::instance();
+		std::lock_guard<std::mutex> lock(tracer.mutex_);
+		return tracer.events_;
+	}
+
+	/*
+	 * Write all recorded spans as Chrome trace-event JSON.
+	 *
+	 * @param _output The file to write to.
+	 */
+	static void write(FILE* _output) {
+		std::vector<TraceEvent> events = TraceLog::events();
+		fprintf(_output, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [");
+		std::vector<int> named;
+		for (size_t i = 0; i < events.size(); i++) {
+			const TraceEvent & event = events.at(i);
+			if (std::find(named.begin(), named.end(), event.thread) == named.end()) { //Name each thread once.
+				named.push_back(event.thread);
+				fprintf(_output, "%s\n{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": %d, \"args\": {\"name\": \"thread %d\"}}",
+					named.size() == 1 ? "" : ",", event.thread, event.thread);
+			}
+			fprintf(_output, ",\n{\"name\": %s, \"cat\": %s, \"ph\": \"X\", \"ts\": %lld, \"dur\": %lld, \"pid\": 1, \"tid\": %d, \"args\": {",
+				TraceLog::quote(event.name).c_str(),
+				TraceLog::quote(event.category).c_str(),
+				event.start,
+				event.duration,
+				event.thread
+			);
+			for (size_t j = 0; j < event.args.size(); j++) {
+				fprintf(_output, "%s%s: %s", j == 0 ? "" : ", ", TraceLog::quote(event.args.at(j).first).c_str(), event.args.at(j).second.c_str());
+			}
+			fprintf(_output, "}}");
+		}
+		fprintf(_output, "\n]}\n");
+	}
+
+	/*
+	 * Return a string as a (quoted and escaped) JSON string.
+	 *
+	 * @param _string The string to quote.
+	 * @return The JSON string.
+	 */
+	static std::string quote(std::string _string) {
+		std::string toReturn = "\"";
+		for (char character : _string) {
+			switch (character) {
+			case '"': toReturn += "\\\""; break;
+			case '\\': toReturn += "\\\\"; break;
+			case '\n': toReturn += "\\n"; break;
+			case '\t': toReturn += "\\t"; break;
+			default:
+				if ((unsigned char)character < 0x20) {
+					char escaped[8];
+					snprintf(escaped, sizeof(escaped), "\\u%04x", (unsigned int)character);
+					toReturn += escaped;
+				} else {
+					toReturn += character;
+				}
+			}
+		}
+		return toReturn + "\"";
+	}
+
+private:
+	static TraceLog & instance() {
+		static TraceLog tracer;
+		return tracer;
+	}
+
+	/*
+	 * Is tracing on?
+	 */
+	std::atomic<bool> enabled_{ false };
+
+	/*
+	 * When tracing started.
+	 */
+	std::chrono::steady_clock::time_point origin_ = std::chrono::steady_clock::now();
+
+	/*
+	 * Guards the recorded spans.
+	 */
+	std::mutex mutex_;
+
+	/*
+	 * All recorded spans.
+	 */
+	std::vector<TraceEvent> events_;
+};
+
+/*
+ * A span of a trace, from creation until destruction (or "end").
+ *
+ * Nothing is recorded if tracing is off when the span is created.
+ *
+ * Example:
+ *    {
+ *        TraceSpan span("parse", "parser");
+ *        span.arg("file", file);
+ *        ...
+ *        span.arg("nodes", circuit->nodes().size());
+ *    } //The span ends (and is recorded) here.
+ */
+class TraceSpan {
+public:
+	/*
+	 * Start a span.
+	 *
+	 * @param _name The name of the span.
+	 * @param (optional) _category The category of the span.
+	 */
+	TraceSpan(const char* _name, const char* _category = "") {
+		this->active_ = TraceLog::enabled();
+		if (this->active_ == true) {
+			this->event_.name = _name;
+			this->event_.category = _category;
+			this->event_.thread = TraceLog::thread();
+			this->event_.start = TraceLog::now();
+		}
+	}
+
+	TraceSpan(const TraceSpan&) = delete;
+	TraceSpan& operator=(const TraceSpan&) = delete;
+
+	~TraceSpan() {
+		this->end();
+	}
+
+	/*
+	 * Is this span being recorded?
+	 *
+	 * @return True if tracing was on when the span started.
+	 */
+	bool active() const {
+		return this->active_;
+	}
+
+	/*
+	 * Add a (text) argument to the span.
+	 *
+	 * @param _name The name of the argument.
+	 * @param _value The value of the argument.
+	 */
+	void arg(std::string _name, std::string _value) {
+		if (this->active_ == true) {
+			this->event_.args.push_back(std::make_pair(_name, TraceLog::quote(_value)));
+		}
+	}
+
+	void arg(std::string _name, const char* _value) {
+		this->arg(_name, std::string(_value));
+	}
+
+	/*
+	 * Add a (number) argument to the span.
+	 *
+	 * JSON has no NaN or infinity, so non-finite values are written as null.
+	 *
+	 * @param _name The name of the argument.
+	 * @param _value The value of the argument.
+	 */
+	void arg(std::string _name, double _value) {
+		if (this->active_ == true) {
+			if (std::isfinite(_value) == false) {
+				this->event_.args.push_back(std::make_pair(_name, std::string("null")));
+				return;
+			}
+			char number[32];
+			snprintf(number, sizeof(number), "%.17g", _value);
+			this->event_.args.push_back(std::make_pair(_name, std::string(number)));
+		}
+	}
+
+	void arg(std::string _name, size_t _value) {
+		this->arg(_name, (double)_value);
+	}
+
+	void arg(std::string _name, int _value) {
+		this->arg(_name, (double)_value);
+	}
+
+	void arg(std::string _name, bool _value) {
+		if (this->active_ == true) {
+			this->event_.args.push_back(std::make_pair(_name, std::string(_value ? "true" : "false")));
+		}
+	}
+
+	/*
+	 * End (and record) the span. Ending a span more than once has no effect.
+	 */
+	void end() {
+		if (this->active_ == true) {
+			this->active_ = false;
+			this->event_.duration = TraceLog::now() - this->event_.start;
+			TraceLog::record(this->event_);
+		}
+	}
+
+private:
+	/*
+	 * Is this span being recorded (and not yet ended)?
+	 */
+	bool active_;
+
+	/*
+	 * The span (once ended).
+	 */
+	TraceEvent event_;
+};
+
+#endif
@@ -0,0 +1,103 @@
+#include "gtest/gtest.h"
+#include "timing/Trace.hpp"
+
+#include <thread>
+#include <cmath>
+#include <limits>
+
+class TraceTest : public ::testing::Test {
+public:
+	void SetUp() override {
+		TraceLog::start();
+	}
+
+	void TearDown() override {
+		TraceLog::stop();
+	}
+};
+
+TEST_F(TraceTest, SpanTest) {
+	{
+		TraceSpan span("parse", "parser");
+		span.arg("file", "c17.bench");
+		span.arg("nodes", (size_t)13);
+	}
+	std::vector<TraceEvent> events = TraceLog::events();
+	ASSERT_EQ(1, events.size());
+	EXPECT_EQ("parse", events.at(0).name);
+	EXPECT_EQ("parser", events.at(0).category);
+	EXPECT_LE(0, events.at(0).duration);
+	ASSERT_EQ(2, events.at(0).args.size());
+	EXPECT_EQ("\"c17.bench\"", events.at(0).args.at(0).second);
+	EXPECT_EQ("13", events.at(0).args.at(1).second);
+}
+
+TEST_F(TraceTest, NonFiniteTest) {
+	{
+		TraceSpan span("round", "tpi");
+		span.arg("quality", std::nan(""));
+		span.arg("bound", std::numeric_limits<double>::infinity());
+		span.arg("base", -10000.0);
+	}
+	std::vector<TraceEvent> events = TraceLog::events();
+	ASSERT_EQ(1, events.size());
+	ASSERT_EQ(3, events.at(0).args.size());
+	EXPECT_EQ("null", events.at(0).args.at(0).second);
+	EXPECT_EQ("null", events.at(0).args.at(1).second);
+	EXPECT_EQ("-10000", events.at(0).args.at(2).second);
+}
+
+TEST_F(TraceTest, EndTest) {
+	TraceSpan span("round");
+	span.end();
+	span.end(); //No effect.
+	EXPECT_EQ(1, TraceLog::events().size());
+}
+
+TEST_F(TraceTest, DisabledTest) {
+	TraceLog::stop();
+	{
+		TraceSpan span("parse");
+		EXPECT_FALSE(span.active());
+	}
+	EXPECT_EQ(0, TraceLog::events().size());
+	TraceLog::start(); //Previous spans are forgotten.
+	EXPECT_EQ(0, TraceLog::events().size());
+}
+
+TEST_F(TraceTest, ThreadTest) {
+	int thisThread = TraceLog::thread();
+	int otherThread = 0;
+	{
+		TraceSpan span("main");
+	}
+	std::thread other([&otherThread]() {
+		TraceSpan span("other");
+		otherThread = TraceLog::thread();
+	});
+	other.join();
+	EXPECT_NE(thisThread, otherThread);
+	std::vector<TraceEvent> events = TraceLog::events();
+	ASSERT_EQ(2, events.size());
+	EXPECT_EQ(thisThread, events.at(0).thread);
+	EXPECT_EQ(otherThread, events.at(1).thread);
+}
+
+TEST_F(TraceTest, WriteTest) {
+	{
+		TraceSpan span("fault simulation iteration", "simulation");
+		span.arg("circuit", "a \"quoted\" name");
+		span.arg("tdf", true);
+	}
+	FILE* file = tmpfile();
+	TraceLog::write(file);
+	rewind(file);
+	char buffer[4096] = {};
+	fread(buffer, 1, sizeof(buffer) - 1, file);
+	fclose(file);
+	std::string json(buffer);
+	EXPECT_EQ(0, json.find("{\"displayTimeUnit\": \"ms\", \"traceEvents\": ["));
+	EXPECT_NE(std::string::npos, json.find("\"ph\": \"M\""));
+	EXPECT_NE(std::string::npos, json.find("\"name\": \"fault simulation iteration\", \"cat\": \"simulation\", \"ph\": \"X\""));
+	EXPECT_NE(std::string::npos, json.find("\"circuit\": \"a \\\"quoted\\\" name\", \"tdf\": true"));
+}
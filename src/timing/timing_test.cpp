@@ -0,0 +1,2 @@
+#include "gtest/gtest.h"
+#include "Timing.Tests.h"
@@ -0,0 +1,555 @@
+/**
+ * @file BatchMoghaddam.hpp
+ * @author Spencer Millican (millican@auburn.edu)
+ * @version 0.1
+ * @date 2020-06-19
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#ifndef BatchMoghaddam_h
+#define BatchMoghaddam_h
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <algorithm>
+
+#include "cop/BatchCOP.hpp"
+#include "cop/IncrementalCOP.hpp"
+#include "faults/Fault.hpp"
+
+/*
+ * The Moghaddam values (see Moghaddam) of an entire circuit at once, using the
+ * COP values of a batch COP calculation.
+ *
+ * Every object keeps its values in arrays (in object order, see BatchCOP):
+ * the number of faults propagated to it (D), the number of faults blocked if
+ * it is 0/1 (B) and the sum of the observabilities of its outputs (used by D).
+ * D is calculated by one forward sweep and B (for both blocking values) by one
+ * reverse sweep, without any recursion, memoization or casting.
+ *
+ * The values calculated are those calculated by Moghaddam objects (the same
+ * calculations are done in the same order), except the faults of an object
+ * none of whose outputs are observable (e.g., behind a control testpoint) are
+ * not distributed to its outputs (Moghaddam objects divide 0 by 0), and "buff"
+ * gates block faults as "buf" gates.
+ *
+ * After the COP values change (e.g., testpoints are added to an
+ * IncrementalCOP), only values affected by the changed objects are
+ * recalculated (see "update"). As with IncrementalCOP, every change is
+ * journaled, so it can be rolled back to a checkpoint. Testpoints change D and
+ * B only through the COP values they change: the circuit itself is not changed.
+ *
+ * @param _valueType The type of value being simulated, e.g., Value/FaultyValue
+ */
+template <class _valueType>
+class BatchMoghaddam {
+public:
+	/*
+	 * Create an empty calculator (see "index").
+	 */
+	BatchMoghaddam() {}
+
+	/*
+	 * Find the faults, gates and outputs of every object of a batch COP
+	 * calculation and calculate all values. This must be done again if the
+	 * calculation is built again.
+	 *
+	 * The number of faults of an object is the number of faults created for it
+	 * (see Faulty::getfaults), i.e., faults must be created first.
+	 *
+	 * @param _cop The batch COP calculation.
+	 */
+	void index(const BatchCOP<_valueType> & _cop);
+
+	/*
+	 * Calculate all values (at once) using the current COP values. The journal
+	 * is not changed.
+	 *
+	 * @param _cop The COP calculation (see "index").
+	 */
+	void calculate(const BatchCOP<_valueType> & _cop);
+
+	/*
+	 * Recalculate all values affected by COP values which changed since a
+	 * checkpoint.
+	 *
+	 * @param _cop The incremental COP calculation (see "index").
+	 * @param _checkpoint The checkpoint of the COP calculation at which values
+	 *        were last calculated.
+	 */
+	void update(IncrementalCOP<_valueType> & _cop, size_t _checkpoint);
+
+	/*
+	 * The number of faults propagated to an object.
+	 *
+	 * @param _id The id of the object.
+	 * @return The number of faults propagated to the object.
+	 */
+	float D(size_t _id) const {
+		return this->D_[_id];
+	}
+
+	/*
+	 * The number of faults blocked if an object is 0/1.
+	 *
+	 * @param _id The id of the object.
+	 * @param _blockingValue The value which will block faults.
+	 * @return The number of faults blocked.
+	 */
+	float B(size_t _id, bool _blockingValue) const {
+		return this->B_[2 * _id + (_blockingValue ? 1 : 0)];
+	}
+
+	/*
+	 * The number of objects.
+	 *
+	 * @return The number of objects.
+	 */
+	size_t size() const {
+		return this->D_.size();
+	}
+
+	/*
+	 * The current checkpoint (to roll back to).
+	 *
+	 * @return The checkpoint.
+	 */
+	size_t checkpoint() const {
+		return this->journal_.size();
+	}
+
+	/*
+	 * Undo all changes made since a checkpoint.
+	 *
+	 * @param _checkpoint The checkpoint.
+	 */
+	void rollback(size_t _checkpoint);
+
+	/*
+	 * Forget all changes (they can no longer be rolled back).
+	 */
+	void commit() {
+		this->journal_.clear();
+	}
+
+private:
+	/*
+	 * How an object forwards blocked faults (from its function, see
+	 * Moghaddam_Node::forwardBlocking).
+	 */
+	enum Gate : uint8_t {
+		LINE,
+		NONE, //No blocking (no function, const, po, xor, ...).
+		AND,
+		NAND,
+		OR,
+		NOR,
+		BUF,
+		NOT,
+		OTHER //Cannot block faults (an exception is thrown if asked to).
+	};
+
+	/*
+	 * A journaled (previous) value.
+	 */
+	struct Entry {
+		enum What : uint8_t { SUM, D, B };
+		uint8_t what;
+		uint32_t index;
+		float value;
+	};
+
+	/*
+	 * How every object forwards blocked faults and its number of faults.
+	 */
+	std::vector<uint8_t> gates_;
+	std::vector<float> faults_;
+
+	/*
+	 * The inputs of object "i" are inputs_[firstInput_[i]] to
+	 * inputs_[firstInput_[i + 1] - 1] (as BatchCOP) and its outputs (in output
+	 * order) are outputs_[firstOutput_[i]] to outputs_[firstOutput_[i + 1] - 1].
+	 */
+	std::vector<uint32_t> firstInput_;
+	std::vector<uint32_t> inputs_;
+	std::vector<uint32_t> firstOutput_;
+	std::vector<uint32_t> outputs_;
+
+	/*
+	 * The calculated values: the sum of output observabilities, D and B (two
+	 * per object: blocking value 0, then 1).
+	 */
+	std::vector<float> sum_;
+	std::vector<float> D_;
+	std::vector<float> B_;
+
+	/*
+	 * Is an object's D (forward) or B (backward) queued to be recalculated,
+	 * and the first and last ids queued? Queued objects are recalculated in
+	 * id order (D) and reverse id order (B): changing a value only queues
+	 * objects with larger (D) or smaller (B) ids, and a TP typically queues
+	 * most of its fan-in and fan-out cones, so no priority queue is needed.
+	 */
+	std::vector<uint8_t> queued_;
+	size_t forwardFirst_;
+	size_t forwardLast_;
+	size_t backwardFirst_;
+	size_t backwardLast_;
+
+	/*
+	 * Previous values (in the order they were changed).
+	 */
+	std::vector<Entry> journal_;
+
+	/*
+	 * The gate of a Node (from its function).
+	 *
+	 * @param _node The Node.
+	 * @return The gate of the Node.
+	 */
+	static uint8_t gate(COPNode<_valueType>* _node);
+
+	/*
+	 * Calculate the sum of the observabilities of an object's outputs.
+	 *
+	 * @param _cop The COP calculation.
+	 * @param _id The id of the object.
+	 * @return The sum of observabilities.
+	 */
+	float calculateSum(const BatchCOP<_valueType> & _cop, size_t _id) const;
+
+	/*
+	 * Calculate the number of faults propagated to an object (the D of its
+	 * inputs must be calculated).
+	 *
+	 * @param _cop The COP calculation.
+	 * @param _id The id of the object.
+	 * @return The number of faults propagated.
+	 */
+	float calculateD(const BatchCOP<_valueType> & _cop, size_t _id) const;
+
+	/*
+	 * Calculate the number of faults blocked if an object is 0/1 (the B of its
+	 * outputs must be calculated).
+	 *
+	 * @param _id The id of the object.
+	 * @param _blockingValue The value which blocks faults.
+	 * @return The number of faults blocked.
+	 */
+	float calculateB(size_t _id, bool _blockingValue) const;
+
+	/*
+	 * The number of blocked faults an output forwards to an object (see
+	 * Moghaddam::forwardBlocking and Moghaddam::lateralBlocking).
+	 *
+	 * @param _output The id of the output.
+	 * @param _calling The id of the object.
+	 * @param _blockingValue The value which blocks faults.
+	 * @return The number of blocked faults.
+	 */
+	float blocking(size_t _output, size_t _calling, bool _blockingValue) const;
+
+	/*
+	 * Change a value (journaling the previous value).
+	 *
+	 * @param _what The kind of value.
+	 * @param _index The index of the value.
+	 * @param _value The new value.
+	 * @return True if the value changed.
+	 */
+	bool change(uint8_t _what, uint32_t _index, float _value);
+
+	/*
+	 * Queue an object (if not already queued).
+	 *
+	 * @param _id The id of the object.
+	 * @param _forward Queue for D (else B).
+	 */
+	void queue(uint32_t _id, bool _forward) {
+		uint8_t flag = _forward ? 1 : 2;
+		if ((this->queued_[_id] & flag) == 0) {
+			this->queued_[_id] |= flag;
+			if (_forward) {
+				this->forwardFirst_ = std::min(this->forwardFirst_, (size_t)_id);
+				this->forwardLast_ = std::max(this->forwardLast_, (size_t)_id);
+			} else {
+				this->backwardFirst_ = std::min(this->backwardFirst_, (size_t)_id);
+				this->backwardLast_ = std::max(this->backwardLast_, (size_t)_id);
+			}
+		}
+	}
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Inline function declarations.
+////////////////////////////////////////////////////////////////////////////////
+
+template <class _valueType>
+inline uint8_t BatchMoghaddam<_valueType>::gate(COPNode<_valueType>* _node) {
+	Function<_valueType>* function = _node->function();
+	if (function == nullptr) { //This is a pi, po, or const
+		return NONE;
+	}
+	std::string name = function->string();
+	if (name == "and") {
+		return AND;
+	}
+	if (name == "nand") {
+		return NAND;
+	}
+	if (name == "or") {
+		return OR;
+	}
+	if (name == "nor") {
+		return NOR;
+	}
+	if (name == "buf" || name == "buff") {
+		return BUF;
+	}
+	if (name == "not") {
+		return NOT;
+	}
+	if (name == "const" || name == "po" || name == "xor" || name == "xnor") {
+		return NONE;
+	}
+	return OTHER;
+}
+
+template <class _valueType>
+void BatchMoghaddam<_valueType>::index(const BatchCOP<_valueType> & _cop) {
+	size_t size = _cop.size();
+	this->gates_.assign(size, LINE);
+	this->faults_.assign(size, 0.0f);
+	this->firstInput_.assign(size + 1, 0);
+	this->inputs_.clear();
+	this->firstOutput_.assign(size + 1, 0);
+	this->outputs_.clear();
+	for (size_t i = 0; i < size; i++) {
+		COP* object = _cop.object(i);
+		if (_cop.line(i) == false) {
+			COPNode<_valueType>* node = dynamic_cast<COPNode<_valueType>*>(object);
+			if (node == nullptr) {
+				throw "Cannot index Moghaddam values: a Node is not a COP Node.";
+			}
+			this->gates_[i] = gate(node);
+		}
+		Faulty<_valueType>* faulty = dynamic_cast<Faulty<_valueType>*>(object);
+		if (faulty != nullptr) {
+			this->faults_[i] = (float)faulty->getfaults().size();
+		}
+		std::pair<const uint32_t*, const uint32_t*> inputs = _cop.inputs(i);
+		this->inputs_.insert(this->inputs_.end(), inputs.first, inputs.second);
+		this->firstInput_[i + 1] = (uint32_t)this->inputs_.size();
+		for (Connecting* output : object->outputSpan()) {
+			this->outputs_.push_back((uint32_t)_cop.id(output));
+		}
+		this->firstOutput_[i + 1] = (uint32_t)this->outputs_.size();
+	}
+	this->sum_.assign(size, 0.0f);
+	this->D_.assign(size, 0.0f);
+	this->B_.assign(2 * size, 0.0f);
+	this->queued_.assign(size, 0);
+	this->forwardFirst_ = size;
+	this->forwardLast_ = 0;
+	this->backwardFirst_ = size;
+	this->backwardLast_ = 0;
+	this->journal_.clear();
+	this->calculate(_cop);
+}
+
+template <class _valueType>
+void BatchMoghaddam<_valueType>::calculate(const BatchCOP<_valueType> & _cop) {
+	if (this->D_.size() != _cop.size()) {
+		throw "Cannot calculate Moghaddam values: the circuit is not indexed.";
+	}
+	for (size_t i = 0; i < this->D_.size(); i++) {
+		this->sum_[i] = this->calculateSum(_cop, i);
+	}
+	for (size_t i = 0; i < this->D_.size(); i++) {
+		this->D_[i] = this->calculateD(_cop, i);
+	}
+	for (size_t i = this->D_.size(); i-- > 0;) {
+		this->B_[2 * i] = this->calculateB(i, false);
+		this->B_[2 * i + 1] = this->calculateB(i, true);
+	}
+}
+
+template <class _valueType>
+inline float BatchMoghaddam<_valueType>::calculateSum(const BatchCOP<_valueType> & _cop, size_t _id) const {
+	float toReturn = 0.0;
+	for (uint32_t k = this->firstOutput_[_id]; k < this->firstOutput_[_id + 1]; k++) {
+		toReturn += _cop.observability(this->outputs_[k]);
+	}
+	return toReturn;
+}
+
+template <class _valueType>
+inline float BatchMoghaddam<_valueType>::calculateD(const BatchCOP<_valueType> & _cop, size_t _id) const {
+	float toReturn = this->faults_[_id];
+	float observability = _cop.observability(_id);
+	for (uint32_t pin = this->firstInput_[_id]; pin < this->firstInput_[_id + 1]; pin++) {
+		uint32_t input = this->inputs_[pin];
+		if (this->sum_[input] > 0) { //Else, no faults are distributed.
+			toReturn += this->D_[input] * (observability / this->sum_[input]);
+		}
+	}
+	return toReturn;
+}
+
+template <class _valueType>
+inline float BatchMoghaddam<_valueType>::calculateB(size_t _id, bool _blockingValue) const {
+	float toReturn = 0.0;
+	for (uint32_t k = this->firstOutput_[_id]; k < this->firstOutput_[_id + 1]; k++) {
+		toReturn += this->blocking(this->outputs_[k], _id, _blockingValue);
+	}
+	return toReturn;
+}
+
+template <class _valueType>
+inline float BatchMoghaddam<_valueType>::blocking(size_t _output, size_t _calling, bool _blockingValue) const {
+	float forward = 0.0;
+	bool lateral = false;
+	switch (this->gates_[_output]) {
+	case LINE:
+	case BUF:
+		forward = this->B(_output, _blockingValue);
+		break;
+	case NOT:
+		forward = this->B(_output, !_blockingValue);
+		break;
+	case OR:
+	case NOR:
+		if (_blockingValue) {
+			forward = this->B(_output, this->gates_[_output] == OR);
+			lateral = true;
+		}
+		break;
+	case AND:
+	case NAND:
+		if (_blockingValue == false) {
+			forward = this->B(_output, this->gates_[_output] == NAND);
+			lateral = true;
+		}
+		break;
+	case OTHER:
+		throw "No valid gate type for blocking faults found.";
+	default:
+		break;
+	}
+	float lateralFaults = 0.0;
+	if (lateral) { //Faults on the other inputs are blocked as well.
+		for (uint32_t pin = this->firstInput_[_output]; pin < this->firstInput_[_output + 1]; pin++) {
+			if (this->inputs_[pin] != _calling) {
+				lateralFaults += this->D_[this->inputs_[pin]];
+			}
+		}
+	}
+	return forward + lateralFaults;
+}
+
+template <class _valueType>
+inline bool BatchMoghaddam<_valueType>::change(uint8_t _what, uint32_t _index, float _value) {
+	float* value = nullptr;
+	switch (_what) {
+	case Entry::SUM:
+		value = &this->sum_[_index];
+		break;
+	case Entry::D:
+		value = &this->D_[_index];
+		break;
+	default:
+		value = &this->B_[_index];
+	}
+	if (*value == _value) {
+		return false;
+	}
+	this->journal_.push_back({ _what, _index, *value });
+	*value = _value;
+	return true;
+}
+
+template <class _valueType>
+void BatchMoghaddam<_valueType>::update(IncrementalCOP<_valueType> & _cop, size_t _checkpoint) {
+	if (this->D_.size() != _cop.size()) {
+		throw "Cannot update Moghaddam values: the circuit is not indexed.";
+	}
+
+	//Changed observabilities change the sums of their inputs, and so the D of
+	//their inputs' outputs.
+	for (const typename IncrementalCOP<_valueType>::Change & change : _cop.changes(_checkpoint)) {
+		if (change.observability == _cop.observability(change.id)) {
+			continue;
+		}
+		this->queue(change.id, true);
+		for (uint32_t pin = this->firstInput_[change.id]; pin < this->firstInput_[change.id + 1]; pin++) {
+			uint32_t input = this->inputs_[pin];
+			if (this->change(Entry::SUM, input, this->calculateSum(_cop, input))) {
+				for (uint32_t k = this->firstOutput_[input]; k < this->firstOutput_[input + 1]; k++) {
+					this->queue(this->outputs_[k], true);
+				}
+			}
+		}
+	}
+
+	//D: through the fan-out of changed objects.
+	for (size_t id = this->forwardFirst_; id <= this->forwardLast_; id++) {
+		if ((this->queued_[id] & 1) == 0) {
+			continue;
+		}
+		this->queued_[id] &= ~1;
+		if (this->change(Entry::D, (uint32_t)id, this->calculateD(_cop, id)) == false) {
+			continue;
+		}
+		for (uint32_t k = this->firstOutput_[id]; k < this->firstOutput_[id + 1]; k++) {
+			uint32_t output = this->outputs_[k];
+			this->queue(output, true);
+			for (uint32_t pin = this->firstInput_[output]; pin < this->firstInput_[output + 1]; pin++) {
+				if (this->inputs_[pin] != (uint32_t)id) { //Its other inputs block it differently.
+					this->queue(this->inputs_[pin], false);
+				}
+			}
+		}
+	}
+	this->forwardFirst_ = this->size();
+	this->forwardLast_ = 0;
+
+	//B: through the fan-in of changed objects.
+	for (size_t id = this->backwardLast_ + 1; id-- > this->backwardFirst_;) {
+		if ((this->queued_[id] & 2) == 0) {
+			continue;
+		}
+		this->queued_[id] &= ~2;
+		bool changed = this->change(Entry::B, (uint32_t)(2 * id), this->calculateB(id, false));
+		changed = this->change(Entry::B, (uint32_t)(2 * id + 1), this->calculateB(id, true)) || changed;
+		if (changed) {
+			for (uint32_t pin = this->firstInput_[id]; pin < this->firstInput_[id + 1]; pin++) {
+				this->queue(this->inputs_[pin], false);
+			}
+		}
+	}
+	this->backwardFirst_ = this->size();
+	this->backwardLast_ = 0;
+}
+
+template <class _valueType>
+void BatchMoghaddam<_valueType>::rollback(size_t _checkpoint) {
+	while (this->journal_.size() > _checkpoint) {
+		const Entry & entry = this->journal_.back();
+		switch (entry.what) {
+		case Entry::SUM:
+			this->sum_[entry.index] = entry.value;
+			break;
+		case Entry::D:
+			this->D_[entry.index] = entry.value;
+			break;
+		default:
+			this->B_[entry.index] = entry.value;
+		}
+		this->journal_.pop_back();
+	}
+}
+
+#endif
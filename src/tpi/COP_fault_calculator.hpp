@@ -12,10 +12,15 @@
 #ifndef COP_fault_calculator_h
 #define COP_fault_calculator_h
 
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
 #include "structures/Circuit.h"
 #include "faults/Fault.hpp"
 #include "faults/FaultGenerator.hpp"
 #include "cop/COPStructures.hpp"
+#include "cop/IncrementalCOP.hpp"
 
 /*
  * Calculates the fault coverage of a circuit using COP values.
@@ -45,6 +50,50 @@ public:
 	 */
 	float faultCoverage();
 
+	/*
+	 * The predicted fault coverage using the values of a batch COP calculation
+	 * (instead of the values of COP objects).
+	 *
+	 * @param _cop The calculated COP values of the circuit.
+	 * @return The predicted fault coverage.
+	 */
+	float faultCoverage(const BatchCOP<_valueType> & _cop);
+
+	/*
+	 * Find the location of every fault in a batch COP calculation and the
+	 * probability every fault is detected (needed to calculate incremental
+	 * fault coverage). This must be done again if the calculation is built
+	 * again.
+	 *
+	 * @param _cop The batch COP calculation.
+	 */
+	void index(const BatchCOP<_valueType> & _cop);
+
+	/*
+	 * The predicted fault coverage after an incremental COP calculation
+	 * changed since a checkpoint.
+	 *
+	 * Only faults on objects whose values changed are calculated: the change
+	 * in their detection probability is added to the sum of all detection
+	 * probabilities (see "index" and "accumulate").
+	 *
+	 * @param _cop The incremental COP calculation (see "index").
+	 * @param _checkpoint The checkpoint at which the detection probabilities
+	 *        were last accumulated.
+	 * @return The predicted fault coverage.
+	 */
+	float faultCoverage(IncrementalCOP<_valueType> & _cop, size_t _checkpoint) const;
+
+	/*
+	 * Keep the detection probabilities of faults on objects whose values
+	 * changed since a checkpoint (e.g., before the changes are committed).
+	 *
+	 * @param _cop The incremental COP calculation (see "index").
+	 * @param _checkpoint The checkpoint at which the detection probabilities
+	 *        were last accumulated.
+	 */
+	void accumulate(IncrementalCOP<_valueType> & _cop, size_t _checkpoint);
+
 	/*
 	 * Clear the calculator's list of faults (will NOT delete).
 	 *
@@ -66,12 +115,64 @@ private:
 	 */
 	float detect(Fault<_valueType>* _fault);
 
+	/*
+	 * The probability a fault is detected given the COP values of its location.
+	 *
+	 * @param _SAValue The stuck-at value of the fault.
+	 * @param CC The controllability of the fault's location.
+	 * @param CO The observability of the fault's location.
+	 * @return The probability of detection.
+	 */
+	float detect(bool _SAValue, float CC, float CO);
+
+	/*
+	 * The probability a fault is detected by a single vector given the COP
+	 * values of its location.
+	 *
+	 * @param _SAValue The stuck-at value of the fault.
+	 * @param CC The controllability of the fault's location.
+	 * @param CO The observability of the fault's location.
+	 * @return The probability of detection by a single vector.
+	 */
+	float probability(bool _SAValue, float CC, float CO) const;
+
+	/*
+	 * The probabilities faults are detected by all vectors given their
+	 * probabilities of detection by a single vector, i.e., 1-(1-p)^v,
+	 * calculated as -expm1(v*log1p(-p)) for a batch of faults at once
+	 * (vectorized, if possible).
+	 *
+	 * @param _probabilities Probabilities of detection by a single vector.
+	 * @param _detected The probabilities of detection (returned).
+	 * @param _size The number of faults.
+	 */
+	void detect(const float* _probabilities, float* _detected, size_t _size) const;
+
+	/*
+	 * The number of faults calculated in one batch (see "detect").
+	 */
+	static const size_t BATCH = 64;
+
 	/*
 	*if it is true use stuck target cop. if it is false use delay target cop
 	*/
 
 	bool stuck_target_;
 	int v_;
+
+	/*
+	 * The faults on object "i" (see "index") have the stuck-at values
+	 * faultValues_[firstFault_[i]] to faultValues_[firstFault_[i + 1] - 1].
+	 */
+	std::vector<uint32_t> firstFault_;
+	std::vector<bool> faultValues_;
+
+	/*
+	 * The (last accumulated) probability every fault is detected, in the
+	 * same order as "faultValues_", and their sum.
+	 */
+	std::vector<float> detected_;
+	double sum_;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -89,6 +190,7 @@ COP_fault_calculator<_valueType>::COP_fault_calculator(Circuit * _circuit, bool
 
 	this->stuck_target_ = stuck_target;
 	this->v_ = v;
+	this->sum_ = 0.0;
 }
 
 template <class _valueType>
@@ -109,10 +211,103 @@ float COP_fault_calculator<_valueType>::faultCoverage() {
 	return toReturn;
 }
 
+template <class _valueType>
+float COP_fault_calculator<_valueType>::faultCoverage(const BatchCOP<_valueType> & _cop) {
+	float toReturn = 0.0;
+	for (Fault<_valueType>* fault : this->faults_) {
+		size_t id = _cop.id(fault->location());
+		toReturn += this->detect(fault->value().magnitude(), _cop.controllability(id), _cop.observability(id));
+	}
+	toReturn /= (float)this->faults_.size();
+	return toReturn;
+}
+
+template <class _valueType>
+void COP_fault_calculator<_valueType>::index(const BatchCOP<_valueType> & _cop) {
+	std::vector<std::pair<uint32_t, bool>> faults;
+	faults.reserve(this->faults_.size());
+	for (Fault<_valueType>* fault : this->faults_) {
+		faults.push_back(std::make_pair((uint32_t)_cop.id(fault->location()), (bool)fault->value().magnitude()));
+	}
+	std::sort(faults.begin(), faults.end());
+	this->firstFault_.assign(_cop.size() + 1, 0);
+	this->faultValues_.clear();
+	std::vector<float> probabilities;
+	probabilities.reserve(faults.size());
+	for (std::pair<uint32_t, bool> fault : faults) {
+		this->firstFault_[fault.first + 1]++;
+		this->faultValues_.push_back(fault.second);
+		probabilities.push_back(this->probability(fault.second, _cop.controllability(fault.first), _cop.observability(fault.first)));
+	}
+	for (size_t i = 0; i < _cop.size(); i++) {
+		this->firstFault_[i + 1] += this->firstFault_[i];
+	}
+	this->detected_.resize(faults.size());
+	this->detect(probabilities.data(), this->detected_.data(), faults.size());
+	this->sum_ = 0.0;
+	for (float detected : this->detected_) {
+		this->sum_ += detected;
+	}
+}
+
+template <class _valueType>
+float COP_fault_calculator<_valueType>::faultCoverage(IncrementalCOP<_valueType> & _cop, size_t _checkpoint) const {
+	if (this->firstFault_.size() != _cop.size() + 1) {
+		throw "Cannot calculate incremental fault coverage: the faults are not indexed.";
+	}
+	double delta = 0.0;
+	float probabilities[BATCH];
+	float detected[BATCH];
+	uint32_t faults[BATCH];
+	size_t size = 0;
+	for (const typename IncrementalCOP<_valueType>::Change & change : _cop.changes(_checkpoint)) {
+		float CC = _cop.controllability(change.id);
+		float CO = _cop.observability(change.id);
+		for (uint32_t i = this->firstFault_[change.id]; i < this->firstFault_[change.id + 1]; i++) {
+			if (size == BATCH) {
+				this->detect(probabilities, detected, size);
+				for (size_t j = 0; j < size; j++) {
+					delta += detected[j] - this->detected_[faults[j]];
+				}
+				size = 0;
+			}
+			probabilities[size] = this->probability(this->faultValues_[i], CC, CO);
+			faults[size] = i;
+			size++;
+		}
+	}
+	this->detect(probabilities, detected, size);
+	for (size_t j = 0; j < size; j++) {
+		delta += detected[j] - this->detected_[faults[j]];
+	}
+	return (float)((this->sum_ + delta) / (double)this->faults_.size());
+}
+
+template <class _valueType>
+void COP_fault_calculator<_valueType>::accumulate(IncrementalCOP<_valueType> & _cop, size_t _checkpoint) {
+	if (this->firstFault_.size() != _cop.size() + 1) {
+		throw "Cannot accumulate fault detection probabilities: the faults are not indexed.";
+	}
+	for (const typename IncrementalCOP<_valueType>::Change & change : _cop.changes(_checkpoint)) {
+		float CC = _cop.controllability(change.id);
+		float CO = _cop.observability(change.id);
+		for (uint32_t i = this->firstFault_[change.id]; i < this->firstFault_[change.id + 1]; i++) {
+			float probability = this->probability(this->faultValues_[i], CC, CO);
+			float detected;
+			this->detect(&probability, &detected, 1);
+			this->sum_ += detected - this->detected_[i];
+			this->detected_[i] = detected;
+		}
+	}
+}
+
 template <class _valueType>
 std::unordered_set<Fault<_valueType>*> COP_fault_calculator<_valueType>::clearFaults() {
 	std::unordered_set<Fault<_valueType>*> toReturn = this->faults_;
 	this->faults_.clear();
+	this->firstFault_.clear();
+	this->faultValues_.clear();
+	this->detected_.clear();
 	return toReturn;
 }
 
@@ -123,10 +318,14 @@ float COP_fault_calculator<_valueType>::detect(Fault<_valueType>* _fault) {
 	if (cast == nullptr) {
 		throw "Cannot calculate fault-based fault coverage: COP not enabled on the fault location.";
 	}
-	auto SAValue = _fault->value().magnitude();
 	float CC = cast->controllability();
 	float CO = cast->observability();
-	if (SAValue) {
+	return this->detect(_fault->value().magnitude(), CC, CO);
+}
+
+template <class _valueType>
+float COP_fault_calculator<_valueType>::detect(bool _SAValue, float CC, float CO) {
+	if (_SAValue) {
 		CC = 1 - CC;
 	}
 	//DEBUG printf("DBG Fault: %s (%d outputs) sa%d -> %f\n", _fault->location()->name().c_str(), _fault->location()->outputs().size(), SAValue, CC*CO); //DEBUG
@@ -141,6 +340,26 @@ float COP_fault_calculator<_valueType>::detect(Fault<_valueType>* _fault) {
 	}
 }
 
+template <class _valueType>
+float COP_fault_calculator<_valueType>::probability(bool _SAValue, float CC, float CO) const {
+	if (_SAValue) {
+		CC = 1 - CC;
+	}
+	if (this->stuck_target_ == true) {
+		return CC * CO;
+	}
+	return CC * CO * (1 - CC);
+}
+
+template <class _valueType>
+void COP_fault_calculator<_valueType>::detect(const float* _probabilities, float* _detected, size_t _size) const {
+	const float v = (float)this->v_;
+	#pragma omp simd
+	for (size_t i = 0; i < _size; i++) {
+		_detected[i] = -std::expm1(v * std::log1p(-_probabilities[i]));
+	}
+}
+
 
 
 #endif
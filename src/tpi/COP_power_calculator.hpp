@@ -0,0 +1,196 @@
+/**
+ * @file COP_power_calculator.hpp
+ * @author Spencer Millican (millican@auburn.edu)
+ * @version 0.1
+ * @date 2020-06-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+
+#ifndef COP_power_calculator_h
+#define COP_power_calculator_h
+
+#include <vector>
+#include <cmath>
+
+#include "cop/BatchCOP.hpp"
+#include "cop/IncrementalCOP.hpp"
+
+/*
+ * Calculates the power metric of a circuit (see TPI_POWER) using COP values:
+ * the sum, over all Lines, of how far the Line's controllability is from 0.5
+ * (i.e., |CC - 0.5|). The further a Line's controllability is from 0.5, the
+ * less often it is expected to switch.
+ *
+ * The metric of every Line is kept in an array (in object order, see
+ * BatchCOP) along with their sum, so the metric after editing an
+ * IncrementalCOP only needs the Lines changed since a checkpoint.
+ *
+ * @param _valueType The type of value being simulated, e.g., Value/FaultyValue
+ */
+template <class _valueType>
+class COP_power_calculator {
+public:
+	/*
+	 * Create a calculator (which must be indexed before calculating
+	 * incrementally).
+	 */
+	COP_power_calculator();
+
+	/*
+	 * The power metric using the values of a batch COP calculation.
+	 *
+	 * @param _cop The calculated COP values of the circuit.
+	 * @return The power metric.
+	 */
+	float power(const BatchCOP<_valueType> & _cop) const;
+
+	/*
+	 * Find all Lines of a batch COP calculation and the power metric of each.
+	 * This must be done again if the calculation is built again.
+	 *
+	 * @param _cop The batch COP calculation.
+	 */
+	void index(const BatchCOP<_valueType> & _cop);
+
+	/*
+	 * The (last accumulated) power metric.
+	 *
+	 * @return The power metric.
+	 */
+	float power() const;
+
+	/*
+	 * The power metric after an incremental COP calculation changed since a
+	 * checkpoint.
+	 *
+	 * Only Lines whose values changed are calculated: the change in their
+	 * metric is added to the sum of all metrics (see "index" and
+	 * "accumulate").
+	 *
+	 * @param _cop The incremental COP calculation (see "index").
+	 * @param _checkpoint The checkpoint at which the metrics were last
+	 *        accumulated.
+	 * @return The power metric.
+	 */
+	float power(IncrementalCOP<_valueType> & _cop, size_t _checkpoint) const;
+
+	/*
+	 * Keep the metrics of Lines whose values changed since a checkpoint (e.g.,
+	 * before the changes are committed).
+	 *
+	 * @param _cop The incremental COP calculation (see "index").
+	 * @param _checkpoint The checkpoint at which the metrics were last
+	 *        accumulated.
+	 */
+	void accumulate(IncrementalCOP<_valueType> & _cop, size_t _checkpoint);
+
+	/*
+	 * The number of Lines (see "index").
+	 *
+	 * @return The number of Lines.
+	 */
+	size_t lines() const;
+
+private:
+	/*
+	 * The power metric of a single Line.
+	 *
+	 * @param CC The controllability of the Line.
+	 * @return The power metric of the Line.
+	 */
+	float power(float CC) const;
+
+	/*
+	 * The (last accumulated) power metric of every object (0 for objects
+	 * which are not Lines), their sum and the number of Lines.
+	 */
+	std::vector<float> power_;
+	std::vector<bool> line_;
+	double sum_;
+	size_t lines_;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Inline function declarations.
+////////////////////////////////////////////////////////////////////////////////
+
+template <class _valueType>
+COP_power_calculator<_valueType>::COP_power_calculator() {
+	this->sum_ = 0.0;
+	this->lines_ = 0;
+}
+
+template <class _valueType>
+float COP_power_calculator<_valueType>::power(const BatchCOP<_valueType> & _cop) const {
+	double toReturn = 0.0;
+	for (size_t i = 0; i < _cop.size(); i++) {
+		if (_cop.line(i)) {
+			toReturn += this->power(_cop.controllability(i));
+		}
+	}
+	return (float)toReturn;
+}
+
+template <class _valueType>
+void COP_power_calculator<_valueType>::index(const BatchCOP<_valueType> & _cop) {
+	this->power_.assign(_cop.size(), 0.0f);
+	this->line_.assign(_cop.size(), false);
+	this->sum_ = 0.0;
+	this->lines_ = 0;
+	for (size_t i = 0; i < _cop.size(); i++) {
+		if (_cop.line(i)) {
+			this->line_[i] = true;
+			this->power_[i] = this->power(_cop.controllability(i));
+			this->sum_ += this->power_[i];
+			this->lines_++;
+		}
+	}
+}
+
+template <class _valueType>
+float COP_power_calculator<_valueType>::power() const {
+	return (float)this->sum_;
+}
+
+template <class _valueType>
+float COP_power_calculator<_valueType>::power(IncrementalCOP<_valueType> & _cop, size_t _checkpoint) const {
+	if (this->power_.size() != _cop.size()) {
+		throw "Cannot calculate incremental power: the lines are not indexed.";
+	}
+	double delta = 0.0;
+	for (const typename IncrementalCOP<_valueType>::Change & change : _cop.changes(_checkpoint)) {
+		if (this->line_[change.id]) {
+			delta += this->power(_cop.controllability(change.id)) - this->power_[change.id];
+		}
+	}
+	return (float)(this->sum_ + delta);
+}
+
+template <class _valueType>
+void COP_power_calculator<_valueType>::accumulate(IncrementalCOP<_valueType> & _cop, size_t _checkpoint) {
+	if (this->power_.size() != _cop.size()) {
+		throw "Cannot accumulate power: the lines are not indexed.";
+	}
+	for (const typename IncrementalCOP<_valueType>::Change & change : _cop.changes(_checkpoint)) {
+		if (this->line_[change.id]) {
+			float power = this->power(_cop.controllability(change.id));
+			this->sum_ += power - this->power_[change.id];
+			this->power_[change.id] = power;
+		}
+	}
+}
+
+template <class _valueType>
+size_t COP_power_calculator<_valueType>::lines() const {
+	return this->lines_;
+}
+
+template <class _valueType>
+float COP_power_calculator<_valueType>::power(float CC) const {
+	return std::fabs(CC - 0.5f);
+}
+
+#endif
@@ -0,0 +1,72 @@
+/**
+ * @file COP_power_calculator_Tests.hpp
+ * @author Spencer Millican (millican@auburn.edu)
+ * @version 0.1
+ * @date 2020-06-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "parser/Parser.hpp"
+#include "tpi/COP_power_calculator.hpp"
+
+class COP_power_calculatorTest : public ::testing::Test {
+public:
+	void SetUp() override {
+		this->c17 = this->parser.Parse("c17.bench");
+		this->cop.build(this->c17);
+		this->cop.calculate();
+		this->cop.store();
+		this->calculator.index(this->cop);
+		for (size_t i = 0; i < this->cop.size(); i++) {
+			if (this->cop.line(i)) {
+				this->lines.push_back(i);
+			}
+		}
+	}
+
+	void TearDown() override {
+		delete this->c17;
+	}
+
+	Parser<COPLine<Value<bool>>, COPNode<Value<bool>>, Value<bool>> parser;
+	Circuit* c17;
+	IncrementalCOP<Value<bool>> cop;
+	COP_power_calculator<Value<bool>> calculator;
+	std::vector<size_t> lines;
+};
+
+//The metric after a change is the same as measuring every Line.
+TEST_F(COP_power_calculatorTest, SameAsBatchTest) {
+	EXPECT_EQ(this->lines.size(), this->calculator.lines());
+	EXPECT_FLOAT_EQ(this->calculator.power(this->cop), this->calculator.power());
+	for (size_t line : this->lines) {
+		size_t checkpoint = this->cop.checkpoint();
+		this->cop.control(line, true);
+		this->cop.update();
+		EXPECT_NEAR(this->calculator.power(this->cop), this->calculator.power(this->cop, checkpoint), 1e-5);
+		this->cop.rollback(checkpoint);
+
+		this->cop.invert(line);
+		this->cop.update();
+		EXPECT_NEAR(this->calculator.power(this->cop), this->calculator.power(this->cop, checkpoint), 1e-5);
+		this->cop.rollback(checkpoint);
+	}
+}
+
+//Accumulated changes are kept.
+TEST_F(COP_power_calculatorTest, AccumulateTest) {
+	for (size_t i = 0; i < this->lines.size(); i += 2) {
+		size_t checkpoint = this->cop.checkpoint();
+		this->cop.control(this->lines.at(i), i % 4 == 0);
+		this->cop.update();
+		this->calculator.accumulate(this->cop, checkpoint);
+		this->cop.commit();
+		EXPECT_NEAR(this->calculator.power(this->cop), this->calculator.power(), 1e-5);
+		EXPECT_FLOAT_EQ(this->calculator.power(), this->calculator.power(this->cop, this->cop.checkpoint()));
+	}
+}
@@ -96,11 +96,11 @@ protected:
 		float toReturn = (float) this->getfaults().size();
 
 		//No inputs? Easy calculation.
-		if (this->inputs().size() == 0) {
+		if (this->inputSpan().size() == 0) {
 			return toReturn;
 		}
 
-		for (Connecting* input : this->inputs()) {
+		for (Connecting* input : this->inputSpan()) {
 			Moghaddam<_primitive>* cast = dynamic_cast<Moghaddam<_primitive>*>(input);
 			if (cast == nullptr) {
 				throw "Input cannot propigate faults.";
@@ -108,7 +108,7 @@ protected:
 
 			float faultsToDistibute = cast->D();
 			float sumCO = 0.0; //The sum of observabilities.
-			for (Connecting* inputOutput : cast->outputs()) {
+			for (Connecting* inputOutput : cast->outputSpan()) {
 				cast = dynamic_cast<Moghaddam<_primitive>*>(inputOutput);
 				if (cast == nullptr) {
 					throw "Input's outputs cannot propigate faults.";
@@ -131,7 +131,7 @@ protected:
 	 */
 	float calculateB(bool _blockingValue) {
 		float toReturn = 0.0;
-		for (Connecting* output : this->outputs()) {
+		for (Connecting* output : this->outputSpan()) {
 			Moghaddam<_primitive>* cast = dynamic_cast<Moghaddam<_primitive>*>(output);
 			if (cast == nullptr) {
 				throw "Input cannot propigate faults.";
@@ -152,14 +152,14 @@ protected:
 			return;
 		}
 		this->D_ = -1;
-		std::unordered_set<Connecting*> outputs = this->outputs();
+		ConnectingSpan outputs = this->outputSpan();
 		for (Connecting * output : outputs) {
 			Moghaddam<_primitive>* cast = dynamic_cast<Moghaddam<_primitive>*>(output);
 			cast->clearD();
 
 			//Changing D can change b/B on "parallel" lines (e.g., the lines feeding the
 			//same gate).
-			for (Connecting * possiblyParralInput : output->inputs()) {
+			for (Connecting * possiblyParralInput : output->inputSpan()) {
 				if (possiblyParralInput != this) {
 					Moghaddam<_primitive>* parallelInput = dynamic_cast<Moghaddam<_primitive>*>(possiblyParralInput);
 					parallelInput->clearB();
@@ -178,7 +178,7 @@ protected:
 			return;
 		}
 		this->B_ = std::vector<float>(2, -1);
-		std::unordered_set<Connecting*> inputs = this->inputs();
+		ConnectingSpan inputs = this->inputSpan();
 		//DEBUG printf("DONE, forward to %d\n", inputs.size());
 		for (Connecting * input : inputs) {
 			Moghaddam<_primitive>* cast = dynamic_cast<Moghaddam<_primitive>*>(input);
@@ -366,7 +366,7 @@ protected:
 	 * @return The number of blocked faults.
 	 */
 	virtual float lateralBlocking(bool _blockingValue, Moghaddam<_primitive>* _calling) {
-		if (this->inputs().size() > 1) {
+		if (this->inputSpan().size() > 1) {
 			throw "Something is seriously wrong here: a line cannot have more than one input.";
 		}
 		return 0.0;
@@ -529,7 +529,7 @@ protected:
 			}
 
 			float toReturn = 0.0;
-			for (Connecting * input : this->inputs()) {
+			for (Connecting * input : this->inputSpan()) {
 				if (input == _calling) {
 					continue;
 				}
@@ -0,0 +1,206 @@
+/**
+ * @file TPCandidates.hpp
+ * @author Spencer Millican (millican@auburn.edu)
+ * @version 0.1
+ * @date 2020-06-16
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#ifndef TPCandidates_h
+#define TPCandidates_h
+
+#include <vector>
+#include <unordered_set>
+#include <functional>
+#include <cstdint>
+
+#include "structures/Circuit.h"
+#include "tpi/Testpoint_control.hpp"
+#include "tpi/Testpoint_observe.hpp"
+#include "tpi/Testpoint_invert.hpp"
+
+/*
+ * A testpoint which may be inserted (see TPCandidates): where, what kind and
+ * (for control testpoints) which value.
+ */
+struct TPCandidate {
+	enum Kind : uint8_t { CONTROL, OBSERVE, INVERT };
+
+	/*
+	 * The location of the testpoint (an index into its TPCandidates' sites).
+	 */
+	uint32_t site;
+
+	/*
+	 * The kind of testpoint.
+	 */
+	uint8_t kind;
+
+	/*
+	 * The value of a control testpoint.
+	 */
+	bool value;
+};
+
+/*
+ * All places testpoints may be inserted into a circuit (every Line of a Node
+ * which is not a PI, as TPGenerator) and descriptions of the testpoints on
+ * them.
+ *
+ * Testpoints are described by (small) TPCandidates instead of Testpoint
+ * objects: only chosen testpoints need to be created (see "testpoint").
+ *
+ * @param _nodeType The type of nodes used in the circuit.
+ * @param _lineType The type of lines used in the circuit.
+ * @param _valueType The type of value being simulated, e.g., Value/FaultyValue
+ */
+template <class _nodeType, class _lineType, class _valueType>
+class TPCandidates {
+public:
+	/*
+	 * Find all places testpoints may be inserted into a circuit.
+	 *
+	 * @param _circuit The circuit.
+	 */
+	TPCandidates(Circuit* _circuit) {
+		std::unordered_set<_lineType*> found;
+		for (Levelized* node : _circuit->nodes()) {
+			if (node->inputSpan().size() == 0) { //No testpoints on PIs.
+				continue;
+			}
+			for (Connecting* input : node->inputSpan()) {
+				this->add(dynamic_cast<_lineType*>(input), found);
+			}
+			for (Connecting* output : node->outputSpan()) {
+				this->add(dynamic_cast<_lineType*>(output), found);
+			}
+		}
+	}
+
+	/*
+	 * Describe all testpoints of a given kind (control testpoints have both
+	 * values) on all places which pass a filter.
+	 *
+	 * E.g., only on fan-out stems: candidates(TPCandidate::OBSERVE, stem). Any
+	 * other filter can be given, e.g., on the COP values of each Line.
+	 *
+	 * @param _kind The kind of testpoints.
+	 * @param (optional) _filter Testpoints are only on Lines for which this
+	 *        returns true. By default, all Lines.
+	 * @return The testpoints.
+	 */
+	std::vector<TPCandidate> candidates(TPCandidate::Kind _kind, std::function<bool(_lineType*)> _filter = nullptr) const {
+		std::vector<TPCandidate> toReturn;
+		toReturn.reserve(this->sites_.size() * (_kind == TPCandidate::CONTROL ? 2 : 1));
+		for (uint32_t site = 0; site < this->sites_.size(); site++) {
+			if (_filter != nullptr && _filter(this->sites_[site]) == false) {
+				continue;
+			}
+			if (_kind == TPCandidate::CONTROL) {
+				toReturn.push_back(TPCandidate{ site, (uint8_t)_kind, false });
+				toReturn.push_back(TPCandidate{ site, (uint8_t)_kind, true });
+			} else {
+				toReturn.push_back(TPCandidate{ site, (uint8_t)_kind, false });
+			}
+		}
+		return toReturn;
+	}
+
+	/*
+	 * The number of places testpoints may be inserted.
+	 *
+	 * @return The number of places.
+	 */
+	size_t size() const {
+		return this->sites_.size();
+	}
+
+	/*
+	 * The location of a testpoint.
+	 *
+	 * @param _candidate The testpoint.
+	 * @return The location of the testpoint.
+	 */
+	_lineType* location(const TPCandidate & _candidate) const {
+		return this->sites_.at(_candidate.site);
+	}
+
+	/*
+	 * The value of a control testpoint (as it is given by TPGenerator).
+	 *
+	 * @param _candidate The testpoint.
+	 * @return The value of the testpoint.
+	 */
+	_valueType value(const TPCandidate & _candidate) const {
+		_valueType toReturn(0);
+		if (_candidate.value) {
+			toReturn.increment();
+		}
+		return toReturn;
+	}
+
+	/*
+	 * Create a described testpoint (inactive).
+	 *
+	 * @param _candidate The testpoint.
+	 * @return A new testpoint (which must be deleted elsewhere).
+	 */
+	Testpoint<_nodeType, _lineType, _valueType>* testpoint(const TPCandidate & _candidate) const {
+		switch (_candidate.kind) {
+		case TPCandidate::CONTROL:
+			return new Testpoint_control<_nodeType, _lineType, _valueType>(this->location(_candidate), this->value(_candidate));
+		case TPCandidate::OBSERVE:
+			return new Testpoint_observe<_nodeType, _lineType, _valueType>(this->location(_candidate));
+		case TPCandidate::INVERT:
+			return new Testpoint_invert<_nodeType, _lineType, _valueType>(this->location(_candidate));
+		}
+		throw "Unknown testpoint kind.";
+	}
+
+	/*
+	 * Is a Line driven by something other than a PI?
+	 *
+	 * @param _line The Line.
+	 * @return True if the Line is not driven by a PI.
+	 */
+	static bool notPI(_lineType* _line) {
+		for (Connecting* input : _line->inputSpan()) {
+			if (input->inputSpan().size() == 0) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	/*
+	 * Is a Line a fan-out stem (i.e., does it have more than one output)?
+	 *
+	 * @param _line The Line.
+	 * @return True if the Line is a fan-out stem.
+	 */
+	static bool stem(_lineType* _line) {
+		return _line->outputSpan().size() > 1;
+	}
+
+private:
+	/*
+	 * All places testpoints may be inserted.
+	 */
+	std::vector<_lineType*> sites_;
+
+	/*
+	 * Add a place (once).
+	 *
+	 * @param _line The Line (ignored if null).
+	 * @param _found All places added so far.
+	 */
+	void add(_lineType* _line, std::unordered_set<_lineType*> & _found) {
+		if (_line != nullptr && _found.insert(_line).second) {
+			this->sites_.push_back(_line);
+		}
+	}
+};
+
+#endif
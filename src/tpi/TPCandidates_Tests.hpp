@@ -0,0 +1,74 @@
+/**
+ * @file TPCandidates_Tests.hpp
+ * @author Spencer Millican (millican@auburn.edu)
+ * @version 0.1
+ * @date 2020-06-16
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#include <set>
+#include <utility>
+
+#include "gtest/gtest.h"
+#include "parser/Parser.hpp"
+#include "COP_TPI_Structures.hpp"
+#include "tpi/TPCandidates.hpp"
+#include "tpi/TPGenerator.hpp"
+#include "faults/FaultyValue.hpp"
+
+class TPCandidatesTest : public ::testing::Test {
+public:
+	void SetUp() override {
+		this->c17 = this->parser.Parse("c17.bench");
+	}
+
+	void TearDown() override {
+		delete this->c17;
+	}
+
+	Parser<COP_TPI_Line<FaultyValue<bool>>, COP_TPI_Node<FaultyValue<bool>>, FaultyValue<bool>> parser;
+	Circuit* c17;
+};
+
+//The same testpoints are described as TPGenerator creates.
+TEST_F(TPCandidatesTest, SameAsGeneratorTest) {
+	typedef Testpoint<COP_TPI_Node<FaultyValue<bool>>, COP_TPI_Line<FaultyValue<bool>>, FaultyValue<bool>> TESTPOINT;
+	typedef Testpoint_control<COP_TPI_Node<FaultyValue<bool>>, COP_TPI_Line<FaultyValue<bool>>, FaultyValue<bool>> CONTROL;
+	TPCandidates<COP_TPI_Node<FaultyValue<bool>>, COP_TPI_Line<FaultyValue<bool>>, FaultyValue<bool>> candidates(this->c17);
+	std::set<std::pair<Connecting*, bool>> generated;
+	for (TESTPOINT* testpoint : TPGenerator<CONTROL, COP_TPI_Node<FaultyValue<bool>>, COP_TPI_Line<FaultyValue<bool>>, FaultyValue<bool>>::allTPs(this->c17)) {
+		generated.emplace(testpoint->location(), dynamic_cast<CONTROL*>(testpoint)->value().magnitude());
+		delete testpoint;
+	}
+	std::set<std::pair<Connecting*, bool>> described;
+	for (TPCandidate candidate : candidates.candidates(TPCandidate::CONTROL)) {
+		TESTPOINT* testpoint = candidates.testpoint(candidate);
+		CONTROL* control = dynamic_cast<CONTROL*>(testpoint);
+		ASSERT_NE(nullptr, control);
+		EXPECT_EQ(candidates.location(candidate), testpoint->location());
+		described.emplace(testpoint->location(), control->value().magnitude());
+		delete testpoint;
+	}
+	EXPECT_EQ(generated, described);
+	EXPECT_EQ(candidates.size(), candidates.candidates(TPCandidate::OBSERVE).size());
+}
+
+//Only Lines which pass a filter have testpoints.
+TEST_F(TPCandidatesTest, FilterTest) {
+	typedef TPCandidates<COP_TPI_Node<FaultyValue<bool>>, COP_TPI_Line<FaultyValue<bool>>, FaultyValue<bool>> CANDIDATES;
+	CANDIDATES candidates(this->c17);
+	std::vector<TPCandidate> notPIs = candidates.candidates(TPCandidate::OBSERVE, CANDIDATES::notPI);
+	std::vector<TPCandidate> stems = candidates.candidates(TPCandidate::INVERT, CANDIDATES::stem);
+	EXPECT_LT(notPIs.size(), candidates.size());
+	for (TPCandidate candidate : notPIs) {
+		EXPECT_TRUE(CANDIDATES::notPI(candidates.location(candidate)));
+	}
+	EXPECT_NE(0, stems.size());
+	for (TPCandidate candidate : stems) {
+		EXPECT_EQ(TPCandidate::INVERT, candidate.kind);
+		EXPECT_LT(1, candidates.location(candidate)->outputSpan().size());
+	}
+	EXPECT_EQ(0, candidates.candidates(TPCandidate::OBSERVE, [](COP_TPI_Line<FaultyValue<bool>>*) { return false; }).size());
+}
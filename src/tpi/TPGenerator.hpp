@@ -37,7 +37,7 @@ public:
 	static std::set<Testpoint<_nodeType, _lineType, _valueType>*> allTPs(Circuit* _circuit) {
 		std::set<_TPType> toReturn;
 		for (Levelized* node : _circuit->nodes()) {
-			if (node->inputs().size() == 0)//no tp on PI
+			if (node->inputSpan().size() == 0)//no tp on PI
 			{
 				continue;
 			}
@@ -62,12 +62,12 @@ private:
 	 */
 	static std::set<_TPType> allTPs(_nodeType* _node) {
 		std::set<_TPType> toReturn;
-		for (Connecting* input : _node->inputs()) {
+		for (Connecting* input : _node->inputSpan()) {
 			_lineType* line = dynamic_cast<_lineType*>(input);
 			std::set<_TPType> toAdd = allTPs(line);
 			toReturn.insert(toAdd.begin(), toAdd.end());
 		}
-		for (Connecting* output : _node->outputs()) {
+		for (Connecting* output : _node->outputSpan()) {
 			_lineType* line = dynamic_cast<_lineType*>(output);
 			std::set<_TPType> toAdd = allTPs(line);
 			toReturn.insert(toAdd.begin(), toAdd.end());
@@ -3,6 +3,8 @@
 #include "tpi/TPI_C17.hpp"
 #include "tpi/TPI_C432.hpp"
 #include "tpi/TPI_Moghaddam_C17.hpp"
+#include "tpi/TPCandidates_Tests.hpp"
+#include "tpi/COP_power_calculator_Tests.hpp"
 
 //DELETE obsolete
 //#include "Testpoint_Invert_Test.hpp"
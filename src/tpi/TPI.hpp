@@ -14,10 +14,22 @@
 
 #include <utility> //pair
 #include <limits>
-#include <ctime>
+#include <vector>
+#include <queue>
+#include <functional>
+#include <algorithm>
+#include <numeric>
+#include <unordered_set>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 #include "tpi/Testpoint.hpp"
+#include "tpi/TPCandidates.hpp"
 #include "structures/Circuit.h"
+#include "timing/Timing.hpp"
+#include "timing/Counters.hpp"
+#include "timing/Trace.hpp"
 
  /*
   * An algroithm which implements iterative test point insertion (TPI).
@@ -53,6 +65,10 @@ public:
 		this->TPLimit_ = _TPLimit;
 		this->qualityLimit_ = _qualityLimit;
 		this->timeLimit_ = _timeLimit;
+		this->threads_ = 0;
+		this->lazy_ = false;
+		this->batch_ = 1;
+		this->overlap_ = 0.0;
 	}
 
 
@@ -74,6 +90,7 @@ public:
 	 *        attached set.
 	 * @param (optional) _limits The limit to the number of testpoints for each
 	 *        set. If no limits is given, no limit will be given to any set.
+	 * @return The selected testpoints.
 	 */
 	std::set<Testpoint<_nodeType, _lineType, _valueType>*> testpoints(
 		std::vector<std::set<Testpoint<_nodeType, _lineType, _valueType>*>> _testpoints,
@@ -91,6 +108,24 @@ public:
 		if (_limits.size() != _testpoints.size()) {
 			throw "Testpoint insertion limits to not match the number of testpoint sets.";
 		}
+		if (this->lazy_ || this->batch_ > 1) {
+			std::vector<Testpoint<_nodeType, _lineType, _valueType>*> candidates;
+			std::vector<size_t> sets;
+			for (size_t i = 0; i < _testpoints.size(); i++) {
+				candidates.insert(candidates.end(), _testpoints.at(i).begin(), _testpoints.at(i).end());
+				sets.resize(candidates.size(), i);
+			}
+			std::function<_lineType*(size_t)> location = [&](size_t _i) { return candidates.at(_i)->location(); };
+			std::function<float(size_t)> quality = [&](size_t _i) { return this->quality(candidates.at(_i), this->circuit_); };
+			std::function<Testpoint<_nodeType, _lineType, _valueType>*(size_t)> testpoint = [&](size_t _i) { return candidates.at(_i); };
+			if (this->lazy_) {
+				return this->lazyTestpoints(sets, _limits, location, quality, testpoint);
+			}
+			return this->batchTestpoints(sets, _limits, location, quality,
+				[&](size_t _i) { return this->impact(candidates.at(_i)); },
+				testpoint
+			);
+		}
 
 
 		while (
@@ -100,20 +135,25 @@ public:
 			_testpoints.at(0).size()>0
 
 			) {
+			TraceSpan roundSpan("TPI round", "tpi");
+			roundSpan.arg("round", curNumberTestpoints + 1);
 			float bestQuality = -10000;
-			Testpoint<_nodeType, _lineType, _valueType>* bestTestpoint;
+			Testpoint<_nodeType, _lineType, _valueType>* bestTestpoint = nullptr;
 			size_t bestSet = 0;
 			for (size_t i = 0; i < _testpoints.size(); i++) {
 				if (numInserted.at(i) >= _limits.at(i)) { //Skip: set limit reached.
 					continue;
 				}
 				std::pair<Testpoint<_nodeType, _lineType, _valueType>*, float> best = this->bestTestpoint(_testpoints.at(i), this->circuit_);
-				if (best.second > bestQuality) {
+				if (best.first != nullptr && best.second > bestQuality) { //Skip: no testpoint in the set.
 					bestQuality = best.second;
 					bestTestpoint = best.first;
 					bestSet = i;
 				}
 			}
+			if (bestTestpoint == nullptr) { //No testpoint can be chosen (all sets empty or at their limits).
+				break;
+			}
 			//if (bestQuality < 0) {//No more TPs to add: no positive quality.
 			//	break;
 			//}
@@ -132,8 +172,11 @@ public:
 				}
 			}*/
 			bestTestpoint->activate(this->circuit_);
+			this->inserted(bestTestpoint);
 			 //printf("TP Chosen - %d of %d\n", curNumberTestpoints, this->TPLimit_);
 			curNumberTestpoints = curNumberTestpoints + 1;
+			roundSpan.arg("quality", bestQuality);
+			roundSpan.arg("tps", curNumberTestpoints);
 
 		}
 		/*for (Testpoint<_nodeType, _lineType, _valueType>* testpoint : inserted) {
@@ -143,6 +186,100 @@ public:
 		return inserted;
 	};
 
+	/*
+	 * Evaluate the given set(s) of described testpoints and return those
+	 * selected to be inserted (see "testpoints" above).
+	 *
+	 * Testpoints are only created when they are chosen: while evaluated, each
+	 * testpoint only exists while its quality is calculated.
+	 *
+	 * @param _candidates The places testpoints are inserted.
+	 * @param _testpoints The testpoints to evaluate (see "testpoints" above).
+	 * @param (optional) _limits The limit to the number of testpoints for each
+	 *        set. If no limits is given, no limit will be given to any set.
+	 * @return The selected testpoints (new testpoints, which must be deleted
+	 *         elsewhere).
+	 */
+	std::set<Testpoint<_nodeType, _lineType, _valueType>*> testpoints(
+		const TPCandidates<_nodeType, _lineType, _valueType> & _candidates,
+		std::vector<std::vector<TPCandidate>> _testpoints,
+		std::vector<size_t> _limits = std::vector<size_t>()
+	) {
+		this->resetTimer();
+		if (_limits.size() == 0) {
+			_limits = std::vector<size_t>(_testpoints.size(), std::numeric_limits<size_t>::max());
+		}
+		if (_limits.size() != _testpoints.size()) {
+			throw "Testpoint insertion limits to not match the number of testpoint sets.";
+		}
+		if (this->lazy_ || this->batch_ > 1) {
+			std::vector<TPCandidate> candidates;
+			std::vector<size_t> sets;
+			for (size_t i = 0; i < _testpoints.size(); i++) {
+				candidates.insert(candidates.end(), _testpoints.at(i).begin(), _testpoints.at(i).end());
+				sets.resize(candidates.size(), i);
+			}
+			std::function<_lineType*(size_t)> location = [&](size_t _i) { return _candidates.location(candidates.at(_i)); };
+			std::function<float(size_t)> quality = [&](size_t _i) { return this->quality(_candidates, candidates.at(_i)); };
+			std::function<Testpoint<_nodeType, _lineType, _valueType>*(size_t)> testpoint = [&](size_t _i) { return _candidates.testpoint(candidates.at(_i)); };
+			if (this->lazy_) {
+				return this->lazyTestpoints(sets, _limits, location, quality, testpoint);
+			}
+			return this->batchTestpoints(sets, _limits, location, quality,
+				[&](size_t _i) { return this->impact(_candidates, candidates.at(_i)); },
+				testpoint
+			);
+		}
+
+		std::set<Testpoint<_nodeType, _lineType, _valueType>*> inserted;
+		std::vector<size_t> numInserted = std::vector<size_t>(_testpoints.size(), 0);
+		while (
+			this->timeUp() == false &&
+			inserted.size() < this->TPLimit_ &&
+			_testpoints.at(0).size() > 0
+			) {
+			TraceSpan roundSpan("TPI round", "tpi");
+			roundSpan.arg("round", inserted.size() + 1);
+			float bestQuality = -10000;
+			size_t bestSet = 0;
+			size_t bestTestpoint = 0;
+			for (size_t i = 0; i < _testpoints.size(); i++) {
+				if (numInserted.at(i) >= _limits.at(i)) { //Skip: set limit reached.
+					continue;
+				}
+				const std::vector<TPCandidate> & testpoints = _testpoints.at(i);
+				std::vector<float> qualities = this->evaluate(testpoints.size(),
+					[&](size_t _i) { return _candidates.location(testpoints.at(_i)); },
+					[&](size_t _i) { return this->quality(_candidates, testpoints.at(_i)); }
+				);
+				float setQuality = -10000; //The first best testpoint of the set (as "bestTestpoint").
+				for (size_t j = 0; j < qualities.size(); j++) {
+					if (qualities.at(j) > setQuality) {
+						setQuality = qualities.at(j);
+						if (setQuality > bestQuality) {
+							bestQuality = setQuality;
+							bestSet = i;
+							bestTestpoint = j;
+						}
+					}
+				}
+				this->base(setQuality);
+			}
+			if (bestQuality == -10000) { //No testpoint can be chosen (all set limits reached).
+				break;
+			}
+			Testpoint<_nodeType, _lineType, _valueType>* chosen = _candidates.testpoint(_testpoints.at(bestSet).at(bestTestpoint));
+			_testpoints.at(bestSet).erase(_testpoints.at(bestSet).begin() + bestTestpoint);
+			inserted.emplace(chosen);
+			numInserted.at(bestSet)++;
+			chosen->activate(this->circuit_);
+			this->inserted(chosen);
+			roundSpan.arg("quality", bestQuality);
+			roundSpan.arg("tps", inserted.size());
+		}
+		return inserted;
+	};
+
 	/*
 	 * Set the time limit (and reset the timer).
 	 *
@@ -153,6 +290,80 @@ public:
 		this->resetTimer();
 	};
 
+	/*
+	 * Set an outer deadline which TPI will honor along with its own time
+	 * limit (e.g., a time budget for an entire run).
+	 *
+	 * @param _deadline The outer deadline.
+	 */
+	void deadline(Deadline _deadline) {
+		this->outerDeadline_ = _deadline;
+		this->resetTimer();
+	};
+
+	/*
+	 * Set the number of threads which evaluate testpoints (if the TPI method
+	 * can evaluate testpoints concurrently, see "concurrency").
+	 *
+	 * By default (0), all available threads are used, unless TPI is itself
+	 * run in a parallel region (e.g., several TPI runs at once).
+	 *
+	 * @param _threads The number of threads.
+	 */
+	void threads(size_t _threads) {
+		this->threads_ = _threads;
+	};
+
+	/*
+	 * Select testpoints lazily (or re-evaluate all testpoints every round,
+	 * the default).
+	 *
+	 * When selecting lazily, every testpoint keeps the quality it had when it
+	 * was last evaluated. Every round, only the testpoint with the best
+	 * quality is re-evaluated, until a testpoint is still the best after it
+	 * is re-evaluated (it is chosen). This presumes the quality of a testpoint
+	 * does not increase when other testpoints are inserted, which is not
+	 * always true, so compare the testpoints (and their fault coverage) with
+	 * those selected otherwise.
+	 *
+	 * @param _lazy Select testpoints lazily.
+	 */
+	void lazy(bool _lazy) {
+		this->lazy_ = _lazy;
+	};
+
+	/*
+	 * Insert up to a number of testpoints every round (or one, the default).
+	 *
+	 * Every round, all testpoints are evaluated and the best ones are
+	 * inserted at once, best first, skipping testpoints which interfere with
+	 * those already taken this round: testpoints whose impact (see "impact")
+	 * overlaps the impact of those taken by more than a fraction of their
+	 * own. Only testpoints with a positive quality are taken after the first.
+	 *
+	 * The number of testpoints per round shrinks near the testpoint limit:
+	 * at most half of the testpoints which may still be inserted are
+	 * inserted in one round (so the last are inserted one at a time).
+	 *
+	 * This takes up to as many times fewer rounds (fewer if testpoints
+	 * interfere, e.g., in small circuits), but testpoints of a round are not
+	 * evaluated with each other, so compare the testpoints (and their fault
+	 * coverage) with those selected one at a time. Lazy selection (see
+	 * "lazy") always inserts one testpoint at a time.
+	 *
+	 * @param _batch The most testpoints to insert every round.
+	 * @param (optional) _overlap The largest fraction of the impact of a
+	 *        testpoint which may overlap those taken in the same round. By
+	 *        default, impacts must be disjoint.
+	 */
+	void batch(size_t _batch, float _overlap = 0.0) {
+		if (_batch == 0) {
+			throw "At least one testpoint must be inserted every round.";
+		}
+		this->batch_ = _batch;
+		this->overlap_ = _overlap;
+	};
+
 	/*
 	 * Set the testpoint limit.
 	 *
@@ -203,42 +414,397 @@ private:
 	 */
 	virtual float base(float _base) = 0;
 
+	/*
+	 * A testpoint was chosen (and activated).
+	 *
+	 * By default, nothing is done.
+	 *
+	 * @param _testpoint The chosen testpoint.
+	 */
+	virtual void inserted(Testpoint<_nodeType, _lineType, _valueType>* /*_testpoint*/) {
+	};
+
+	/*
+	 * Prepare to evaluate testpoints on a number of threads at once (until
+	 * called again).
+	 *
+	 * By default, testpoints are evaluated one at a time (evaluating a
+	 * testpoint may modify the circuit).
+	 *
+	 * @param _threads The number of threads available.
+	 * @return The number of threads which can be used.
+	 */
+	virtual size_t concurrency(size_t /*_threads*/) {
+		return 1;
+	};
+
+	/*
+	 * Return the objects a testpoint may affect (see "batch"): testpoints
+	 * interfere if their impacts overlap.
+	 *
+	 * By default, the fan-in and fan-out cones of the testpoint's location.
+	 *
+	 * @param _testpoint The testpoint.
+	 * @return The objects the testpoint may affect.
+	 */
+	virtual std::vector<Connecting*> impact(Testpoint<_nodeType, _lineType, _valueType>* _testpoint) {
+		std::vector<Connecting*> toReturn;
+		std::unordered_set<Connecting*> found;
+		for (bool forward : { true, false }) {
+			std::vector<Connecting*> stack = { _testpoint->location() };
+			while (stack.empty() == false) {
+				Connecting* object = stack.back();
+				stack.pop_back();
+				for (Connecting* next : forward ? object->outputSpan() : object->inputSpan()) {
+					if (found.insert(next).second) {
+						toReturn.push_back(next);
+						stack.push_back(next);
+					}
+				}
+			}
+		}
+		return toReturn;
+	};
+
 	/*
 	 * For a given set of testpoints, return the best testpoint and its quality.
 	 *
 	 * @param _testpoints The set of testpoints to evaluate.
 	 * @param _circuit The Circuit to insert testpoints into.
-	 * @return A pair: the best testpoint and its quality.
+	 * @return A pair: the best testpoint (nullptr if none) and its quality.
 	 */
 	std::pair<Testpoint<_nodeType, _lineType, _valueType>*, float> bestTestpoint(std::set<Testpoint<_nodeType, _lineType, _valueType>*> _testpoints, Circuit* _circuit) {
+		std::vector<Testpoint<_nodeType, _lineType, _valueType>*> candidates(_testpoints.begin(), _testpoints.end());
+		std::vector<float> qualities = this->evaluate(candidates.size(),
+			[&](size_t _i) { return candidates.at(_i)->location(); },
+			[&](size_t _i) { return this->quality(candidates.at(_i), _circuit); }
+		);
+
+		//The first best testpoint (in set order), as if evaluated one at a time.
 		float bestQuality = -10000;
-		Testpoint<_nodeType, _lineType, _valueType>* bestTestpoint;
-		size_t curTPNumber = 1;
-		for (Testpoint<_nodeType, _lineType, _valueType>* curTestpoint : _testpoints) {
-			if (curTestpoint->location() == nullptr)
-			{
-				throw"error";
+		Testpoint<_nodeType, _lineType, _valueType>* bestTestpoint = nullptr; //Stays nullptr if no testpoint is better than -10000.
+		for (size_t i = 0; i < candidates.size(); i++) {
+			if (qualities.at(i) > bestQuality) {
+				bestQuality = qualities.at(i);
+				bestTestpoint = candidates.at(i);
+			}
 		}
-			
+		this->base(bestQuality);
+		return std::pair<Testpoint<_nodeType, _lineType, _valueType>*, float>(bestTestpoint, bestQuality);
+	};
+
+	/*
+	 * Return the quality of a described testpoint.
+	 *
+	 * The testpoint only exists while its quality is calculated.
+	 *
+	 * @param _candidates The places testpoints are inserted.
+	 * @param _candidate The testpoint.
+	 * @return The quality of the testpoint.
+	 */
+	float quality(const TPCandidates<_nodeType, _lineType, _valueType> & _candidates, const TPCandidate & _candidate) {
+		return this->temporary<float>(_candidates, _candidate,
+			[&](Testpoint<_nodeType, _lineType, _valueType>* _testpoint) { return this->quality(_testpoint, this->circuit_); }
+		);
+	};
 
+	/*
+	 * Return the impact of a described testpoint (see "impact").
+	 *
+	 * @param _candidates The places testpoints are inserted.
+	 * @param _candidate The testpoint.
+	 * @return The objects the testpoint may affect.
+	 */
+	std::vector<Connecting*> impact(const TPCandidates<_nodeType, _lineType, _valueType> & _candidates, const TPCandidate & _candidate) {
+		return this->temporary<std::vector<Connecting*>>(_candidates, _candidate,
+			[&](Testpoint<_nodeType, _lineType, _valueType>* _testpoint) { return this->impact(_testpoint); }
+		);
+	};
 
-			float quality = this->quality(curTestpoint, _circuit);
-			if (quality > bestQuality) {
-				bestQuality = quality;
-				bestTestpoint = curTestpoint;
+	/*
+	 * Call a function with a described testpoint which only exists during the
+	 * call.
+	 *
+	 * @param _candidates The places testpoints are inserted.
+	 * @param _candidate The testpoint.
+	 * @param _function The function to call.
+	 * @return What the function returns.
+	 */
+	template <class _returnType>
+	_returnType temporary(
+		const TPCandidates<_nodeType, _lineType, _valueType> & _candidates,
+		const TPCandidate & _candidate,
+		const std::function<_returnType(Testpoint<_nodeType, _lineType, _valueType>*)> & _function
+	) {
+		switch (_candidate.kind) {
+		case TPCandidate::CONTROL: {
+			Testpoint_control<_nodeType, _lineType, _valueType> testpoint(_candidates.location(_candidate), _candidates.value(_candidate));
+			return _function(&testpoint);
+		}
+		case TPCandidate::OBSERVE: {
+			Testpoint_observe<_nodeType, _lineType, _valueType> testpoint(_candidates.location(_candidate));
+			return _function(&testpoint);
+		}
+		default: {
+			Testpoint_invert<_nodeType, _lineType, _valueType> testpoint(_candidates.location(_candidate));
+			return _function(&testpoint);
+		}
+		}
+	};
+
+	/*
+	 * Return the quality of a number of testpoints (evaluated at once, if
+	 * possible, see "concurrency").
+	 *
+	 * @param _size The number of testpoints.
+	 * @param _location The location of a testpoint (by index).
+	 * @param _quality The quality of a testpoint (by index).
+	 * @return The quality of every testpoint (by index).
+	 */
+	std::vector<float> evaluate(size_t _size, const std::function<_lineType*(size_t)> & _location, const std::function<float(size_t)> & _quality) {
+		for (size_t i = 0; i < _size; i++) {
+			if (_location(i) == nullptr) {
+				throw "error";
 			}
-			//printf("Done analyzing TP %d of %d\n", curTPNumber, _testpoints.size());//DEBUG
-			curTPNumber++;
 		}
-		this->base(bestQuality);
-		return std::pair<Testpoint<_nodeType, _lineType, _valueType>*, float>(bestTestpoint, bestQuality);
+		int numThreads = 1;
+#ifdef _OPENMP
+		if (this->threads_ != 0) {
+			numThreads = (int)this->threads_;
+		} else if (omp_in_parallel() == false) {
+			numThreads = omp_get_max_threads();
+		}
+#endif
+		if ((size_t)numThreads > _size) {
+			numThreads = _size == 0 ? 1 : (int)_size;
+		}
+		numThreads = (int)this->concurrency((size_t)numThreads);
+		std::vector<float> qualities(_size);
+		const char* error = nullptr;
+		#pragma omp parallel for schedule(dynamic, 16) num_threads(numThreads) if(numThreads > 1)
+		for (long long i = 0; i < (long long)_size; i++) {
+			COUNT(TPI_CANDIDATES);
+			TraceSpan candidateSpan("TP candidate", "tpi");
+			if (candidateSpan.active()) {
+				candidateSpan.arg("location", _location(i)->name());
+			}
+			try {
+				qualities.at(i) = _quality(i);
+			} catch (const char* e) {
+				#pragma omp critical
+				error = e;
+			}
+			candidateSpan.arg("quality", qualities.at(i));
+		}
+		this->concurrency(1);
+		if (error != nullptr) {
+			throw error;
+		}
+		return qualities;
+	};
+
+	/*
+	 * Select testpoints lazily (see "lazy" and "testpoints").
+	 *
+	 * All testpoints are evaluated once (at once, if possible). Afterwards,
+	 * testpoints are re-evaluated one at a time, best first, until the best
+	 * testpoint was evaluated in the current round. Ties are given to the
+	 * first testpoint (by index).
+	 *
+	 * The quality of every testpoint is relative to the circuit with all
+	 * chosen testpoints: the base quality is recalculated after every
+	 * chosen testpoint. Only one testpoint is inserted on each Line (e.g.,
+	 * not both control testpoints), so chosen testpoints can be deactivated
+	 * in any order.
+	 *
+	 * @param _sets The set of every testpoint (by index).
+	 * @param _limits The limit to the number of testpoints for each set.
+	 * @param _location The location of a testpoint (by index).
+	 * @param _quality The quality of a testpoint (by index).
+	 * @param _testpoint A chosen testpoint (by index).
+	 * @return The selected testpoints.
+	 */
+	std::set<Testpoint<_nodeType, _lineType, _valueType>*> lazyTestpoints(
+		const std::vector<size_t> & _sets,
+		const std::vector<size_t> & _limits,
+		const std::function<_lineType*(size_t)> & _location,
+		const std::function<float(size_t)> & _quality,
+		const std::function<Testpoint<_nodeType, _lineType, _valueType>*(size_t)> & _testpoint
+	) {
+		//A testpoint (by index), the quality it had when it was last evaluated and when.
+		struct Candidate {
+			float quality;
+			size_t round;
+			size_t index;
+		};
+		auto worse = [](const Candidate & _a, const Candidate & _b) {
+			if (_a.quality != _b.quality) {
+				return _a.quality < _b.quality;
+			}
+			return _a.index > _b.index;
+		};
+		std::priority_queue<Candidate, std::vector<Candidate>, decltype(worse)> heap(worse);
+
+		std::vector<size_t> indices; //Skip sets whose limit is reached.
+		for (size_t i = 0; i < _sets.size(); i++) {
+			if (_limits.at(_sets.at(i)) != 0) {
+				indices.push_back(i);
+			}
+		}
+		size_t round = 1;
+		{
+			TraceSpan evaluateSpan("TPI lazy evaluation", "tpi");
+			std::vector<float> qualities = this->evaluate(indices.size(),
+				[&](size_t _i) { return _location(indices.at(_i)); },
+				[&](size_t _i) { return _quality(indices.at(_i)); }
+			);
+			for (size_t i = 0; i < indices.size(); i++) {
+				heap.push(Candidate{ qualities.at(i), round, indices.at(i) });
+			}
+		}
+
+		std::set<Testpoint<_nodeType, _lineType, _valueType>*> inserted;
+		std::vector<size_t> numInserted = std::vector<size_t>(_limits.size(), 0);
+		std::unordered_set<_lineType*> locations; //Of all chosen testpoints: only one testpoint is inserted on each Line.
+		while (this->timeUp() == false && inserted.size() < this->TPLimit_ && heap.empty() == false) {
+			TraceSpan roundSpan("TPI round", "tpi");
+			roundSpan.arg("round", round);
+			bool found = false;
+			Candidate best;
+			while (heap.empty() == false) {
+				Candidate top = heap.top();
+				heap.pop();
+				if (numInserted.at(_sets.at(top.index)) >= _limits.at(_sets.at(top.index))) { //Drop: set limit reached.
+					continue;
+				}
+				if (locations.count(_location(top.index)) != 0) { //Drop: a testpoint was chosen on this Line.
+					continue;
+				}
+				if (top.round == round) {
+					best = top;
+					found = true;
+					break;
+				}
+				COUNT(TPI_CANDIDATES);
+				top.quality = _quality(top.index);
+				top.round = round;
+				heap.push(top);
+			}
+			if (found == false) {
+				break;
+			}
+			Testpoint<_nodeType, _lineType, _valueType>* chosen = _testpoint(best.index);
+			inserted.emplace(chosen);
+			numInserted.at(_sets.at(best.index))++;
+			locations.insert(_location(best.index));
+			chosen->activate(this->circuit_);
+			this->inserted(chosen);
+			this->base(-1); //Not calculated: qualities are relative to the circuit with all chosen testpoints.
+			round++;
+			roundSpan.arg("quality", best.quality);
+			roundSpan.arg("tps", inserted.size());
+		}
+		return inserted;
+	};
+
+	/*
+	 * Insert several testpoints every round (see "batch" and "testpoints").
+	 *
+	 * Every round, all remaining testpoints are evaluated (at once, if
+	 * possible) relative to the circuit with all chosen testpoints. Then, the
+	 * best testpoints are taken in order of quality (ties to the first by
+	 * index) until enough are taken or sixteen times as many were considered.
+	 * Only one testpoint is inserted on each Line (e.g., not both control
+	 * testpoints), so chosen testpoints can be deactivated in any order.
+	 *
+	 * @param _sets The set of every testpoint (by index).
+	 * @param _limits The limit to the number of testpoints for each set.
+	 * @param _location The location of a testpoint (by index).
+	 * @param _quality The quality of a testpoint (by index).
+	 * @param _impact The impact of a testpoint (by index, see "impact").
+	 * @param _testpoint A chosen testpoint (by index).
+	 * @return The selected testpoints.
+	 */
+	std::set<Testpoint<_nodeType, _lineType, _valueType>*> batchTestpoints(
+		const std::vector<size_t> & _sets,
+		const std::vector<size_t> & _limits,
+		const std::function<_lineType*(size_t)> & _location,
+		const std::function<float(size_t)> & _quality,
+		const std::function<std::vector<Connecting*>(size_t)> & _impact,
+		const std::function<Testpoint<_nodeType, _lineType, _valueType>*(size_t)> & _testpoint
+	) {
+		std::set<Testpoint<_nodeType, _lineType, _valueType>*> inserted;
+		std::vector<size_t> numInserted = std::vector<size_t>(_limits.size(), 0);
+		std::unordered_set<_lineType*> locations; //Of all chosen testpoints: only one testpoint is inserted on each Line.
+		size_t round = 1;
+		while (this->timeUp() == false && inserted.size() < this->TPLimit_) {
+			TraceSpan roundSpan("TPI round", "tpi");
+			roundSpan.arg("round", round);
+			std::vector<size_t> indices; //Skip chosen locations and sets whose limit is reached.
+			for (size_t i = 0; i < _sets.size(); i++) {
+				if (numInserted.at(_sets.at(i)) < _limits.at(_sets.at(i)) && locations.count(_location(i)) == 0) {
+					indices.push_back(i);
+				}
+			}
+			if (indices.size() == 0) {
+				break;
+			}
+			this->base(-1); //Not calculated: qualities are relative to the circuit with all chosen testpoints.
+			std::vector<float> qualities = this->evaluate(indices.size(),
+				[&](size_t _i) { return _location(indices.at(_i)); },
+				[&](size_t _i) { return _quality(indices.at(_i)); }
+			);
+			std::vector<size_t> order(indices.size());
+			std::iota(order.begin(), order.end(), 0);
+			std::stable_sort(order.begin(), order.end(), [&](size_t _a, size_t _b) { return qualities.at(_a) > qualities.at(_b); });
+
+			size_t size = std::min(this->batch_, std::max((this->TPLimit_ - inserted.size()) / 2, (size_t)1));
+			std::vector<size_t> taken;
+			std::unordered_set<Connecting*> claimed; //The impact of all testpoints taken.
+			for (size_t i = 0; i < order.size() && taken.size() < size && i < 16 * size; i++) {
+				size_t index = indices.at(order.at(i));
+				size_t set = _sets.at(index);
+				if (taken.size() > 0 && qualities.at(order.at(i)) <= 0) {
+					break;
+				}
+				if (numInserted.at(set) >= _limits.at(set)) { //Skip: set limit reached (this round).
+					continue;
+				}
+				if (size > 1) {
+					std::vector<Connecting*> impact = _impact(index);
+					impact.push_back(_location(index));
+					size_t overlap = 0;
+					for (Connecting* object : impact) {
+						overlap += claimed.count(object);
+					}
+					if (overlap > this->overlap_ * impact.size()) { //Skip: interferes with a testpoint taken.
+						continue;
+					}
+					claimed.insert(impact.begin(), impact.end());
+				}
+				taken.push_back(index);
+				numInserted.at(set)++;
+			}
+			for (size_t index : taken) {
+				Testpoint<_nodeType, _lineType, _valueType>* testpoint = _testpoint(index);
+				locations.insert(_location(index));
+				inserted.emplace(testpoint);
+				testpoint->activate(this->circuit_);
+				this->inserted(testpoint);
+			}
+			round++;
+			roundSpan.arg("quality", qualities.at(order.front()));
+			roundSpan.arg("batch", taken.size());
+			roundSpan.arg("tps", inserted.size());
+		}
+		return inserted;
 	};
 
 	/*
 	 * Reset the timer.
 	 */
 	void resetTimer() {
-		this->endTime_ = std::clock() + (this->timeLimit_ * CLOCKS_PER_SEC);
+		this->deadline_ = Deadline((double)this->timeLimit_).earliest(this->outerDeadline_);
 	};
 
 	/*
@@ -247,7 +813,7 @@ private:
 	 * @return True if time is up.
 	 */
 	bool timeUp() {
-		return clock() > this->endTime_;
+		return this->deadline_.expired();
 	};
 
 
@@ -267,9 +833,31 @@ private:
 	size_t timeLimit_;
 
 	/*
-	 * The end of the timer (in "tick time")
+	 * The number of threads which evaluate testpoints (0: all available).
+	 */
+	size_t threads_;
+
+	/*
+	 * Are testpoints selected lazily?
+	 */
+	bool lazy_;
+
+	/*
+	 * The most testpoints inserted every round and the largest fraction of
+	 * their impact which may overlap (see "batch").
+	 */
+	size_t batch_;
+	float overlap_;
+
+	/*
+	 * When the current TPI run must stop.
+	 */
+	Deadline deadline_;
+
+	/*
+	 * An outer deadline to honor (by default, never).
 	 */
-	std::clock_t endTime_;
+	Deadline outerDeadline_;
 
 	/*std::string tpName(Testpoint<_primitive, _nodeType, _lineType>* _tp) {
 		std::string type;
@@ -17,6 +17,7 @@
 #include "COP_TPI_Structures.hpp"
 #include "tpi/TPGenerator.hpp"
 #include "tpi/TPI_COP.hpp"
+#include "tpi/tpi_power.hpp"
 #include "tpi/Testpoint_control.hpp"
 #include "tpi/Testpoint_invert.hpp"
 #include "tpi/Testpoint_observe.hpp"
@@ -47,11 +48,60 @@ public:
 		}
 	}
 
-	
+	/*
+	 * The best quality of all testpoints, each evaluated one at a time.
+	 *
+	 * @param _testpoints The sets of testpoints to evaluate.
+	 * @return The best quality.
+	 */
+	float bestQuality(std::vector<std::set<TP*>> _testpoints) {
+		float toReturn = -1;
+		for (std::set<TP*> testpoints : _testpoints) {
+			for (TP* testpoint : testpoints) {
+				toReturn = std::max(toReturn, tpi.quality(testpoint, c17));
+			}
+		}
+		return toReturn;
+	}
+
+	/*
+	 * The Lines of c17 (before any testpoint is activated).
+	 *
+	 * @return The Lines.
+	 */
+	std::vector<Connecting*> lines() {
+		BatchCOP<VALUE> cop;
+		cop.build(c17);
+		std::vector<Connecting*> toReturn;
+		for (size_t i = 0; i < cop.size(); i++) {
+			if (cop.line(i)) {
+				toReturn.push_back(dynamic_cast<Connecting*>(cop.object(i)));
+			}
+		}
+		return toReturn;
+	}
+
+	/*
+	 * The power metric of the given Lines, calculated from scratch (with all
+	 * activated testpoints).
+	 *
+	 * @param _lines The Lines to measure (see "lines").
+	 * @return The power metric.
+	 */
+	float power(std::vector<Connecting*> _lines) {
+		BatchCOP<VALUE> cop;
+		cop.build(c17);
+		cop.calculate();
+		double toReturn = 0.0;
+		for (Connecting* line : _lines) {
+			toReturn += std::fabs(cop.controllability(cop.id(line)) - 0.5f);
+		}
+		return (float)toReturn;
+	}
 
 	Parser<LINETYPE, NODETYPE, VALUE> parser;
 	Circuit* c17 = parser.Parse("c17.bench");
-	TPI_COP<NODETYPE, LINETYPE, VALUE> tpi = TPI_COP<NODETYPE, LINETYPE, VALUE>(c17);
+	TPI_COP<NODETYPE, LINETYPE, VALUE> tpi = TPI_COP<NODETYPE, LINETYPE, VALUE>(c17, 1);
 	TPGenerator<TPCONTROL, NODETYPE, LINETYPE, VALUE> controlGen;
 	TPGenerator<TPOBSERVE, NODETYPE, LINETYPE, VALUE> observeGen;
 	TPGenerator<TPINVERT, NODETYPE, LINETYPE, VALUE> invertGen;
@@ -359,4 +409,92 @@ TEST_F(C17Tests, C17ExhaustiveControlFaultCoverage) {
 		std::vector<VALUE> clearVector = std::vector<VALUE>({x, x, x, x, x});
 		faultSimulator.applyStimulus(c17, clearVector, EventQueue<VALUE>(), pisOrdered);
 	}
-}
\ No newline at end of file
+}
+
+//Testpoints evaluated without modifying the circuit have the same quality as activated testpoints.
+TEST_F(C17Tests, C17VirtualQuality) {
+	TPI_COP<NODETYPE, LINETYPE, VALUE> activating = TPI_COP<NODETYPE, LINETYPE, VALUE>(c17, 1);
+	activating.virtualTestpoints(false);
+	for (std::set<TP*> testpoints : { controlTPs, observeTPs, invertTPs }) {
+		for (TP* testpoint : testpoints) {
+			EXPECT_NEAR(activating.quality(testpoint, c17), tpi.quality(testpoint, c17), 0.00001);
+		}
+	}
+}
+
+//The power quality of a testpoint is the change in power of activating it, and chosen testpoints are kept.
+TEST_F(C17Tests, C17PowerQuality) {
+	std::vector<Connecting*> lines = this->lines();
+	float base = this->power(lines);
+	TPI_POWER<NODETYPE, LINETYPE, VALUE> power = TPI_POWER<NODETYPE, LINETYPE, VALUE>(c17);
+	EXPECT_NEAR(base, power.power(), 0.00001);
+	for (std::set<TP*> testpoints : { controlTPs, observeTPs, invertTPs }) {
+		for (TP* testpoint : testpoints) {
+			float quality = power.quality(testpoint, c17);
+			testpoint->activate(c17);
+			EXPECT_NEAR(this->power(lines) - base, quality, 0.00001);
+			testpoint->deactivate(c17);
+		}
+	}
+
+	power.testpointLimit(2);
+	std::set<TP*> chosen = power.testpoints({ controlTPs, invertTPs });
+	EXPECT_EQ(2, chosen.size());
+	EXPECT_NEAR(this->power(lines), power.power(), 0.00001);
+	for (TP* testpoint : chosen) {
+		testpoint->deactivate(c17);
+	}
+}
+
+//Testpoints evaluated on several threads are chosen as if evaluated one at a time.
+TEST_F(C17Tests, C17ConcurrentTestpoints) {
+	std::vector<std::set<TP*>> all_tps = { controlTPs, observeTPs };
+	std::set<TP*> chosen;
+	for (size_t threads : { 1, 4 }) {
+		TPI_COP<NODETYPE, LINETYPE, VALUE> concurrent = TPI_COP<NODETYPE, LINETYPE, VALUE>(c17, 1);
+		concurrent.threads(threads);
+		concurrent.testpointLimit(3);
+		std::set<TP*> found = concurrent.testpoints(all_tps);
+		for (TP* testpoint : found) {
+			testpoint->deactivate(c17);
+		}
+		if (threads != 1) {
+			EXPECT_EQ(chosen, found);
+		}
+		chosen = found;
+	}
+}
+
+//The first testpoint selected lazily is the best of all testpoints.
+TEST_F(C17Tests, C17LazyTestpoints) {
+	std::vector<std::set<TP*>> all_tps = { controlTPs, observeTPs };
+	float bestQuality = this->bestQuality(all_tps);
+	TPI_COP<NODETYPE, LINETYPE, VALUE> lazy = TPI_COP<NODETYPE, LINETYPE, VALUE>(c17, 1);
+	lazy.lazy(true);
+	lazy.testpointLimit(1);
+	std::set<TP*> chosen = lazy.testpoints(all_tps);
+	ASSERT_EQ(1, chosen.size());
+	TP* testpoint = *chosen.begin();
+	testpoint->deactivate(c17);
+	EXPECT_EQ(bestQuality, tpi.quality(testpoint, c17));
+}
+
+//Testpoints inserted several per round include the best testpoint of all.
+TEST_F(C17Tests, C17BatchTestpoints) {
+	std::vector<std::set<TP*>> all_tps = { controlTPs, observeTPs };
+	float bestQuality = this->bestQuality(all_tps);
+	TPI_COP<NODETYPE, LINETYPE, VALUE> batch = TPI_COP<NODETYPE, LINETYPE, VALUE>(c17, 1);
+	batch.batch(4);
+	batch.testpointLimit(8);
+	std::set<TP*> chosen = batch.testpoints(all_tps);
+	EXPECT_LT(0, chosen.size());
+	EXPECT_GE(8, chosen.size());
+	for (TP* testpoint : chosen) {
+		testpoint->deactivate(c17);
+	}
+	float chosenQuality = -1; //The best testpoint is chosen (first).
+	for (TP* testpoint : chosen) {
+		chosenQuality = std::max(chosenQuality, tpi.quality(testpoint, c17));
+	}
+	EXPECT_EQ(bestQuality, chosenQuality);
+}
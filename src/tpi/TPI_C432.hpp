@@ -68,7 +68,7 @@ public:
 
 	Circuit* originalCircuit = parser.Parse("c432.bench");
 	Circuit* modifiedCircuit = parser.Parse("c432.bench");
-	TPI_COP<NODETYPE, LINETYPE, VALUE> tpi = TPI_COP<NODETYPE, LINETYPE, VALUE>(modifiedCircuit);
+	TPI_COP<NODETYPE, LINETYPE, VALUE> tpi = TPI_COP<NODETYPE, LINETYPE, VALUE>(modifiedCircuit, 1);
 	TPGenerator<TPOBSERVE, NODETYPE, LINETYPE, VALUE> observeGen;
 	std::set<TP*> observeTPs;
 	std::vector<std::set<TP*>> all_tps;
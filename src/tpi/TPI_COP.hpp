@@ -14,6 +14,10 @@
 
 #include "tpi/TPI.hpp"
 #include "tpi/COP_fault_calculator.hpp"
+#include "tpi/COP_power_calculator.hpp"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 /*
  * COP-based TPI.
@@ -28,6 +32,18 @@
  * test point selection for scan-based BIST. Proc. of 34th Design Automation 
  * Conference, pages 478-483,1997.
  *
+ * By default, testpoints are evaluated without modifying the circuit: they are
+ * added to COP values of the whole circuit which are updated incrementally
+ * (see IncrementalCOP) and then rolled back. Only chosen testpoints are
+ * activated (see "testpoints"), so the circuit must not be modified otherwise
+ * while testpoints are evaluated this way. Since the circuit is not modified,
+ * testpoints are evaluated concurrently, each thread using its own copy of the
+ * COP values.
+ *
+ * The power metric of TPI_POWER can be added to the quality of testpoints as
+ * a secondary objective (see "power"). It is measured on the same COP values,
+ * so it costs little more than coverage alone.
+ *
  * NOTE: There is no "_primitive" parameter since COP can only be performed on 
  *       Boolean circuits.
  * @param _nodeType The type of nodes used in the circuit to be modified.
@@ -74,6 +90,11 @@ public:
 		) 
 	{
 		this->baseFaultCoverage_ = -1;
+		this->stored_ = false;
+		this->coverage_ = -1;
+		this->virtual_ = true;
+		this->concurrent_ = 1;
+		this->powerWeight_ = 0;
 	};
 
 	/*
@@ -87,13 +108,55 @@ public:
 	 */
 	float quality(Testpoint< _nodeType, _lineType, _valueType>* _testpoint, Circuit* _circuit) {
 		float base = this->base();
+		if (this->virtual_) {
+			IncrementalCOP<_valueType> & cop = this->threadCOP();
+			size_t checkpoint = cop.checkpoint();
+			_testpoint->apply(cop);
+			cop.update();
+			float TPCoverage = this->FaultCoverageCalculator_.faultCoverage(cop, checkpoint);
+			float TPPower = this->powerQuality(cop, checkpoint);
+			cop.rollback(checkpoint);
+			return TPCoverage - base + TPPower;
+		}
 		_testpoint->activate(_circuit);
 		float TPCoverage = this->FaultCoverageCalculator_.faultCoverage();
 		float toReturn = TPCoverage - base;
 		_testpoint->deactivate(_circuit);
+		if (this->powerWeight_ != 0) {
+			IncrementalCOP<_valueType> & cop = this->threadCOP();
+			size_t checkpoint = cop.checkpoint();
+			_testpoint->apply(cop);
+			cop.update();
+			toReturn += this->powerQuality(cop, checkpoint);
+			cop.rollback(checkpoint);
+		}
  		return toReturn;
 	};
 
+	/*
+	 * Evaluate testpoints without modifying the circuit (the default) or by
+	 * activating them.
+	 *
+	 * @param _virtual Evaluate testpoints without modifying the circuit.
+	 */
+	void virtualTestpoints(bool _virtual) {
+		this->virtual_ = _virtual;
+	}
+
+	/*
+	 * Also prefer testpoints which improve the power metric (see TPI_POWER).
+	 *
+	 * The quality of a testpoint becomes its change in fault coverage plus
+	 * the weighted change in the power metric per Line (the average change in
+	 * how far each Line's controllability is from 0.5).
+	 *
+	 * @param _weight The weight of the power metric. By default, 0 (fault
+	 *        coverage only).
+	 */
+	void power(float _weight) {
+		this->powerWeight_ = _weight;
+	}
+
 	/*
 	 * Clear the calculator's list of faults (will NOT delete).
 	 *
@@ -109,11 +172,42 @@ private:
 	 */
 	float baseFaultCoverage_;
 
+	/*
+	 * Have the COP values of all objects been calculated (at once) and stored?
+	 */
+	bool stored_;
+
+	/*
+	 * COP values of the whole circuit (with all chosen testpoints) and their
+	 * fault coverage.
+	 */
+	IncrementalCOP<_valueType> cop_;
+	float coverage_;
+
+	/*
+	 * Copies of the COP values for other threads and the number of threads
+	 * evaluating testpoints at once (see "concurrency").
+	 */
+	std::vector<IncrementalCOP<_valueType>> copies_;
+	size_t concurrent_;
+
+	/*
+	 * Are testpoints evaluated without modifying the circuit?
+	 */
+	bool virtual_;
+
 	/*
 	 * The calculator used for calculating fault coverage.
 	 */
 	COP_fault_calculator<_valueType> FaultCoverageCalculator_;
 
+	/*
+	 * The calculator used for calculating the power metric and its weight (see
+	 * "power").
+	 */
+	COP_power_calculator<_valueType> PowerCalculator_;
+	float powerWeight_;
+
 	/*
 	 * Return the "base" quality (no extra TP fault coverage) to compare other
 	 * testpoints against.
@@ -126,7 +220,16 @@ private:
 	 */
 	virtual float base() {
 		if (this->baseFaultCoverage_ < 0) {
-			this->baseFaultCoverage_ = this->FaultCoverageCalculator_.faultCoverage();
+			if (this->stored_ == false) { //Calculate all COP values without recursion (changes will clear what they affect).
+				this->cop_.build(this->circuit_);
+				this->cop_.calculate();
+				this->cop_.store();
+				this->FaultCoverageCalculator_.index(this->cop_);
+				this->PowerCalculator_.index(this->cop_);
+				this->coverage_ = this->FaultCoverageCalculator_.faultCoverage(this->cop_, this->cop_.checkpoint());
+				this->stored_ = true;
+			}
+			this->baseFaultCoverage_ = this->virtual_ ? this->coverage_ : this->FaultCoverageCalculator_.faultCoverage();
 		}
 		return this->baseFaultCoverage_;
 	};
@@ -144,6 +247,104 @@ private:
 		return this->baseFaultCoverage_;
 	};
 
+	/*
+	 * A testpoint was chosen (and activated): add it to the COP values of the
+	 * whole circuit for good.
+	 *
+	 * @param _testpoint The chosen testpoint.
+	 */
+	virtual void inserted(Testpoint<_nodeType, _lineType, _valueType>* _testpoint) {
+		if (this->stored_ == false) {
+			return;
+		}
+		size_t checkpoint = this->cop_.checkpoint();
+		_testpoint->apply(this->cop_);
+		this->cop_.update();
+		this->FaultCoverageCalculator_.accumulate(this->cop_, checkpoint);
+		this->PowerCalculator_.accumulate(this->cop_, checkpoint);
+		this->cop_.commit();
+		for (IncrementalCOP<_valueType> & copy : this->copies_) {
+			_testpoint->apply(copy);
+			copy.update();
+			copy.commit();
+		}
+		this->coverage_ = this->FaultCoverageCalculator_.faultCoverage(this->cop_, this->cop_.checkpoint());
+	};
+
+	/*
+	 * Prepare to evaluate testpoints on a number of threads at once.
+	 *
+	 * Testpoints can only be evaluated concurrently if they are evaluated
+	 * without modifying the circuit. Every thread (after the first) is given
+	 * its own copy of the COP values.
+	 *
+	 * @param _threads The number of threads available.
+	 * @return The number of threads which can be used.
+	 */
+	virtual size_t concurrency(size_t _threads) {
+		if (this->virtual_ == false || _threads <= 1) {
+			this->concurrent_ = 1;
+			return this->concurrent_;
+		}
+		this->base(); //The COP values must be calculated before they are copied.
+		while (this->copies_.size() + 1 < _threads) {
+			this->copies_.push_back(this->cop_);
+		}
+		this->concurrent_ = _threads;
+		return this->concurrent_;
+	};
+
+	/*
+	 * Return the objects a testpoint affects: those whose COP values it
+	 * changes (see "batch").
+	 *
+	 * @param _testpoint The testpoint.
+	 * @return The objects the testpoint affects.
+	 */
+	virtual std::vector<Connecting*> impact(Testpoint<_nodeType, _lineType, _valueType>* _testpoint) {
+		this->base(); //The COP values must be calculated.
+		size_t checkpoint = this->cop_.checkpoint();
+		_testpoint->apply(this->cop_);
+		this->cop_.update();
+		std::vector<Connecting*> toReturn;
+		for (const typename IncrementalCOP<_valueType>::Change & change : this->cop_.changes(checkpoint)) {
+			toReturn.push_back(this->cop_.object(change.id));
+		}
+		this->cop_.rollback(checkpoint);
+		return toReturn;
+	};
+
+	/*
+	 * The weighted change in the power metric per Line (see "power") of COP
+	 * values changed since a checkpoint.
+	 *
+	 * @param _cop The COP values.
+	 * @param _checkpoint The checkpoint of the COP values of the whole circuit.
+	 * @return The weighted change in the power metric.
+	 */
+	float powerQuality(IncrementalCOP<_valueType> & _cop, size_t _checkpoint) const {
+		if (this->powerWeight_ == 0 || this->PowerCalculator_.lines() == 0) {
+			return 0;
+		}
+		float change = this->PowerCalculator_.power(_cop, _checkpoint) - this->PowerCalculator_.power();
+		return this->powerWeight_ * change / this->PowerCalculator_.lines();
+	};
+
+	/*
+	 * The COP values used by the calling thread.
+	 *
+	 * @return The COP values.
+	 */
+	IncrementalCOP<_valueType> & threadCOP() {
+		size_t thread = 0;
+#ifdef _OPENMP
+		if (this->concurrent_ > 1) {
+			thread = (size_t)omp_get_thread_num();
+		}
+#endif
+		return thread == 0 ? this->cop_ : this->copies_.at(thread - 1);
+	};
+
 
 	
 };
@@ -22,6 +22,7 @@
 #include "tpi/Testpoint_observe.hpp"
 #include "faults/FaultSimulator.hpp"
 #include "tpi/Moghaddam_Structures.hpp"
+#include "tpi/BatchMoghaddam.hpp"
 
 #define PRIMITIVE FaultyValue<bool>
 #define LINETYPE Moghaddam_Line<PRIMITIVE>
@@ -196,4 +197,59 @@ TEST_F(C17_Moghaddam_Tests, C17_Moghaddam_Values) {
 			EvalLine(line);
 		}		
 	}
-}
\ No newline at end of file
+}
+
+//The batch calculation has the same values as Moghaddam objects.
+TEST_F(C17_Moghaddam_Tests, C17_Moghaddam_Batch) {
+	BatchCOP<PRIMITIVE> cop(c17);
+	BatchMoghaddam<PRIMITIVE> moghaddam;
+	moghaddam.index(cop);
+	for (size_t i = 0; i < cop.size(); i++) {
+		LINETYPE* line = dynamic_cast<LINETYPE*>(cop.object(i));
+		if (line == nullptr) {
+			continue;
+		}
+		EXPECT_NEAR(line->D(), moghaddam.D(i), 0.0001);
+		EXPECT_NEAR(line->B(false), moghaddam.B(i, false), 0.0001);
+		EXPECT_NEAR(line->B(true), moghaddam.B(i, true), 0.0001);
+	}
+}
+
+//Incremental updates calculate the same values as calculating everything, and
+//rolling back restores all values.
+TEST_F(C17_Moghaddam_Tests, C17_Moghaddam_Incremental) {
+	IncrementalCOP<PRIMITIVE> cop(c17);
+	BatchMoghaddam<PRIMITIVE> moghaddam;
+	moghaddam.index(cop);
+	BatchMoghaddam<PRIMITIVE> original = moghaddam;
+	for (size_t i = 0; i < cop.size(); i++) {
+		if (cop.line(i) == false) {
+			continue;
+		}
+		for (int testpoint = 0; testpoint < 3; testpoint++) {
+			size_t checkpoint = cop.checkpoint();
+			size_t moghaddamCheckpoint = moghaddam.checkpoint();
+			if (testpoint == 2) {
+				cop.observe(i);
+			} else {
+				cop.control(i, testpoint == 1);
+			}
+			cop.update();
+			moghaddam.update(cop, checkpoint);
+			BatchMoghaddam<PRIMITIVE> other;
+			other.index(cop);
+			for (size_t j = 0; j < cop.size(); j++) {
+				EXPECT_NEAR(other.D(j), moghaddam.D(j), 0.0001);
+				EXPECT_NEAR(other.B(j, false), moghaddam.B(j, false), 0.0001);
+				EXPECT_NEAR(other.B(j, true), moghaddam.B(j, true), 0.0001);
+			}
+			moghaddam.rollback(moghaddamCheckpoint);
+			cop.rollback(checkpoint);
+			for (size_t j = 0; j < cop.size(); j++) {
+				EXPECT_EQ(original.D(j), moghaddam.D(j));
+				EXPECT_EQ(original.B(j, false), moghaddam.B(j, false));
+				EXPECT_EQ(original.B(j, true), moghaddam.B(j, true));
+			}
+		}
+	}
+}
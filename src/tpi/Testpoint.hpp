@@ -15,6 +15,7 @@
 #include "structures/Circuit.h"
 #include "faults/FaultStructures.hpp"
 #include "simulation/Value.hpp"
+#include "cop/IncrementalCOP.hpp"
 
 
 /*
@@ -77,6 +78,16 @@ public:
 		return (this->location_ < _other.location());
 	}
 
+	/*
+	 * Create an (inactive) copy of this Testpoint on a different location.
+	 *
+	 * This is used to move a Testpoint onto a copy of its circuit.
+	 *
+	 * @param _location The location of the new Testpoint.
+	 * @return A new Testpoint of the same kind and value.
+	 */
+	virtual Testpoint<_nodeType, _lineType, _valueType>* clone(_lineType* _location) const = 0;
+
 	/*
 	 * Activate the Testpoint by modifying the circuit.
 	 *
@@ -99,6 +110,18 @@ public:
 	 */
 	virtual std::vector<Event<_valueType>> deactivate(Circuit* _circuit) = 0;
 
+	/*
+	 * Add the Testpoint to the COP values of its circuit without modifying the
+	 * circuit (nothing is created).
+	 *
+	 * The values are changed as if the Testpoint was activated once the COP
+	 * values are updated (see IncrementalCOP::update). Roll them back to
+	 * remove the Testpoint.
+	 *
+	 * @param _cop The COP values of the circuit the Testpoint is on.
+	 */
+	virtual void apply(IncrementalCOP<_valueType> & _cop) const = 0;
+
 	/*
 	 * The location of the TP.
 	 *
@@ -86,6 +86,16 @@ public:
 		return false;
 	};
 
+	/*
+	 * Create an (inactive) copy of this Testpoint on a different location.
+	 *
+	 * @param _location The location of the new Testpoint.
+	 * @return A new Testpoint_control.
+	 */
+	virtual Testpoint<_nodeType, _lineType, _valueType>* clone(_lineType* _location) const {
+		return new Testpoint_control<_nodeType, _lineType, _valueType>(_location, this->value());
+	}
+
 	/*
 	 * Activate the Testpoint by modifying the circuit.
 	 *
@@ -155,13 +165,23 @@ public:
 		_circuit->removeNode(this->newNode_);
 
 		delete this->newNode_->function(); //The function is unique to the node, so it must be deleted.
-		this->newNode_ = nullptr;
 		delete this->newNode_;
-		
+		this->newNode_ = nullptr;
+
 		return this->location_->go();
 
 	};
 
+	/*
+	 * Add the Testpoint to the COP values of its circuit: the location's
+	 * controllability is forced to the value (see Testpoint::apply).
+	 *
+	 * @param _cop The COP values of the circuit the Testpoint is on.
+	 */
+	virtual void apply(IncrementalCOP<_valueType> & _cop) const {
+		_cop.control(_cop.id(this->location_), this->value().magnitude());
+	}
+
 private:
 	/*
 	 * The object(s) which was/were previously connected to before this TP was activated.
@@ -175,7 +195,7 @@ private:
 	 *
 	 * Can be null.
 	 */
-	_lineType* newLine_;
+	_lineType* newLine_ = nullptr;
 
 	/*
 	 * The new node created to implement a constant value.
@@ -36,6 +36,16 @@ public:
 		this->newNode_ = nullptr;
 	}
 
+	/*
+	 * Create an (inactive) copy of this Testpoint on a different location.
+	 *
+	 * @param _location The location of the new Testpoint.
+	 * @return A new Testpoint_invert.
+	 */
+	virtual Testpoint<_nodeType, _lineType, _valueType>* clone(_lineType* _location) const {
+		return new Testpoint_invert<_nodeType, _lineType, _valueType>(_location);
+	}
+
 	/*
 	 * Activate the Testpoint by modifying the circuit.
 	 *
@@ -125,6 +135,16 @@ public:
 		return this->location_->go();
 	};
 
+	/*
+	 * Add the Testpoint to the COP values of its circuit: the location's
+	 * controllability is inverted (see Testpoint::apply).
+	 *
+	 * @param _cop The COP values of the circuit the Testpoint is on.
+	 */
+	virtual void apply(IncrementalCOP<_valueType> & _cop) const {
+		_cop.invert(_cop.id(this->location_));
+	}
+
 private:
 	/*
 	 * The object(s) which was/were previously connected to before this TP was activated.
@@ -138,12 +158,12 @@ private:
 	 *
 	 * Can be null.
 	 */
-	_lineType* newLine_;
+	_lineType* newLine_ = nullptr;
 
 	/*
 	 * The new node created to implement a constant value.
 	 */
-	_nodeType* newNode_;
+	_nodeType* newNode_ = nullptr;
 };
 
 #endif
@@ -37,6 +37,16 @@ public:
 		this->newNode_ = nullptr;
 	};
 
+	/*
+	 * Create an (inactive) copy of this Testpoint on a different location.
+	 *
+	 * @param _location The location of the new Testpoint.
+	 * @return A new Testpoint_observe.
+	 */
+	virtual Testpoint<_nodeType, _lineType, _valueType>* clone(_lineType* _location) const {
+		return new Testpoint_observe<_nodeType, _lineType, _valueType>(_location);
+	}
+
 	/*
 	 * Activate the Testpoint by modifying the circuit.
 	 *
@@ -77,6 +87,16 @@ public:
 		return std::vector<Event<_valueType>>(); //No new event should ever be returned: how can adding an O.P. change any value?
 	};
 
+	/*
+	 * Add the Testpoint to the COP values of its circuit: the location's
+	 * observability is 1 (see Testpoint::apply).
+	 *
+	 * @param _cop The COP values of the circuit the Testpoint is on.
+	 */
+	virtual void apply(IncrementalCOP<_valueType> & _cop) const {
+		_cop.observe(_cop.id(this->location_));
+	}
+
 private:
 	/*
 	 * The new node created to implement the observe point (the PO).
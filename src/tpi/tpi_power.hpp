@@ -14,22 +14,21 @@
 #define TPI_POWER_h
 #include<cmath>
 #include "tpi/TPI.hpp"
-#include "tpi/COP_fault_calculator.hpp"
-#include "trace/tracer.hpp"
+#include "tpi/COP_power_calculator.hpp"
 #include "cop/COPStructures.hpp"
 
  /*
-  * COP-based TPI.
+  * Power-aware COP-based TPI.
   *
-  * The TPI implemented by this TPI method is very similar to the method in the
-  * following article. The given article does some implied optimization after
-  * a TP is inserted by only calculating the change in fault coverage for
-  * "effected" faults, but otherwise, the resulting TPs selected should be the
-  * same.
+  * The "quality" of a testpoint is the change in the circuit's power metric
+  * (see COP_power_calculator): the sum, over all Lines, of how far each Line's
+  * controllability is from 0.5.
   *
-  * H.-C. Tsai, K.-T. Cheng, C.-J. Lin and S. Bhawmik. A hybrid algorithm for
-  * test point selection for scan-based BIST. Proc. of 34th Design Automation
-  * Conference, pages 478-483,1997.
+  * Testpoints are evaluated without modifying the circuit: they are added to
+  * COP values of the whole circuit which are updated incrementally (see
+  * IncrementalCOP) and then rolled back, and only the Lines whose values
+  * changed are re-measured. Chosen testpoints are added for good (see
+  * "inserted").
   *
   * NOTE: There is no "_primitive" parameter since COP can only be performed on
   *       Boolean circuits.
@@ -53,8 +52,6 @@ public:
 	 *        on TPI. By default, this will be the "maximum possible time".
 	 * @param (optinal) stuck_target If true, COP calculates the prob. SAFs
 	 *        are detected, else, TDFs.
-	 * @param (optional) _faults Specific faults to garget. Else, target
-	 *        all faults.
 	 */
 	TPI_POWER(
 		Circuit* _circuit,
@@ -62,126 +59,75 @@ public:
 		float _qualityLimit = 1.0,
 		size_t _timeLimit = std::numeric_limits<size_t>::max(),
 		bool stuck_target = true
-	
-		
 	) :
 		TPI< _nodeType, _lineType, _valueType>(
 			_circuit,
 			_TPLimit,
 			_qualityLimit,
 			_timeLimit)
-		
 	{
-		basepower = this->power_calculator( _circuit);
+		this->stored_ = false;
 	};
 
 	/*
 	 * Return the "quality" of this testpoint.
 	 *
-	 * For this TPI method, the "quality" is the change in fault coverage.
+	 * For this TPI method, the "quality" is the change in the power metric.
 	 *
 	 * @param _testpoint The testpoint to measure.
 	 * @param _circuit The circuit the TP is added to.
 	 * @return The quality of the testpoint.
 	 */
 	float quality(Testpoint< _nodeType, _lineType, _valueType>* _testpoint, Circuit* _circuit) {
-		//printf("\n%s\t", _testpoint->location()->name().c_str());
-	
-		//printf("%0.8f", base);
-		//COP_fault_calculator<_valueType>FaultCoverageCalculator1(_circuit,true, _faults);
-		//float baseFaultCoverage_ = this->FaultCoverageCalculator_.faultCoverage();
-	
-		//printf("%0.7f\t", base);
-			_testpoint->activate(_circuit);
-		
-			float TPpower = this->power_calculator( _circuit);
-			//printf("%0.7f\t",TPpower);
-			//float FaultCoverage = this->FaultCoverageCalculator_.faultCoverage();
-			//float toReturn = (TPpower / base)*10+ (FaultCoverage/ baseFaultCoverage_);
-			float toReturn = TPpower - basepower;
-			_testpoint->deactivate(_circuit);
-			return toReturn;
-			
-		
+		this->store();
+		size_t checkpoint = this->cop_.checkpoint();
+		_testpoint->apply(this->cop_);
+		this->cop_.update();
+		float TPpower = this->PowerCalculator_.power(this->cop_, checkpoint);
+		this->cop_.rollback(checkpoint);
+		return TPpower - this->PowerCalculator_.power();
 	};
 
-	
-
-private:
-
 	/*
-	 * Return the "quality" of this testpoint.
+	 * The power metric of the circuit with all chosen testpoints.
 	 *
-	 * For this TPI method, the "quality" is the change in fault coverage.
-	 *
-	 * @param _testpoint The testpoint to measure.
-	 * @param _circuit The circuit the TP is added to.
-	 * @return The quality of the testpoint.
+	 * @return The power metric.
 	 */
-	float power_calculator( Circuit* _circuit) {
-
-		//std::vector<Tracable*> forwards_set;
-		
-		
-		float TPpower=0.0;
-		//forwards_set = Tracer<_lineType, _nodeType>::forwards_all(dynamic_cast<Tracable*>(_testpoint->location()));	
-		//printf("name %s forward: %d \n", _testpoint->location()->name().c_str(), forwards_set.size());
-		std::unordered_set<_lineType*>all_lines;
-		_lineType* curline;
-		for (Connecting* node : _circuit->nodes())
-		{
-			if (node->outputs().size() != 0) {
-				for (Connecting* line : node->outputs())
-				{
-					curline = dynamic_cast<_lineType*>(line);
-					if (curline != nullptr)
-					{
-						all_lines.emplace(curline);
-
-					}
-				}
-			}
-
-			if (node->inputs().size() != 0) {
-				for (Connecting* line : node->inputs())
-				{
-					curline = dynamic_cast<_lineType*>(line);
-					if (curline != nullptr)
-					{
-						all_lines.emplace(curline);
-						
-					}
-				}
-			}
-		}
-		//printf(" %d\t", all_lines.size());
-		
-		for (_lineType* line: all_lines)
-
-		{
-			//printf("\n line name :%s",line->name().c_str());
-			COPLine<_valueType>* cast = dynamic_cast<COPLine<_valueType>*>(line);
-			if (cast != nullptr)
-			{
-				TPpower = TPpower + abs(cast->controllability() - 0.5);
-				//printf("\n%s\t  %0.8f\n", cast->name().c_str(), abs(cast->controllability() - 0.5));
-			}
-		}
-		
-		
-		return TPpower;
-		
+	float power() {
+		this->store();
+		return this->PowerCalculator_.power();
 	};
 
-
+private:
 	/*
-	 * The "base fault coverage". If not yet calculated, it will be negative.
+	 * Have the COP values of all objects been calculated (at once) and stored?
 	 */
-	float basepower;
+	bool stored_;
 
-	
+	/*
+	 * COP values of the whole circuit (with all chosen testpoints).
+	 */
+	IncrementalCOP<_valueType> cop_;
 
+	/*
+	 * The calculator used for calculating the power metric.
+	 */
+	COP_power_calculator<_valueType> PowerCalculator_;
 
+	/*
+	 * Calculate (once) the COP values of the whole circuit and the power
+	 * metric of every Line.
+	 */
+	void store() {
+		if (this->stored_) {
+			return;
+		}
+		this->cop_.build(this->circuit_);
+		this->cop_.calculate();
+		this->cop_.store();
+		this->PowerCalculator_.index(this->cop_);
+		this->stored_ = true;
+	};
 
 	/*
 	 * Return the "base" quality (no extra TP fault coverage) to compare other
@@ -209,8 +155,22 @@ private:
 		return _base;
 	};
 
-
-
+	/*
+	 * A testpoint was chosen (and activated): add it to the COP values of the
+	 * whole circuit for good.
+	 *
+	 * @param _testpoint The chosen testpoint.
+	 */
+	virtual void inserted(Testpoint<_nodeType, _lineType, _valueType>* _testpoint) {
+		if (this->stored_ == false) {
+			return;
+		}
+		size_t checkpoint = this->cop_.checkpoint();
+		_testpoint->apply(this->cop_);
+		this->cop_.update();
+		this->PowerCalculator_.accumulate(this->cop_, checkpoint);
+		this->cop_.commit();
+	};
 };
 
-#endif
\ No newline at end of file
+#endif